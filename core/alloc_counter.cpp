@@ -0,0 +1,87 @@
+#include "alloc_counter.h"
+
+#ifdef STROKEX_ALLOC_TRACKING
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+static thread_local long long threadAllocations = 0;
+
+static void* Allocate(std::size_t size) {
+    threadAllocations++;
+    return std::malloc(size > 0 ? size : 1);
+}
+
+// aligned_alloc wants the size rounded up to the alignment
+static void* AllocateAligned(std::size_t size, std::align_val_t align) {
+    threadAllocations++;
+    std::size_t alignment = (std::size_t)align;
+    return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+}
+
+void* operator new(std::size_t size) {
+    void* p = Allocate(size);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return Allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return Allocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t align) {
+    void* p = AllocateAligned(size, align);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](std::size_t size, std::align_val_t align) {
+    return operator new(size, align);
+}
+
+void* operator new(std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+    return AllocateAligned(size, align);
+}
+
+void* operator new[](std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+    return AllocateAligned(size, align);
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { std::free(p); }
+
+long long AllocCounter::ThreadAllocations() {
+    return threadAllocations;
+}
+
+void AllocCounter::ExpectNone(long long allocations, const char* where) {
+    if (allocations == 0) return;
+    fprintf(stderr, "%s: %lld heap allocations during play\n", where, allocations);
+    abort();
+}
+#else
+long long AllocCounter::ThreadAllocations() {
+    return 0;
+}
+
+void AllocCounter::ExpectNone(long long, const char*) {
+}
+#endif
@@ -0,0 +1,38 @@
+#pragma once
+
+// Heap allocation counting, for keeping the frame loop off the heap. With
+// STROKEX_ALLOC_TRACKING defined (cmake -DSTROKEX_ALLOC_TRACKING=ON, on by
+// default in Debug builds) the global operator new is replaced by one that
+// counts each thread's allocations before allocating as usual. Without it
+// nothing is replaced and every count stays 0.
+class AllocCounter {
+public:
+#ifdef STROKEX_ALLOC_TRACKING
+    static constexpr bool kEnabled = true;
+#else
+    static constexpr bool kEnabled = false;
+#endif
+
+    // Allocations made by the calling thread since it started
+    static long long ThreadAllocations();
+
+    // With tracking, stop the program if a frame that should have stayed
+    // off the heap made `allocations`; `where` names the frame step
+    static void ExpectNone(long long allocations, const char* where);
+};
+
+// Frames played on one level from start to finish, and how many of them
+// still allocated. A loaded level has everything it needs for play, so
+// the target is none.
+struct FrameAllocStats {
+    long long steadyFrames = 0;
+    long long allocatingFrames = 0;
+    long long allocations = 0;
+
+    void AddFrame(long long frameAllocations) {
+        steadyFrames++;
+        if (frameAllocations == 0) return;
+        allocatingFrames++;
+        allocations += frameAllocations;
+    }
+};
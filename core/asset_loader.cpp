@@ -0,0 +1,80 @@
+#include "asset_loader.h"
+
+#include <chrono>
+#include <cstdio>
+
+using namespace std;
+
+static double NowMs() {
+    return chrono::duration<double, milli>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+AssetLoader::AssetLoader() {
+    worker = thread(&AssetLoader::WorkerLoop, this);
+}
+
+AssetLoader::~AssetLoader() {
+    Shutdown();
+}
+
+void AssetLoader::Shutdown() {
+    {
+        lock_guard<mutex> lock(queueMutex);
+        stopping = true;
+        queue.clear();
+    }
+    wake.notify_all();
+    if (worker.joinable()) worker.join();
+}
+
+string AssetLoader::Resolve(const string& path) const {
+    bool absolute = !path.empty() && (path[0] == '/' || path[0] == '\\' || (path.size() > 1 && path[1] == ':'));
+    if (absolute || root.empty()) return path;
+    char last = root[root.size() - 1];
+    return (last == '/' || last == '\\') ? root + path : root + "/" + path;
+}
+
+bool AssetLoader::FileExists(const string& path) {
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file) return false;
+    fclose(file);
+    return true;
+}
+
+int AssetLoader::Submit(const string& name, function<bool()> run) {
+    unique_ptr<Job> job(new Job());
+    job->name = name;
+    job->run = move(run);
+    job->submitTime = NowMs();
+    int id = (int)jobs.size();
+    {
+        lock_guard<mutex> lock(queueMutex);
+        // After Shutdown nothing runs; the job just stays pending
+        if (!stopping) queue.push_back(job.get());
+    }
+    jobs.push_back(move(job));
+    wake.notify_one();
+    return id;
+}
+
+AssetState AssetLoader::State(int id) const {
+    if (id < 0 || id >= (int)jobs.size()) return ASSET_MISSING;
+    return (AssetState)jobs[id]->state.load(memory_order_acquire);
+}
+
+void AssetLoader::WorkerLoop() {
+    while (true) {
+        Job* job;
+        {
+            unique_lock<mutex> lock(queueMutex);
+            wake.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (stopping) return;
+            job = queue.front();
+            queue.pop_front();
+        }
+        bool found = job->run();
+        job->loadMs = NowMs() - job->submitTime;
+        // Release: whatever the job wrote is visible once the state is
+        job->state.store(found ? ASSET_READY : ASSET_MISSING, memory_order_release);
+    }
+}
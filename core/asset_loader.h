@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum AssetState {
+    ASSET_PENDING,
+    ASSET_READY,
+    ASSET_MISSING
+};
+
+// Runs load jobs on one background thread, in the order they were queued,
+// so the first frame never waits on the disk. A job does whatever is safe
+// off the main thread and returns false if the asset isn't there; the main
+// thread polls State() once a frame and finishes the rest (GPU uploads,
+// handing a pack to the core). One thread, because loading is mostly
+// waiting on files and later jobs may rely on earlier ones.
+class AssetLoader {
+public:
+    AssetLoader();
+    ~AssetLoader();
+
+    AssetLoader(const AssetLoader&) = delete;
+    AssetLoader& operator=(const AssetLoader&) = delete;
+
+    // Directory that relative paths are resolved against; empty for the
+    // working directory
+    void SetRoot(const std::string& dir) { root = dir; }
+    std::string Resolve(const std::string& path) const;
+    static bool FileExists(const std::string& path);
+
+    // Queue a job; returns its id. Call from one thread only.
+    int Submit(const std::string& name, std::function<bool()> job);
+    AssetState State(int id) const;
+    const std::string& Name(int id) const { return jobs[id]->name; }
+    // From Submit until the job finished, in ms
+    double LoadMs(int id) const { return jobs[id]->loadMs; }
+
+    // Finish the job in progress, drop the rest and stop the thread. Jobs
+    // that never ran stay pending.
+    void Shutdown();
+
+private:
+    struct Job {
+        std::string name;
+        std::function<bool()> run;
+        std::atomic<int> state{ASSET_PENDING};
+        double submitTime = 0.0;
+        double loadMs = 0.0;
+    };
+
+    void WorkerLoop();
+
+    std::string root;
+    std::vector<std::unique_ptr<Job>> jobs;
+
+    std::mutex queueMutex;
+    std::condition_variable wake;
+    std::deque<Job*> queue;   // guarded by queueMutex
+    bool stopping = false;    // guarded by queueMutex
+    std::thread worker;
+};
@@ -0,0 +1,150 @@
+#include "autoplay_input.h"
+
+using namespace std;
+
+static Vec2 RectCenter(Rect rect) {
+    return {rect.x + rect.width * 0.5f, rect.y + rect.height * 0.5f};
+}
+
+AutoplayInput::AutoplayInput(const PuzzleCore& core, unsigned int seed)
+    : core(core), rng(seed) {
+    strokeIndex = 0;
+    segmentTick = 0;
+    ticksPerSegment = 6;
+    ticksPerFrame = 1;
+    buttonHeld = false;
+    cursor = {0, 0};
+}
+
+// 2.5 edges a frame in 20 readings: far too fast for one reading a frame
+// to land on every node
+void AutoplayInput::SetFlick(bool flick) {
+    ticksPerSegment = flick ? 8 : 6;
+    ticksPerFrame = flick ? 20 : 1;
+}
+
+// Press on one frame, release on the next
+FrameInput AutoplayInput::Click(Vec2 pos) {
+    FrameInput input = {};
+    input.mousePos = pos;
+    cursor = pos;
+    if (buttonHeld) {
+        input.mouseReleased = true;
+        buttonHeld = false;
+    } else {
+        input.mouseDown = true;
+        input.mousePressed = true;
+        buttonHeld = true;
+    }
+    return input;
+}
+
+// Either the solver's full trail or a random walk over edges, never reusing
+// one, starting at an odd node when the level has any
+void AutoplayInput::PlanStroke() {
+    const vector<Node>& nodes = core.GetNodes();
+    const vector<Edge>& edges = core.GetEdges();
+    // The cursor moves on screen; the bot leaves the camera where it is
+    const ViewCamera& view = core.GetView();
+    stroke.clear();
+    strokeIndex = 0;
+    segmentTick = 0;
+    if (nodes.empty() || edges.empty()) return;
+
+    if (uniform_int_distribution<int>(0, 3)(rng) != 0) {
+        solver.SolveFromPath(core.GetGraph(), vector<int>(), solution);
+        if (solution.status == SOLVE_OK) {
+            for (int node : solution.nodes) {
+                stroke.push_back(view.WorldToScreen(nodes[node].position));
+            }
+            return;
+        }
+    }
+
+    int current = core.GetFirstOddDegreeNode();
+    if (core.CountOddDegreeNodes() == 0) {
+        current = uniform_int_distribution<int>(0, (int)nodes.size() - 1)(rng);
+    }
+
+    const GraphIndex& graph = core.GetGraph();
+    vector<bool> used(edges.size(), false);
+    vector<int> candidates;
+    stroke.push_back(view.WorldToScreen(nodes[current].position));
+
+    while (true) {
+        candidates.clear();
+        for (const HalfEdge* he = graph.NeighborsBegin(current); he != graph.NeighborsEnd(current); ++he) {
+            if (!used[he->edge]) candidates.push_back(he->edge);
+        }
+        if (candidates.empty()) break;
+
+        int pick = candidates[uniform_int_distribution<int>(0, (int)candidates.size() - 1)(rng)];
+        used[pick] = true;
+        current = graph.OtherNode(pick, current);
+        stroke.push_back(view.WorldToScreen(nodes[current].position));
+    }
+}
+
+FrameInput AutoplayInput::Poll() {
+    if (core.GetGameState() == START_SCREEN) {
+        return Click(RectCenter(core.GetStartButton()));
+    }
+
+    if (core.IsHintPopupVisible()) {
+        return Click(cursor);
+    }
+
+    if (core.IsLevelComplete()) {
+        // Walk forward through the levels, stepping back from the last one
+        // so a long soak keeps cycling
+        if (core.GetCurrentLevel() < core.GetMaxUnlockedLevel()) {
+            return Click(RectCenter(core.GetNextLevelButton()));
+        }
+        return Click(RectCenter(core.GetPrevLevelButton()));
+    }
+
+    if (!buttonHeld) {
+        PlanStroke();
+        if (stroke.empty()) return Click(RectCenter(core.GetResetButton()));
+        FrameInput input = {};
+        input.mousePos = stroke[0];
+        input.mouseDown = true;
+        input.mousePressed = true;
+        cursor = stroke[0];
+        strokeIndex = 1;
+        buttonHeld = true;
+        return input;
+    }
+
+    if (strokeIndex >= stroke.size()) {
+        buttonHeld = false;
+        FrameInput input = {};
+        input.mousePos = cursor;
+        input.mouseReleased = true;
+        return input;
+    }
+
+    // Glide towards the next waypoint, possibly past several
+    samples.clear();
+    for (int tick = 0; tick < ticksPerFrame && strokeIndex < stroke.size(); tick++) {
+        Vec2 from = stroke[strokeIndex - 1];
+        Vec2 to = stroke[strokeIndex];
+        segmentTick++;
+        float t = (float)segmentTick / (float)ticksPerSegment;
+        cursor = {from.x + (to.x - from.x) * t, from.y + (to.y - from.y) * t};
+        if (segmentTick >= ticksPerSegment) {
+            segmentTick = 0;
+            strokeIndex++;
+        }
+        samples.push_back({-1.0, cursor, true});
+    }
+
+    FrameInput input = {};
+    input.mousePos = cursor;
+    input.mouseDown = true;
+    if (ticksPerFrame > 1) {
+        input.samples = samples.data();
+        input.sampleCount = (int)samples.size();
+    }
+    return input;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "euler_solver.h"
+#include "platform.h"
+#include "puzzle_core.h"
+
+#include <random>
+#include <vector>
+
+// Scripted player for headless runs. Watches the core's public state and
+// produces mouse input that clicks through the menus and traces random walks
+// over the current level, so every gameplay path gets exercised without a
+// human at the mouse. Most strokes follow the solver's trail; the rest are
+// random walks so failed attempts get exercised too.
+class AutoplayInput : public InputSource {
+public:
+    AutoplayInput(const PuzzleCore& core, unsigned int seed);
+
+    FrameInput Poll() override;
+
+    // Swipe strokes several edges per frame and report the cursor as a
+    // trail of sub-frame readings, the way a high-rate input path would
+    void SetFlick(bool flick);
+
+private:
+    void PlanStroke();
+    FrameInput Click(Vec2 pos);
+
+    const PuzzleCore& core;
+    std::mt19937 rng;
+    EulerSolver solver;
+    SolveResult solution;
+
+    std::vector<Vec2> stroke;   // node positions to visit, in order
+    size_t strokeIndex;         // waypoint the cursor is heading to
+    int segmentTick;            // ticks spent on the current segment
+    int ticksPerSegment;
+    int ticksPerFrame;          // more than one: each tick is a sub-frame reading
+    bool buttonHeld;
+    Vec2 cursor;
+    std::vector<InputSample> samples;
+};
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Runtime-sized bitset over 64-bit words. Used for per-edge state where a
+// vector<bool> would hide the word layout we want to copy and hash.
+class DynamicBitset {
+public:
+    void Resize(size_t bitCount) {
+        bits = bitCount;
+        words.assign((bitCount + 63) / 64, 0);
+    }
+
+    void ClearAll() {
+        for (auto& word : words) word = 0;
+    }
+
+    size_t Size() const { return bits; }
+    bool Test(size_t i) const { return (words[i >> 6] >> (i & 63)) & 1; }
+    void Set(size_t i) { words[i >> 6] |= (uint64_t)1 << (i & 63); }
+    void Reset(size_t i) { words[i >> 6] &= ~((uint64_t)1 << (i & 63)); }
+
+    size_t Count() const {
+        size_t count = 0;
+        for (uint64_t word : words) count += (size_t)__builtin_popcountll(word);
+        return count;
+    }
+
+    const std::vector<uint64_t>& Words() const { return words; }
+
+private:
+    std::vector<uint64_t> words;
+    size_t bits = 0;
+};
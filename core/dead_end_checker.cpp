@@ -0,0 +1,195 @@
+#include "dead_end_checker.h"
+
+using namespace std;
+
+void DeadEndChecker::Reserve(const GraphIndex& g) {
+    traced.Resize(g.EdgeCount());
+    remainingDegree.reserve(g.NodeCount());
+    stamp.reserve(g.NodeCount());
+    // A node joins a search queue at most once per search
+    queueA.reserve(g.NodeCount());
+    queueB.reserve(g.NodeCount());
+    pending.reserve(g.EdgeCount());
+}
+
+SolveStatus DeadEndChecker::Reset(const GraphIndex& g, int startNode) {
+    graph = &g;
+    int nodeCount = g.NodeCount();
+    int edgeCount = g.EdgeCount();
+
+    traced.Resize(edgeCount);
+    remainingDegree.resize(nodeCount);
+    oddNodes = 0;
+    for (int n = 0; n < nodeCount; n++) {
+        remainingDegree[n] = g.Degree(n);
+        if (remainingDegree[n] % 2 == 1) oddNodes++;
+    }
+    remainingEdges = edgeCount;
+    stamp.assign(nodeCount, 0);
+    epoch = 0;
+    lastSearchCost = 0;
+    current = startNode;
+    ClearSearches();
+
+    if (edgeCount == 0) {
+        status = SOLVE_ALREADY_COMPLETE;
+    } else if (oddNodes > 2) {
+        status = SOLVE_TOO_MANY_ODD;
+    } else if (oddNodes == 2 && remainingDegree[startNode] % 2 == 0) {
+        status = SOLVE_WRONG_START;
+    } else {
+        // Once per stroke: every edge must be reachable from the start.
+        // Count reached half edges with a plain BFS.
+        epoch = 1;
+        queueA.clear();
+        queueA.push_back(startNode);
+        stamp[startNode] = epoch * 2;
+        long long halfEdges = 0;
+        for (size_t head = 0; head < queueA.size(); head++) {
+            int node = queueA[head];
+            halfEdges += g.Degree(node);
+            for (const HalfEdge* he = g.NeighborsBegin(node); he != g.NeighborsEnd(node); ++he) {
+                if (stamp[he->node] == epoch * 2) continue;
+                stamp[he->node] = epoch * 2;
+                queueA.push_back(he->node);
+            }
+        }
+        status = halfEdges == (long long)edgeCount * 2 ? SOLVE_OK : SOLVE_DISCONNECTED;
+    }
+    return status;
+}
+
+SolveStatus DeadEndChecker::Step(int edge, int from, int to) {
+    lastSearchCost = 0;
+    if (IsStuck() || !graph) return status;
+    if (traced.Test(edge)) {
+        status = SOLVE_EDGE_REUSED;
+        ClearSearches();
+        return status;
+    }
+
+    traced.Set(edge);
+    current = to;
+    remainingEdges--;
+    remainingDegree[from]--;
+    oddNodes += (remainingDegree[from] % 2 == 1) ? 1 : -1;
+    remainingDegree[to]--;
+    oddNodes += (remainingDegree[to] % 2 == 1) ? 1 : -1;
+
+    if (remainingEdges == 0) {
+        status = SOLVE_ALREADY_COMPLETE;
+        ClearSearches();
+    } else if (remainingDegree[to] == 0) {
+        status = SOLVE_DISCONNECTED;
+        ClearSearches();
+    } else if (oddNodes > 2) {
+        // Can't follow from a passing state; kept so a bad Reset can't
+        // turn into a wrong verdict later
+        status = SOLVE_TOO_MANY_ODD;
+    } else if (oddNodes == 2 && remainingDegree[to] % 2 == 0) {
+        status = SOLVE_WRONG_START;
+    } else if (remainingDegree[from] > 0 && from != to) {
+        pending.push_back({from, to});
+        RunSearches();
+    }
+    return status;
+}
+
+SolveStatus DeadEndChecker::Poll() {
+    lastSearchCost = 0;
+    if (!IsStuck() && graph) RunSearches();
+    return status;
+}
+
+void DeadEndChecker::ClearSearches() {
+    pending.clear();
+    pendingHead = 0;
+    searching = false;
+}
+
+// Work through queued checks, oldest first, within one budget
+void DeadEndChecker::RunSearches() {
+    int budget = kSearchBudget;
+    while (budget > 0) {
+        if (!searching) {
+            if (pendingHead == pending.size()) {
+                pending.clear();
+                pendingHead = 0;
+                return;
+            }
+            StartSearch(pending[pendingHead++]);
+        }
+
+        int result = ContinueSearch(budget);
+        if (result < 0) return;
+        searching = false;
+        if (result == 0 && DrySideStrandsEdges()) {
+            status = SOLVE_DISCONNECTED;
+            ClearSearches();
+            return;
+        }
+    }
+}
+
+// The side that ran dry is closed under the untraced edges, so it is a set
+// of whole components. The stroke is stuck if untraced edges are left on
+// the far side of that boundary from the current node. When the search
+// finished within its step that is always the case; after a carry-over the
+// stroke may have crossed before the crossing edges were scanned.
+bool DeadEndChecker::DrySideStrandsEdges() const {
+    bool dryA = headA == queueA.size();
+    const vector<int>& dry = dryA ? queueA : queueB;
+    unsigned int mark = dryA ? epoch * 2 : epoch * 2 + 1;
+
+    long long halfEdges = 0;
+    for (int node : dry) halfEdges += remainingDegree[node];
+    if (stamp[current] == mark) return halfEdges / 2 < remainingEdges;
+    return halfEdges > 0;
+}
+
+void DeadEndChecker::StartSearch(const Check& check) {
+    epoch++;
+    if (epoch >= 0x7FFFFFFF) {
+        stamp.assign(stamp.size(), 0);
+        epoch = 1;
+    }
+    queueA.clear();
+    queueB.clear();
+    queueA.push_back(check.u);
+    queueB.push_back(check.v);
+    stamp[check.u] = epoch * 2;
+    stamp[check.v] = epoch * 2 + 1;
+    headA = 0;
+    headB = 0;
+    searching = true;
+}
+
+int DeadEndChecker::ContinueSearch(int& budget) {
+    unsigned int markA = epoch * 2;
+    unsigned int markB = epoch * 2 + 1;
+
+    while (headA < queueA.size() && headB < queueB.size()) {
+        if (budget <= 0) return -1;
+
+        // Grow the side that has found less so far: on a cut, the small
+        // side runs out first and the search never sees the big one
+        bool growA = queueA.size() <= queueB.size();
+        vector<int>& queue = growA ? queueA : queueB;
+        size_t& head = growA ? headA : headB;
+        unsigned int mine = growA ? markA : markB;
+        unsigned int theirs = growA ? markB : markA;
+
+        int node = queue[head++];
+        budget--;
+        lastSearchCost++;
+        for (const HalfEdge* he = graph->NeighborsBegin(node); he != graph->NeighborsEnd(node); ++he) {
+            if (traced.Test(he->edge)) continue;
+            unsigned int mark = stamp[he->node];
+            if (mark == theirs) return 1;
+            if (mark == mine) continue;
+            stamp[he->node] = mine;
+            queue.push_back(he->node);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "bitset.h"
+#include "euler_solver.h"
+#include "graph_index.h"
+
+#include <vector>
+
+// Incremental "is this stroke still finishable?" check, run after every
+// traced edge. The untraced edges admit a trail from the current node iff
+// they are connected to it and have 0 odd nodes, or 2 with the current node
+// one of them.
+//
+// Parity is tracked with a counter. Once a state passes, tracing an edge
+// keeps the parity valid, so after the start only connectivity can break,
+// and only when the traced edge (u, v) was a bridge of the untraced graph
+// with edges left on u's side. That is settled by a bidirectional search
+// from u and v over untraced edges that grows whichever side is smaller and
+// stops as soon as they meet: on a cut it costs the smaller side, otherwise
+// the shortest way round. Visit marks are epoch stamps, so nothing is
+// cleared between steps.
+//
+// The way round can be long on big boards, so each call spends at most
+// kSearchBudget node visits and leaves the rest for the next Step or Poll.
+// That's sound because edges only ever get traced: a meeting found later
+// was also a path at the time of the step, and a side that runs dry later
+// is a set of whole components of the untraced graph as it is now, which
+// is all it takes to judge the stroke where it stands.
+class DeadEndChecker {
+public:
+    static constexpr int kSearchBudget = 2048;
+
+    // Start a stroke at `startNode` on a fresh copy of the level
+    SolveStatus Reset(const GraphIndex& graph, int startNode);
+    // Size everything for strokes on `graph` ahead of the first Reset, so
+    // neither Reset nor Step allocates
+    void Reserve(const GraphIndex& graph);
+
+    // The stroke traced `edge` from `from` to `to`. Returns the verdict for
+    // the new state; once stuck it stays stuck until the next Reset.
+    SolveStatus Step(int edge, int from, int to);
+
+    // Carry on with searches left over from earlier steps; call once a frame
+    SolveStatus Poll();
+
+    SolveStatus Status() const { return status; }
+    bool IsStuck() const { return status != SOLVE_OK && status != SOLVE_ALREADY_COMPLETE; }
+    // True while a verdict is still being worked out; reads as not stuck
+    bool IsPending() const { return searching || pendingHead < pending.size(); }
+
+    // Nodes visited by the last Step or Poll, for profiling
+    int LastSearchCost() const { return lastSearchCost; }
+
+private:
+    struct Check {
+        int u;
+        int v;
+    };
+
+    void RunSearches();
+    void StartSearch(const Check& check);
+    // 1 the sides met, 0 one side ran dry, -1 out of budget
+    int ContinueSearch(int& budget);
+    bool DrySideStrandsEdges() const;
+    void ClearSearches();
+
+    const GraphIndex* graph = nullptr;
+    DynamicBitset traced;
+    std::vector<int> remainingDegree;
+    int remainingEdges = 0;
+    int oddNodes = 0;
+    int current = -1;
+    SolveStatus status = SOLVE_NO_EDGES;
+
+    std::vector<Check> pending;
+    size_t pendingHead = 0;
+    bool searching = false;
+
+    std::vector<unsigned int> stamp;   // epoch * 2 (side A) or epoch * 2 + 1 (side B)
+    unsigned int epoch = 0;
+    std::vector<int> queueA;
+    std::vector<int> queueB;
+    size_t headA = 0;
+    size_t headB = 0;
+    int lastSearchCost = 0;
+};
@@ -0,0 +1,231 @@
+#include "dot_field.h"
+
+#include "profiler.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define STROKEX_DOTS_SSE2 1
+#endif
+
+using namespace std;
+
+static const Rgba DOT_COLORS[4] = {
+    {255, 0, 255, 180},
+    {0, 255, 255, 180},
+    {138, 43, 226, 180},
+    {0, 255, 127, 180}
+};
+
+// The original 100 dots on a 1880x1060 screen; denser fields scale down from it
+static const float kReferenceDensity = 100.0f / (1880.0f * 1060.0f);
+// Neighbours a dot has within the link distance, on average
+static const float kLinksPerDot = 3.0f;
+
+void DotField::Reset(int dotCount, Rect area, uint64_t seed) {
+    count = max(dotCount, 0);
+    bounds = area;
+    rng.Seed(seed);
+
+    int padded = (count + 3) & ~3;
+    posX.assign(padded, 0.0f);
+    posY.assign(padded, 0.0f);
+    prevX.assign(padded, 0.0f);
+    prevY.assign(padded, 0.0f);
+    velX.assign(padded, 0.0f);
+    velY.assign(padded, 0.0f);
+    size.assign(padded, 0.0f);
+    color.assign(padded, DOT_COLORS[0]);
+    links.clear();
+    linkDistance = 0.0f;
+    linkedCount = 0;
+
+    float density = count / max(bounds.width * bounds.height, 1.0f);
+    float scale = density > kReferenceDensity ? max(sqrtf(kReferenceDensity / density), 0.25f) : 1.0f;
+
+    for (int i = 0; i < count; i++) {
+        posX[i] = prevX[i] = bounds.x + rng.Float01() * bounds.width;
+        posY[i] = prevY[i] = bounds.y + rng.Float01() * bounds.height;
+        // 0.5 to 1.4 pixels per 60 Hz frame, as the dots were first tuned
+        float speed = (0.5f + (float)(i % 10) * 0.1f) * 60.0f;
+        float angle = rng.Float01() * 6.2831853f;
+        velX[i] = cosf(angle) * speed;
+        velY[i] = sinf(angle) * speed;
+        size[i] = (4.0f + (float)(i % 5)) * scale;
+        color[i] = DOT_COLORS[i % 4];
+    }
+}
+
+void DotField::Step(float deltaTime, ThreadPool& pool) {
+    PROFILE_ZONE("DotField::Step");
+    int padded = (count + 3) & ~3;
+    int grain = count < kParallelThreshold ? padded : kChunk;
+    pool.ParallelFor(padded, grain, [this, deltaTime](int begin, int end) {
+        StepRange(begin, end, deltaTime);
+    });
+}
+
+// Integrate, then bounce: a dot past an edge is put back on it and its
+// velocity turned to point inwards. begin is a multiple of 4.
+void DotField::StepRange(int begin, int end, float deltaTime) {
+    float minX = bounds.x;
+    float maxX = bounds.x + bounds.width;
+    float minY = bounds.y;
+    float maxY = bounds.y + bounds.height;
+    int i = begin;
+
+#ifdef STROKEX_DOTS_SSE2
+    __m128 dt = _mm_set1_ps(deltaTime);
+    __m128 sign = _mm_set1_ps(-0.0f);
+    __m128 loX = _mm_set1_ps(minX);
+    __m128 hiX = _mm_set1_ps(maxX);
+    __m128 loY = _mm_set1_ps(minY);
+    __m128 hiY = _mm_set1_ps(maxY);
+    auto bounce = [sign](__m128& pos, __m128& vel, __m128 lo, __m128 hi) {
+        __m128 below = _mm_cmplt_ps(pos, lo);
+        __m128 above = _mm_cmpgt_ps(pos, hi);
+        __m128 speed = _mm_andnot_ps(sign, vel);
+        vel = _mm_or_ps(_mm_and_ps(below, speed), _mm_andnot_ps(below, vel));
+        vel = _mm_or_ps(_mm_and_ps(above, _mm_or_ps(speed, sign)), _mm_andnot_ps(above, vel));
+        pos = _mm_min_ps(_mm_max_ps(pos, lo), hi);
+    };
+    for (; i + 4 <= end; i += 4) {
+        __m128 px = _mm_loadu_ps(&posX[i]);
+        __m128 py = _mm_loadu_ps(&posY[i]);
+        __m128 vx = _mm_loadu_ps(&velX[i]);
+        __m128 vy = _mm_loadu_ps(&velY[i]);
+        _mm_storeu_ps(&prevX[i], px);
+        _mm_storeu_ps(&prevY[i], py);
+        px = _mm_add_ps(px, _mm_mul_ps(vx, dt));
+        py = _mm_add_ps(py, _mm_mul_ps(vy, dt));
+        bounce(px, vx, loX, hiX);
+        bounce(py, vy, loY, hiY);
+        _mm_storeu_ps(&posX[i], px);
+        _mm_storeu_ps(&posY[i], py);
+        _mm_storeu_ps(&velX[i], vx);
+        _mm_storeu_ps(&velY[i], vy);
+    }
+#endif
+
+    for (; i < end; i++) {
+        prevX[i] = posX[i];
+        prevY[i] = posY[i];
+        posX[i] += velX[i] * deltaTime;
+        posY[i] += velY[i] * deltaTime;
+        if (posX[i] < minX) velX[i] = fabsf(velX[i]);
+        if (posX[i] > maxX) velX[i] = -fabsf(velX[i]);
+        if (posY[i] < minY) velY[i] = fabsf(velY[i]);
+        if (posY[i] > maxY) velY[i] = -fabsf(velY[i]);
+        posX[i] = min(max(posX[i], minX), maxX);
+        posY[i] = min(max(posY[i], minY), maxY);
+    }
+}
+
+// Counting sort of the first `dots` dots into cells one link distance wide
+void DotField::BuildGrid(int dots) {
+    cellSize = max(linkDistance, 1.0f);
+    size_t maxCells = max<size_t>(1024, (size_t)dots * 2);
+    while (true) {
+        cols = max(1, (int)ceilf(bounds.width / cellSize));
+        rows = max(1, (int)ceilf(bounds.height / cellSize));
+        if ((size_t)cols * (size_t)rows <= maxCells) break;
+        cellSize *= 2.0f;
+    }
+
+    cellStart.assign((size_t)cols * rows + 1, 0);
+    dotCell.resize(dots);
+    for (int i = 0; i < dots; i++) {
+        int cx = min(max((int)((posX[i] - bounds.x) / cellSize), 0), cols - 1);
+        int cy = min(max((int)((posY[i] - bounds.y) / cellSize), 0), rows - 1);
+        dotCell[i] = cy * cols + cx;
+        cellStart[dotCell[i] + 1]++;
+    }
+    for (size_t c = 1; c < cellStart.size(); c++) {
+        cellStart[c] += cellStart[c - 1];
+    }
+
+    cellX.resize(dots);
+    cellY.resize(dots);
+    cellDot.resize(dots);
+    cellCursor.assign(cellStart.begin(), cellStart.end() - 1);
+    for (int i = 0; i < dots; i++) {
+        int slot = cellCursor[dotCell[i]]++;
+        cellX[slot] = posX[i];
+        cellY[slot] = posY[i];
+        cellDot[slot] = i;
+    }
+}
+
+void DotField::FindLinks(int maxLinks, ThreadPool& pool) {
+    PROFILE_ZONE("DotField::FindLinks");
+    links.clear();
+    // Each dot is in about kLinksPerDot / 2 of the pairs
+    linkedCount = min(count, (int)(maxLinks / (kLinksPerDot * 0.5f)));
+    if (linkedCount < 2) {
+        linkedCount = 0;
+        return;
+    }
+    float areaSize = max(bounds.width * bounds.height, 1.0f);
+    linkDistance = sqrtf(kLinksPerDot * areaSize / (3.14159265f * linkedCount));
+    BuildGrid(linkedCount);
+
+    // Chunk boundaries depend only on the grid, so the links come out in
+    // the same order however many threads there are
+    int chunkRows = linkedCount < kParallelThreshold ? rows : max(1, rows / 64);
+    int chunks = (rows + chunkRows - 1) / chunkRows;
+    chunkLinks.resize(chunks);
+    pool.ParallelFor(chunks, 1, [this, chunkRows, maxLinks](int begin, int end) {
+        for (int c = begin; c < end; c++) {
+            chunkLinks[c].clear();
+            LinkRows(c * chunkRows, min(rows, (c + 1) * chunkRows), maxLinks, chunkLinks[c]);
+        }
+    });
+
+    for (int c = 0; c < chunks && (int)links.size() < maxLinks; c++) {
+        size_t take = min(chunkLinks[c].size(), (size_t)maxLinks - links.size());
+        links.insert(links.end(), chunkLinks[c].begin(), chunkLinks[c].begin() + take);
+    }
+}
+
+// Each pair is seen once: a dot checks the rest of its own cell and the
+// next cell along (one run of slots), then the three cells below it (the
+// cells of a row are stored back to back, so that is one run too)
+void DotField::LinkRows(int rowBegin, int rowEnd, int maxLinks, vector<DotLink>& out) const {
+    float limit = linkDistance * linkDistance;
+    float invDistance = 1.0f / linkDistance;
+
+    for (int cy = rowBegin; cy < rowEnd; cy++) {
+        for (int cx = 0; cx < cols; cx++) {
+            int cell = cy * cols + cx;
+            int end = cellStart[cell + 1];
+            int aheadEnd = cellStart[cx + 1 < cols ? cell + 2 : cell + 1];
+            int belowBegin = 0;
+            int belowEnd = 0;
+            if (cy + 1 < rows) {
+                int below = cell + cols;
+                belowBegin = cellStart[cx > 0 ? below - 1 : below];
+                belowEnd = cellStart[cx + 1 < cols ? below + 2 : below + 1];
+            }
+
+            for (int i = cellStart[cell]; i < end; i++) {
+                float x = cellX[i];
+                float y = cellY[i];
+                for (int j = i + 1; j < aheadEnd; j++) {
+                    float dx = cellX[j] - x;
+                    float dy = cellY[j] - y;
+                    float d2 = dx * dx + dy * dy;
+                    if (d2 < limit) out.push_back({cellDot[i], cellDot[j], 1.0f - sqrtf(d2) * invDistance});
+                }
+                for (int j = belowBegin; j < belowEnd; j++) {
+                    float dx = cellX[j] - x;
+                    float dy = cellY[j] - y;
+                    float d2 = dx * dx + dy * dy;
+                    if (d2 < limit) out.push_back({cellDot[i], cellDot[j], 1.0f - sqrtf(d2) * invDistance});
+                }
+            }
+            if ((int)out.size() >= maxLinks) return;
+        }
+    }
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "rng.h"
+#include "thread_pool.h"
+#include "types.h"
+
+#include <cstdint>
+#include <vector>
+
+// A line to draw between two near dots; strength is 1 when they touch and
+// falls to 0 at the link distance
+struct DotLink {
+    int a;
+    int b;
+    float strength;
+};
+
+// The start screen's drifting background, built to scale to 100k+ dots.
+// Dots live in structure-of-arrays form and move in one SIMD pass that
+// integrates and bounces off the bounds, split across the thread pool once
+// there are enough of them. Near pairs are found through a uniform grid
+// with cells one link distance wide, rebuilt by counting sort each time,
+// so a dot only ever looks at its own and neighbouring cells.
+//
+// Lines only join as many dots as the link budget can cover. Dots are
+// scattered in random order, so the first N form an even sample of the
+// field; the rest drift unlinked.
+class DotField {
+public:
+    static constexpr int kParallelThreshold = 16384;   // dots before Step/FindLinks use the pool
+    static constexpr int kChunk = 8192;
+
+    // Scatter `count` dots over bounds. Sizes shrink as the field gets
+    // denser, so it looks alike at any count.
+    void Reset(int count, Rect bounds, uint64_t seed);
+
+    void Step(float deltaTime, ThreadPool& pool);
+
+    // Link near pairs among as many dots as make about maxLinks lines, with
+    // the link distance set so each has a few neighbours. The result
+    // depends only on the positions, not on the thread count.
+    void FindLinks(int maxLinks, ThreadPool& pool);
+
+    int Count() const { return count; }
+    Rect Bounds() const { return bounds; }
+    float LinkDistance() const { return linkDistance; }
+    int LinkedCount() const { return linkedCount; }
+
+    const float* PositionsX() const { return posX.data(); }
+    const float* PositionsY() const { return posY.data(); }
+    // Positions before the last Step, for interpolated drawing
+    const float* PreviousPositionsX() const { return prevX.data(); }
+    const float* PreviousPositionsY() const { return prevY.data(); }
+    const float* Sizes() const { return size.data(); }
+    const Rgba* Colors() const { return color.data(); }
+    const std::vector<DotLink>& Links() const { return links; }
+
+private:
+    void StepRange(int begin, int end, float deltaTime);
+    void BuildGrid(int dots);
+    void LinkRows(int rowBegin, int rowEnd, int maxLinks, std::vector<DotLink>& out) const;
+
+    int count = 0;
+    Rect bounds = {0, 0, 0, 0};
+    float linkDistance = 0.0f;
+    int linkedCount = 0;
+    Rng rng;
+
+    // Padded to a multiple of 4 so the SIMD pass needs no scalar tail
+    std::vector<float> posX;
+    std::vector<float> posY;
+    std::vector<float> prevX;
+    std::vector<float> prevY;
+    std::vector<float> velX;
+    std::vector<float> velY;
+    std::vector<float> size;
+    std::vector<Rgba> color;
+
+    // Grid over the bounds; dots of cell c are slots [cellStart[c], cellStart[c + 1])
+    float cellSize = 1.0f;
+    int cols = 0;
+    int rows = 0;
+    std::vector<int> cellStart;
+    std::vector<int> dotCell;
+    std::vector<int> cellCursor;
+    std::vector<float> cellX;
+    std::vector<float> cellY;
+    std::vector<int> cellDot;
+
+    std::vector<std::vector<DotLink>> chunkLinks;
+    std::vector<DotLink> links;
+};
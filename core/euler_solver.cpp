@@ -0,0 +1,182 @@
+#include "euler_solver.h"
+
+using namespace std;
+
+const char* SolveStatusName(SolveStatus status) {
+    switch (status) {
+        case SOLVE_OK: return "ok";
+        case SOLVE_ALREADY_COMPLETE: return "already complete";
+        case SOLVE_EDGE_REUSED: return "edge reused";
+        case SOLVE_NO_EDGES: return "no edges";
+        case SOLVE_TOO_MANY_ODD: return "too many odd nodes";
+        case SOLVE_WRONG_START: return "wrong start node";
+        case SOLVE_DISCONNECTED: return "disconnected";
+        case SOLVE_CANCELLED: return "cancelled";
+    }
+    return "unknown";
+}
+
+void EulerSolver::Solve(const GraphIndex& graph, const DynamicBitset& usedEdges, int startNode, SolveResult& result) {
+    int nodeCount = graph.NodeCount();
+    int edgeCount = graph.EdgeCount();
+    result.nodes.clear();
+    result.edges.clear();
+    result.oddNodes = 0;
+
+    if (edgeCount == 0) {
+        result.status = SOLVE_NO_EDGES;
+        return;
+    }
+
+    // Degrees of the untraced part of the graph
+    remainingDegree.assign(nodeCount, 0);
+    int remainingEdges = 0;
+    for (int e = 0; e < edgeCount; e++) {
+        if (usedEdges.Test(e)) continue;
+        remainingDegree[graph.EdgeNodeA(e)]++;
+        remainingDegree[graph.EdgeNodeB(e)]++;
+        remainingEdges++;
+    }
+
+    if (remainingEdges == 0) {
+        result.status = SOLVE_ALREADY_COMPLETE;
+        return;
+    }
+
+    int firstOdd = -1;
+    int firstWithEdges = -1;
+    for (int n = 0; n < nodeCount; n++) {
+        if (remainingDegree[n] % 2 == 1) {
+            result.oddNodes++;
+            if (firstOdd == -1) firstOdd = n;
+        }
+        if (remainingDegree[n] > 0 && firstWithEdges == -1) firstWithEdges = n;
+    }
+
+    if (result.oddNodes > 2) {
+        result.status = SOLVE_TOO_MANY_ODD;
+        return;
+    }
+
+    if (startNode == -1) {
+        startNode = (result.oddNodes == 2) ? firstOdd : firstWithEdges;
+    } else if (result.oddNodes == 2 && remainingDegree[startNode] % 2 == 0) {
+        result.status = SOLVE_WRONG_START;
+        return;
+    }
+
+    if (remainingDegree[startNode] == 0) {
+        result.status = SOLVE_DISCONNECTED;
+        return;
+    }
+
+    // Iterative Hierholzer: walk until stuck, then back up emitting the trail
+    // from its far end. cursor[n] remembers how far node n's neighbour list
+    // has been scanned so each half edge is looked at once. The walk covers
+    // exactly the start node's component, so a short trail means some
+    // remaining edges are unreachable.
+    taken = usedEdges;
+    cursor.assign(nodeCount, 0);
+    result.nodes.resize(remainingEdges + 1);
+    result.edges.resize(remainingEdges);
+    int nodeSlot = remainingEdges + 1;
+    int edgeSlot = remainingEdges;
+
+    // The stack holds the half edge used to reach each node; the start
+    // node's entry has edge -1
+    trail.resize(remainingEdges + 1);
+    int depth = 0;
+    trail[0] = {startNode, -1};
+    int steps = 0;
+
+    while (depth >= 0) {
+        if (++steps == kCancelCheckSteps) {
+            steps = 0;
+            if (Cancelled()) {
+                result.nodes.clear();
+                result.edges.clear();
+                result.status = SOLVE_CANCELLED;
+                return;
+            }
+        }
+        int node = trail[depth].node;
+        const HalfEdge* begin = graph.NeighborsBegin(node);
+        int degree = graph.Degree(node);
+        int at = cursor[node];
+
+        while (at < degree && taken.Test(begin[at].edge)) {
+            at++;
+        }
+        cursor[node] = at;
+
+        if (at < degree) {
+            taken.Set(begin[at].edge);
+            trail[++depth] = begin[at];
+        } else {
+            result.nodes[--nodeSlot] = node;
+            if (depth > 0) result.edges[--edgeSlot] = trail[depth].edge;
+            depth--;
+        }
+    }
+
+    if (edgeSlot != 0) {
+        result.nodes.clear();
+        result.edges.clear();
+        result.status = SOLVE_DISCONNECTED;
+        return;
+    }
+
+    result.status = SOLVE_OK;
+}
+
+void EulerSolver::SolveFromPath(const GraphIndex& graph, const vector<int>& path, SolveResult& result) {
+    used.Resize(graph.EdgeCount());
+
+    for (size_t i = 1; i < path.size(); i++) {
+        int from = path[i - 1];
+        int to = path[i];
+        int edge = -1;
+        bool reused = false;
+        for (const HalfEdge* he = graph.NeighborsBegin(from); he != graph.NeighborsEnd(from); ++he) {
+            if (he->node != to) continue;
+            if (!used.Test(he->edge)) {
+                edge = he->edge;
+                break;
+            }
+            reused = true;
+        }
+        if (edge == -1) {
+            result.nodes.clear();
+            result.edges.clear();
+            result.oddNodes = 0;
+            result.status = reused ? SOLVE_EDGE_REUSED : SOLVE_DISCONNECTED;
+            return;
+        }
+        used.Set(edge);
+    }
+
+    Solve(graph, used, path.empty() ? -1 : path.back(), result);
+}
+
+void EulerSolver::SolveFromEdges(const GraphIndex& graph, const vector<int>& pathEdges, int lastNode, SolveResult& result) {
+    used.Resize(graph.EdgeCount());
+
+    for (int edge : pathEdges) {
+        if (used.Test(edge)) {
+            result.nodes.clear();
+            result.edges.clear();
+            result.oddNodes = 0;
+            result.status = SOLVE_EDGE_REUSED;
+            return;
+        }
+        used.Set(edge);
+    }
+
+    Solve(graph, used, lastNode, result);
+}
+
+SolveStatus EulerSolver::Validate(const GraphIndex& graph) {
+    used.Resize(graph.EdgeCount());
+    Solve(graph, used, -1, scratch);
+    return scratch.status;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "bitset.h"
+#include "graph_index.h"
+
+#include <atomic>
+#include <vector>
+
+enum SolveStatus {
+    SOLVE_OK,                // trail found covering every remaining edge
+    SOLVE_ALREADY_COMPLETE,  // no edges left to trace
+    SOLVE_EDGE_REUSED,       // the given path traces some edge twice
+    SOLVE_NO_EDGES,          // the level has no edges at all
+    SOLVE_TOO_MANY_ODD,      // more than two odd nodes remain: no trail exists
+    SOLVE_WRONG_START,       // two odd nodes remain and the path ends on neither
+    SOLVE_DISCONNECTED,      // remaining edges are not reachable from the path end
+    SOLVE_CANCELLED          // stopped early through the cancel flag
+};
+
+// Remaining trail from the end of a partial path (or a whole-level trail when
+// starting fresh). nodes[0] is the start node; edges[i] joins nodes[i] and
+// nodes[i + 1].
+struct SolveResult {
+    SolveStatus status;
+    int oddNodes;
+    std::vector<int> nodes;
+    std::vector<int> edges;
+};
+
+const char* SolveStatusName(SolveStatus status);
+
+// Hierholzer's algorithm over a GraphIndex plus a bitset of already-used
+// edges. Runs in O(V + E) and keeps its scratch buffers between calls so
+// repeated solves on the same level don't allocate.
+class EulerSolver {
+public:
+    // Solve for a trail over all edges not set in `used`, starting at
+    // `startNode`. Pass -1 to let the solver pick a valid start.
+    void Solve(const GraphIndex& graph, const DynamicBitset& used, int startNode, SolveResult& result);
+
+    // Solve the remainder of a path given as a node sequence; the edge
+    // between consecutive nodes is the first unused one joining them.
+    void SolveFromPath(const GraphIndex& graph, const std::vector<int>& path, SolveResult& result);
+
+    // Solve the remainder of a path given by the edge ids it traced, ending
+    // at `lastNode` (-1 for an empty path)
+    void SolveFromEdges(const GraphIndex& graph, const std::vector<int>& pathEdges, int lastNode, SolveResult& result);
+
+    // Whole-level solvability check
+    SolveStatus Validate(const GraphIndex& graph);
+
+    // Polled while solving; once it reads true the solve gives up with
+    // SOLVE_CANCELLED. Null, the default, never cancels.
+    void SetCancelFlag(const std::atomic<bool>* flag) { cancel = flag; }
+
+private:
+    // Steps of the walk between looks at the cancel flag
+    static constexpr int kCancelCheckSteps = 1024;
+
+    bool Cancelled() const { return cancel && cancel->load(std::memory_order_relaxed); }
+
+    const std::atomic<bool>* cancel = nullptr;
+    DynamicBitset used;
+    DynamicBitset taken;
+    std::vector<int> remainingDegree;
+    std::vector<int> cursor;
+    std::vector<HalfEdge> trail;
+    SolveResult scratch;
+};
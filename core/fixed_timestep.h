@@ -0,0 +1,34 @@
+#pragma once
+
+// Accumulator that turns variable frame times into a whole number of fixed
+// simulation steps. Whatever is left over is how far the display is between
+// the last two simulated states, for the renderer to interpolate by.
+class FixedTimestep {
+public:
+    // maxSteps bounds the catch-up after a long stall (a level being
+    // generated, a dragged window); time beyond it is dropped, not replayed
+    explicit FixedTimestep(double step, int maxSteps = 8)
+        : step(step), maxSteps(maxSteps), accumulator(0.0) {}
+
+    // Feed one frame's elapsed time; returns the steps to run for it
+    int Advance(double frameTime) {
+        if (frameTime > 0.0) accumulator += frameTime;
+        int steps = (int)(accumulator / step);
+        if (steps > maxSteps) {
+            steps = maxSteps;
+            accumulator = 0.0;
+        } else {
+            accumulator -= steps * step;
+        }
+        return steps;
+    }
+
+    double Step() const { return step; }
+    // 0 shows the previous step, 1 the latest
+    float Alpha() const { return (float)(accumulator / step); }
+
+private:
+    double step;
+    int maxSteps;
+    double accumulator;
+};
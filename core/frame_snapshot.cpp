@@ -0,0 +1,229 @@
+#include "frame_snapshot.h"
+
+#include "profiler.h"
+#include "rng.h"
+
+#include <algorithm>
+
+using namespace std;
+
+void SnapshotBuffer::Publish() {
+    writeIndex = ready.exchange(writeIndex | kFresh, memory_order_acq_rel) & ~kFresh;
+}
+
+const FrameSnapshot* SnapshotBuffer::Acquire() {
+    if (ready.load(memory_order_acquire) & kFresh) {
+        readIndex = ready.exchange(readIndex, memory_order_acq_rel) & ~kFresh;
+        anyRead = true;
+    }
+    return anyRead ? &slots[readIndex] : nullptr;
+}
+
+void SnapshotWriter::SetCullMargin(float world, float screen) {
+    worldMargin = world;
+    screenMargin = screen;
+    visibleKey = 0;
+}
+
+Rect SnapshotWriter::PaddedView(const ViewCamera& view) const {
+    Rect rect = view.VisibleWorld();
+    float pad = worldMargin + screenMargin / view.Zoom();
+    return Rect{rect.x - pad, rect.y - pad, rect.width + pad * 2, rect.height + pad * 2};
+}
+
+void SnapshotWriter::Capture(const PuzzleCore& core, FrameSnapshot& out) {
+    PROFILE_ZONE("SnapshotWriter::Capture");
+    long long allocationsBefore = AllocCounter::ThreadAllocations();
+    resized = false;
+    CaptureFrame(core, out);
+    // The first few captures on a level size the layout and each slot for it
+    if (AllocCounter::kEnabled && out.state == PLAYING && !resized) {
+        long long allocations = AllocCounter::ThreadAllocations() - allocationsBefore;
+        allocs.AddFrame(allocations);
+        AllocCounter::ExpectNone(allocations, "SnapshotWriter::Capture");
+    }
+}
+
+void SnapshotWriter::CaptureFrame(const PuzzleCore& core, FrameSnapshot& out) {
+    out.frame = ++frames;
+    out.state = core.GetGameState();
+
+    out.level = core.GetCurrentLevel();
+    out.maxUnlockedLevel = core.GetMaxUnlockedLevel();
+    out.daily = core.IsDailyLevel();
+    out.dailyDay = core.GetDailyDay();
+    out.totalScore = core.GetTotalScore();
+    out.currentScore = core.GetCurrentScore();
+    out.levelComplete = core.IsLevelComplete();
+    out.levelTime = core.GetLevelTime();
+    out.bestTime = out.daily ? -1.0f : core.GetBestTime(out.level);
+    out.currentTime = core.GetCurrentTime();
+
+    out.startButton = core.GetStartButton();
+    out.resetButton = core.GetResetButton();
+    out.nextLevelButton = core.GetNextLevelButton();
+    out.prevLevelButton = core.GetPrevLevelButton();
+    out.hintButton = core.GetHintButton();
+
+    out.view = core.GetView();
+    out.shakeOffset = core.GetShakeOffset();
+    out.levelVersion = core.GetLevelVersion();
+    out.pathVersion = core.GetPathVersion();
+    out.highlightVersion = core.GetHighlightVersion();
+
+    const vector<Vec2>& pathPoints = core.GetPathPoints();
+    out.drawing = core.IsDrawing();
+    out.stuck = core.IsPathStuck();
+    out.pathEmpty = core.GetCurrentPath().empty();
+    out.pathEnd = pathPoints.empty() ? Vec2{0, 0} : pathPoints.back();
+
+    const SolveResult& hint = core.GetHint();
+    int hinted = min((int)hint.edges.size(), FrameSnapshot::kHintEdges);
+    out.hintActive = core.IsHintActive();
+    out.hintReady = core.IsHintReady();
+    out.hintStatus = hint.status;
+    out.hintOddNodes = hint.oddNodes;
+    if (out.hintNodes.capacity() < FrameSnapshot::kHintEdges + 1) {
+        out.hintEdges.reserve(FrameSnapshot::kHintEdges);
+        out.hintNodes.reserve(FrameSnapshot::kHintEdges + 1);
+        resized = true;
+    }
+    out.hintEdges.assign(hint.edges.begin(), hint.edges.begin() + hinted);
+    out.hintNodes.assign(hint.nodes.begin(), hint.nodes.begin() + min((int)hint.nodes.size(), hinted + 1));
+    out.hintPopupVisible = core.IsHintPopupVisible();
+    out.hintPopupAlpha = core.GetHintPopupAlpha();
+
+    out.particles.clear();
+    out.dots.clear();
+    out.links.clear();
+    float alpha = core.GetRenderAlpha();
+
+    if (out.state == START_SCREEN) {
+        const DotField& dots = core.GetBackground();
+        const float* xs = dots.PositionsX();
+        const float* ys = dots.PositionsY();
+        const float* prevXs = dots.PreviousPositionsX();
+        const float* prevYs = dots.PreviousPositionsY();
+        const float* sizes = dots.Sizes();
+        const Rgba* colors = dots.Colors();
+        out.dots.resize(dots.Count());
+        for (int i = 0; i < dots.Count(); i++) {
+            Vec2 pos = {prevXs[i] + (xs[i] - prevXs[i]) * alpha, prevYs[i] + (ys[i] - prevYs[i]) * alpha};
+            out.dots[i] = {pos, sizes[i], colors[i]};
+        }
+        for (const DotLink& link : dots.Links()) {
+            Rgba color = colors[link.a];
+            color.a = (unsigned char)(link.strength * 90.0f);
+            out.links.push_back({out.dots[link.a].pos, out.dots[link.b].pos, color});
+        }
+        return;
+    }
+
+    CaptureBoard(core, out);
+
+    Rect view = PaddedView(out.view);
+    const ParticlePool& particles = core.GetParticles();
+    const float* xs = particles.PositionsX();
+    const float* ys = particles.PositionsY();
+    const float* prevXs = particles.PreviousPositionsX();
+    const float* prevYs = particles.PreviousPositionsY();
+    const float* sizes = particles.Sizes();
+    const Rgba* colors = particles.Colors();
+    if ((int)out.particles.capacity() < particles.Capacity()) {
+        out.particles.reserve(particles.Capacity());
+        resized = true;
+    }
+    for (int i = 0; i < particles.Count(); i++) {
+        Vec2 pos = {prevXs[i] + (xs[i] - prevXs[i]) * alpha, prevYs[i] + (ys[i] - prevYs[i]) * alpha};
+        if (!PointInRect(pos, view)) continue;
+        Rgba color = colors[i];
+        color.a = (unsigned char)particles.Alpha(i);
+        out.particles.push_back({pos, sizes[i], color});
+    }
+}
+
+void SnapshotWriter::CaptureBoard(const PuzzleCore& core, FrameSnapshot& out) {
+    const vector<Node>& nodes = core.GetNodes();
+    const GraphIndex& graph = core.GetGraph();
+
+    if (!board || boardVersion != out.levelVersion) {
+        auto layout = make_shared<BoardLayout>();
+        layout->nodes.resize(nodes.size());
+        for (size_t i = 0; i < nodes.size(); i++) layout->nodes[i] = nodes[i].position;
+        layout->edges.resize(graph.EdgeCount());
+        for (int i = 0; i < graph.EdgeCount(); i++) {
+            layout->edges[i] = {graph.EdgeNodeA(i), graph.EdgeNodeB(i), graph.ParallelIndex(i), graph.ParallelCount(i)};
+        }
+        layout->nodeRadius = core.GetNodeRadius();
+        board = move(layout);
+        boardVersion = out.levelVersion;
+        resized = true;
+    }
+    out.board = board;
+
+    uint64_t cullKey = MixSeed(out.levelVersion, out.view.Version());
+    if (!visible || cullKey != visibleKey) {
+        // Snapshots only hold culling results the writer handed them, so
+        // one held here alone is drawn from by no one
+        visible = nullptr;
+        int free = 0;
+        while (cullings[free].use_count() > 1) free++;
+        shared_ptr<BoardCulling>& culling = cullings[free];
+        if (!culling) culling = make_shared<BoardCulling>();
+        if (cullingLevels[free] != out.levelVersion) {
+            // Zoomed all the way out everything is in view
+            culling->nodes.reserve(board->nodes.size());
+            culling->edges.reserve(board->edges.size());
+            cullingLevels[free] = out.levelVersion;
+            resized = true;
+        }
+        Rect rect = PaddedView(out.view);
+        core.FindNodesInRect(rect, culling->nodes);
+        core.FindEdgesInRect(rect, culling->edges);
+        visible = culling;
+        visibleKey = cullKey;
+    }
+    out.visible = visible;
+
+    SyncBoardStates(core);
+    // This slot was last filled a couple of frames ago; most frames nothing
+    // it draws from has changed since
+    uint64_t stateKey = MixSeed(MixSeed(out.levelVersion, out.pathVersion), out.highlightVersion);
+    if (stateKey == out.boardStateKey && out.edgeStates.size() == edgeStates.size()) return;
+    if (out.edgeStates.size() != edgeStates.size()) resized = true;
+    out.boardStateKey = stateKey;
+    out.edgeStates = edgeStates;
+    out.nodeFlags = nodeFlags;
+}
+
+// The path only grows between restarts, so only the edges and nodes added
+// since the last capture need counting in
+void SnapshotWriter::SyncBoardStates(const PuzzleCore& core) {
+    const vector<int>& pathEdges = core.GetPathEdges();
+    const vector<int>& path = core.GetCurrentPath();
+    unsigned int level = core.GetLevelVersion();
+    unsigned int serial = core.GetPathSerial();
+    if (!statesValid || level != statesLevel || serial != statesSerial || pathEdges.size() < statesPathEdges) {
+        edgeStates.assign(core.GetEdges().size(), EDGE_UNTRACED);
+        nodeFlags.assign(core.GetNodes().size(), 0);
+        statesValid = true;
+        statesLevel = level;
+        statesSerial = serial;
+        statesPathEdges = 0;
+        statesPathNodes = 0;
+        statesHighlight = -1;
+    }
+
+    for (; statesPathEdges < pathEdges.size(); statesPathEdges++) {
+        unsigned char& state = edgeStates[pathEdges[statesPathEdges]];
+        state = (unsigned char)(state == EDGE_UNTRACED ? EDGE_TRACED : EDGE_RETRACED);
+    }
+    for (; statesPathNodes < path.size(); statesPathNodes++) nodeFlags[path[statesPathNodes]] |= NODE_ON_PATH;
+
+    int highlight = core.GetHighlightedNode();
+    if (highlight != statesHighlight) {
+        if (statesHighlight >= 0) nodeFlags[statesHighlight] &= (unsigned char)~NODE_HIGHLIGHTED;
+        if (highlight >= 0) nodeFlags[highlight] |= NODE_HIGHLIGHTED;
+        statesHighlight = highlight;
+    }
+}
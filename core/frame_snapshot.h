@@ -0,0 +1,194 @@
+#pragma once
+
+#include "alloc_counter.h"
+#include "dot_field.h"
+#include "euler_solver.h"
+#include "puzzle_core.h"
+#include "types.h"
+#include "view_camera.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// An edge as drawn: its nodes and its place among parallel edges
+struct BoardEdge {
+    int a;
+    int b;
+    int lane;    // see GraphIndex::ParallelIndex
+    int lanes;   // see GraphIndex::ParallelCount
+};
+
+// A level's layout, built once when it loads and shared by every snapshot
+// taken while it is played. Never changes once built.
+struct BoardLayout {
+    std::vector<Vec2> nodes;
+    std::vector<BoardEdge> edges;
+    float nodeRadius;
+};
+
+// Nodes whose centres and edges whose bounding boxes lie inside the padded
+// view, ascending. Shared until the level or the camera changes.
+struct BoardCulling {
+    std::vector<int> nodes;
+    std::vector<int> edges;
+};
+
+enum EdgeDrawState {
+    EDGE_UNTRACED,
+    EDGE_TRACED,
+    EDGE_RETRACED   // traced more than once
+};
+
+enum NodeDrawFlags {
+    NODE_HIGHLIGHTED = 1,
+    NODE_ON_PATH = 2
+};
+
+// Something round to draw, interpolated to the frame and faded already
+struct SnapshotSprite {
+    Vec2 pos;
+    float size;
+    Rgba color;
+};
+
+struct SnapshotLine {
+    Vec2 a;
+    Vec2 b;
+    Rgba color;
+};
+
+// Everything the renderer draws one frame from. The simulation fills it
+// after each update; the renderer reads it without touching the core, so
+// the two can run on different threads.
+struct FrameSnapshot {
+    static constexpr int kHintEdges = 8;   // first edges of the hinted trail kept
+
+    long long frame = 0;   // updates simulated when it was taken
+    GameState state = START_SCREEN;
+
+    int level = 1;
+    int maxUnlockedLevel = 1;
+    bool daily = false;
+    int dailyDay = 0;
+    int totalScore = 0;
+    int currentScore = 0;
+    bool levelComplete = false;
+    float levelTime = 0.0f;
+    float bestTime = -1.0f;     // negative if none, or on the daily level
+    float currentTime = 0.0f;
+
+    Rect startButton;
+    Rect resetButton;
+    Rect nextLevelButton;
+    Rect prevLevelButton;
+    Rect hintButton;
+
+    ViewCamera view;
+    Vec2 shakeOffset = {0, 0};
+    // Bumped when the matching part changes; see PuzzleCore
+    unsigned int levelVersion = 0;
+    unsigned int pathVersion = 0;
+    unsigned int highlightVersion = 0;
+
+    bool drawing = false;
+    bool stuck = false;
+    bool pathEmpty = true;
+    Vec2 pathEnd = {0, 0};
+
+    bool hintActive = false;
+    bool hintReady = false;
+    SolveStatus hintStatus = SOLVE_NO_EDGES;
+    int hintOddNodes = 0;
+    std::vector<int> hintNodes;   // hintNodes[i] and hintNodes[i + 1] are joined by hintEdges[i]
+    std::vector<int> hintEdges;
+    bool hintPopupVisible = false;
+    float hintPopupAlpha = 0.0f;
+
+    std::shared_ptr<const BoardLayout> board;
+    std::shared_ptr<const BoardCulling> visible;
+    std::vector<unsigned char> edgeStates;   // EdgeDrawState by edge
+    std::vector<unsigned char> nodeFlags;    // NodeDrawFlags by node
+    uint64_t boardStateKey = 0;              // what edgeStates and nodeFlags were built from
+
+    std::vector<SnapshotSprite> particles;   // inside the padded view, world space
+    // Start screen background, screen space
+    std::vector<SnapshotSprite> dots;
+    std::vector<SnapshotLine> links;
+};
+
+// Three snapshots: one being written, one being drawn and the newest
+// finished one between them. Handing one over is a single atomic exchange,
+// so neither side ever waits for the other, and the renderer always gets
+// the newest snapshot without ever seeing one half written.
+class SnapshotBuffer {
+public:
+    // Simulation side: the slot to fill next, and hand it over
+    FrameSnapshot& WriteSlot() { return slots[writeIndex]; }
+    void Publish();
+
+    // Render side: the newest published snapshot, or null before the
+    // first. It stays untouched until the next Acquire.
+    const FrameSnapshot* Acquire();
+
+private:
+    static constexpr int kFresh = 4;   // set on `ready` until the reader takes it
+
+    FrameSnapshot slots[3];
+    int writeIndex = 0;            // writer only
+    int readIndex = 1;             // reader only
+    bool anyRead = false;          // reader only
+    std::atomic<int> ready{2};
+};
+
+// Fills snapshots from the core. Layouts are rebuilt only when the level
+// changes and culling results only when the camera moves; both are shared
+// between snapshots, and culling results are refilled in place once no
+// snapshot holds them any more.
+// Per-edge and per-node states are kept here and brought up to date from
+// the edges traced since the last capture, then copied into a snapshot only
+// when the path or hover changed since it was last filled, so a typical
+// frame copies just the small per-frame state and the particles.
+class SnapshotWriter {
+public:
+    // How far what gets drawn can stick out past node centres: in world
+    // units (node circles, fanned-out parallel edges) and in screen
+    // pixels (the shake)
+    void SetCullMargin(float world, float screen);
+    void Capture(const PuzzleCore& core, FrameSnapshot& out);
+
+    // Heap allocations made by Capture while a level is played; see
+    // PuzzleCore::GetFrameAllocStats
+    const FrameAllocStats& GetAllocStats() const { return allocs; }
+
+private:
+    // One per snapshot slot, plus the newest while the oldest is refilled
+    static constexpr int kCullingBuffers = 5;
+
+    void CaptureFrame(const PuzzleCore& core, FrameSnapshot& out);
+    void CaptureBoard(const PuzzleCore& core, FrameSnapshot& out);
+    void SyncBoardStates(const PuzzleCore& core);
+    Rect PaddedView(const ViewCamera& view) const;
+
+    float worldMargin = 0.0f;
+    float screenMargin = 0.0f;
+    long long frames = 0;
+    std::shared_ptr<const BoardLayout> board;
+    unsigned int boardVersion = 0;
+    std::shared_ptr<BoardCulling> cullings[kCullingBuffers];
+    unsigned int cullingLevels[kCullingBuffers] = {};   // level each was sized for
+    std::shared_ptr<const BoardCulling> visible;
+    uint64_t visibleKey = 0;
+    FrameAllocStats allocs;
+    bool resized = false;   // this capture sized something for a new level
+
+    std::vector<unsigned char> edgeStates;
+    std::vector<unsigned char> nodeFlags;
+    bool statesValid = false;
+    unsigned int statesLevel = 0;
+    unsigned int statesSerial = 0;
+    size_t statesPathEdges = 0;   // edges of the path counted in so far
+    size_t statesPathNodes = 0;
+    int statesHighlight = -1;
+};
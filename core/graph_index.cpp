@@ -0,0 +1,75 @@
+#include "graph_index.h"
+
+#include <algorithm>
+
+using namespace std;
+
+void GraphIndex::Build(int nodeCount, const vector<Edge>& edges) {
+    offsets.assign(nodeCount + 1, 0);
+    edgeNodes.resize(edges.size() * 2);
+
+    for (size_t i = 0; i < edges.size(); i++) {
+        offsets[edges[i].nodeA + 1]++;
+        offsets[edges[i].nodeB + 1]++;
+        edgeNodes[i * 2] = edges[i].nodeA;
+        edgeNodes[i * 2 + 1] = edges[i].nodeB;
+    }
+    for (int n = 0; n < nodeCount; n++) {
+        offsets[n + 1] += offsets[n];
+    }
+
+    // Fill in edge order so each node's neighbours are sorted by edge id.
+    // offsets[n] serves as node n's cursor and ends up at offsets[n + 1],
+    // so shifting them all back one restores them.
+    halfEdges.resize(edges.size() * 2);
+    for (size_t i = 0; i < edges.size(); i++) {
+        int a = edges[i].nodeA;
+        int b = edges[i].nodeB;
+        halfEdges[offsets[a]++] = {b, (int)i};
+        halfEdges[offsets[b]++] = {a, (int)i};
+    }
+    for (int n = nodeCount; n > 0; n--) {
+        offsets[n] = offsets[n - 1];
+    }
+    offsets[0] = 0;
+
+    // Group edges by their unordered node pair to number parallel edges
+    order.resize(edges.size());
+    for (size_t i = 0; i < edges.size(); i++) {
+        order[i] = (int)i;
+    }
+    auto pairKey = [&](int e) {
+        int a = min(edges[e].nodeA, edges[e].nodeB);
+        int b = max(edges[e].nodeA, edges[e].nodeB);
+        return ((long long)a << 32) | (unsigned int)b;
+    };
+    sort(order.begin(), order.end(), [&](int x, int y) {
+        long long kx = pairKey(x);
+        long long ky = pairKey(y);
+        return kx != ky ? kx < ky : x < y;
+    });
+
+    parallelIndex.assign(edges.size(), 0);
+    parallelCount.assign(edges.size(), 1);
+    size_t groupStart = 0;
+    for (size_t i = 1; i <= order.size(); i++) {
+        if (i < order.size() && pairKey(order[i]) == pairKey(order[groupStart])) continue;
+        int count = (int)(i - groupStart);
+        for (size_t j = groupStart; j < i; j++) {
+            parallelIndex[order[j]] = (int)(j - groupStart);
+            parallelCount[order[j]] = count;
+        }
+        groupStart = i;
+    }
+    order.clear();
+}
+
+int GraphIndex::FindEdge(int a, int b, const vector<Edge>& edges) const {
+    int found = -1;
+    for (const HalfEdge* he = NeighborsBegin(a); he != NeighborsEnd(a); ++he) {
+        if (he->node != b) continue;
+        if (edges[he->edge].visitCount == 0) return he->edge;
+        if (found == -1) found = he->edge;
+    }
+    return found;
+}
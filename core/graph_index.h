@@ -0,0 +1,51 @@
+#pragma once
+
+#include "level.h"
+
+#include <vector>
+
+// One side of an undirected edge as seen from a node
+struct HalfEdge {
+    int node;   // the node at the other end
+    int edge;   // index into the level's edge list
+};
+
+// Compressed adjacency (CSR) over a level's edge list. Neighbours of node n
+// are halfEdges[offsets[n] .. offsets[n + 1]). Parallel edges and self loops
+// each get their own half edges, so the index is a true multigraph view.
+class GraphIndex {
+public:
+    void Build(int nodeCount, const std::vector<Edge>& edges);
+
+    int NodeCount() const { return (int)offsets.size() - 1; }
+    int EdgeCount() const { return (int)edgeNodes.size() / 2; }
+    int Degree(int node) const { return offsets[node + 1] - offsets[node]; }
+
+    const HalfEdge* NeighborsBegin(int node) const { return halfEdges.data() + offsets[node]; }
+    const HalfEdge* NeighborsEnd(int node) const { return halfEdges.data() + offsets[node + 1]; }
+
+    int EdgeNodeA(int edge) const { return edgeNodes[edge * 2]; }
+    int EdgeNodeB(int edge) const { return edgeNodes[edge * 2 + 1]; }
+    int OtherNode(int edge, int node) const {
+        return edgeNodes[edge * 2] == node ? edgeNodes[edge * 2 + 1] : edgeNodes[edge * 2];
+    }
+
+    // First edge joining a and b, preferring one whose visitCount is still
+    // zero so parallel edges get traced one after another. -1 if none.
+    int FindEdge(int a, int b, const std::vector<Edge>& edges) const;
+
+    // Position of an edge among the edges joining the same two nodes, for
+    // drawing parallel edges side by side
+    int ParallelIndex(int edge) const { return parallelIndex[edge]; }
+    int ParallelCount(int edge) const { return parallelCount[edge]; }
+
+private:
+    std::vector<int> offsets;
+    std::vector<HalfEdge> halfEdges;
+    std::vector<int> edgeNodes;
+    std::vector<int> parallelIndex;
+    std::vector<int> parallelCount;
+    // Build's working space, kept so rebuilding reuses it. Left empty, so
+    // copies of the index don't carry it.
+    std::vector<int> order;
+};
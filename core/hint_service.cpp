@@ -0,0 +1,156 @@
+#include "hint_service.h"
+
+using namespace std;
+
+HintService::HintService() {
+    cache.reserve(kCacheSize);
+    solver.SetCancelFlag(&cancel);
+    worker = thread(&HintService::WorkerLoop, this);
+}
+
+HintService::~HintService() {
+    {
+        lock_guard<mutex> lock(requestMutex);
+        stopping = true;
+    }
+    cancel = true;
+    wake.notify_all();
+    worker.join();
+}
+
+void HintService::SetLevel(const GraphIndex& levelGraph) {
+    {
+        // A level the worker hasn't picked up yet frees its copy
+        lock_guard<mutex> lock(requestMutex);
+        newLevel = nullptr;
+    }
+    // Only the worker ever takes a reference to a copy, so one held here
+    // alone stays free while it is refilled
+    int free = 0;
+    while (free < 2 && levelCopies[free].use_count() > 1) free++;
+    if (levelCopies[free].use_count() > 1) levelCopies[free] = nullptr;
+    // Pairs with the worker dropping its reference: its reads of the old
+    // graph are done before this overwrites it
+    atomic_thread_fence(memory_order_acquire);
+    if (levelCopies[free]) {
+        *levelCopies[free] = levelGraph;
+    } else {
+        levelCopies[free] = make_shared<GraphIndex>(levelGraph);
+    }
+    {
+        lock_guard<mutex> lock(requestMutex);
+        newLevel = levelCopies[free];
+        restartPath = true;
+        newEdges.clear();
+        newEdges.reserve(levelGraph.EdgeCount());
+        requested = false;
+        cache.clear();
+        cancel = true;
+    }
+    sentSerial = 0;
+    sentEdges = 0;
+}
+
+void HintService::Request(uint64_t key, const vector<int>& pathEdges, int lastNode, unsigned int pathSerial) {
+    {
+        lock_guard<mutex> lock(requestMutex);
+        if (pathSerial != sentSerial || pathEdges.size() < sentEdges) {
+            restartPath = true;
+            newEdges.clear();
+            sentSerial = pathSerial;
+            sentEdges = 0;
+        }
+        newEdges.insert(newEdges.end(), pathEdges.begin() + sentEdges, pathEdges.end());
+        sentEdges = pathEdges.size();
+        requestNode = lastNode;
+        requestKey = key;
+        requested = FindLocked(key) == nullptr;
+        if (!requested) return;
+        // Whatever the worker is solving is for an older path now. Set
+        // under the lock: the worker clears it as it takes the request.
+        cancel = true;
+    }
+    wake.notify_one();
+}
+
+shared_ptr<const SolveResult> HintService::Find(uint64_t key) {
+    lock_guard<mutex> lock(requestMutex);
+    return FindLocked(key);
+}
+
+shared_ptr<const SolveResult> HintService::FindLocked(uint64_t key) {
+    for (size_t i = 0; i < cache.size(); i++) {
+        if (cache[i].first != key) continue;
+        // Move to the back so the oldest unused entry goes first
+        auto entry = move(cache[i]);
+        cache.erase(cache.begin() + i);
+        cache.push_back(move(entry));
+        return cache.back().second;
+    }
+    return nullptr;
+}
+
+void HintService::WorkerLoop() {
+    vector<int> edges;
+    while (true) {
+        shared_ptr<const GraphIndex> level;
+        bool restart;
+        uint64_t key;
+        int startNode;
+        bool solve;
+        {
+            unique_lock<mutex> lock(requestMutex);
+            wake.wait(lock, [this] { return stopping || requested || newLevel || restartPath || !newEdges.empty(); });
+            if (stopping) return;
+            // The buffers trade places below; the one handed back needs
+            // room for a whole path on the new level as well
+            if (newLevel) edges.reserve(newLevel->EdgeCount());
+            level = move(newLevel);
+            restart = restartPath;
+            restartPath = false;
+            edges.swap(newEdges);
+            newEdges.clear();
+            key = requestKey;
+            startNode = requestNode;
+            solve = requested;
+            requested = false;
+            cancel = false;
+        }
+
+        // Outside the lock: dropping the old level's graph takes a while
+        // on a big board
+        if (level) graph = move(level);
+        if (restart && graph) {
+            used.Resize(graph->EdgeCount());
+            reused = false;
+        }
+        if (graph) {
+            for (int edge : edges) {
+                if (used.Test(edge)) reused = true;
+                used.Set(edge);
+            }
+        }
+        edges.clear();
+        // Without a request this only kept the path copy current
+        if (!graph || !solve) continue;
+
+        auto result = make_shared<SolveResult>();
+        if (reused) {
+            result->status = SOLVE_EDGE_REUSED;
+            result->oddNodes = 0;
+        } else {
+            solver.Solve(*graph, used, startNode, *result);
+        }
+        if (result->status == SOLVE_CANCELLED) {
+            cancelCount.fetch_add(1, memory_order_relaxed);
+            continue;
+        }
+        solveCount.fetch_add(1, memory_order_relaxed);
+
+        lock_guard<mutex> lock(requestMutex);
+        // A level change while solving makes this trail meaningless
+        if (newLevel) continue;
+        if ((int)cache.size() == kCacheSize) cache.erase(cache.begin());
+        cache.emplace_back(key, move(result));
+    }
+}
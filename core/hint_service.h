@@ -0,0 +1,87 @@
+#pragma once
+
+#include "bitset.h"
+#include "euler_solver.h"
+#include "graph_index.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Works out the rest of the player's trail on a thread of its own, so a
+// hint never holds up a frame on large boards.
+//
+// The frame loop calls Request whenever the path changes. Only the edges
+// traced since the previous request cross over; the worker keeps its own
+// copy of the path. A newer request replaces one that hasn't started and
+// cancels one being solved, so while the player keeps drawing only the
+// latest path state is worked on. Finished trails are cached by a key the
+// caller derives from the path state, and Find picks them up without
+// waiting.
+class HintService {
+public:
+    static constexpr int kCacheSize = 32;
+
+    HintService();
+    ~HintService();
+
+    HintService(const HintService&) = delete;
+    HintService& operator=(const HintService&) = delete;
+
+    // Start over on a new level: the graph is copied for the worker, and
+    // pending work and cached trails for the old one are dropped
+    void SetLevel(const GraphIndex& graph);
+    // Ask for the trail from the end of the path traced by `pathEdges`
+    // (ending at `lastNode`, -1 when empty). The path may only have grown
+    // since the last request unless `pathSerial` changed, which says it was
+    // started over.
+    void Request(uint64_t key, const std::vector<int>& pathEdges, int lastNode, unsigned int pathSerial);
+    // The trail for `key` if it has been worked out; null while it is still
+    // pending. Never waits on the worker.
+    std::shared_ptr<const SolveResult> Find(uint64_t key);
+
+    // Solves finished and solves given up for a newer request
+    long long SolveCount() const { return solveCount.load(std::memory_order_relaxed); }
+    long long CancelCount() const { return cancelCount.load(std::memory_order_relaxed); }
+
+private:
+    void WorkerLoop();
+    std::shared_ptr<const SolveResult> FindLocked(uint64_t key);
+
+    // Main thread's record of what the worker has been sent
+    unsigned int sentSerial = 0;
+    size_t sentEdges = 0;
+    // Graph copies handed to the worker, refilled once it lets go of them:
+    // one in use, one on its way over and one being replaced
+    std::shared_ptr<GraphIndex> levelCopies[3];
+
+    std::mutex requestMutex;
+    std::condition_variable wake;
+    // Guarded by requestMutex
+    std::shared_ptr<const GraphIndex> newLevel;
+    bool restartPath = false;
+    std::vector<int> newEdges;
+    int requestNode = -1;
+    uint64_t requestKey = 0;
+    bool requested = false;
+    bool stopping = false;
+    std::vector<std::pair<uint64_t, std::shared_ptr<const SolveResult>>> cache;   // least recently used first
+
+    // Set by the main thread to stop the solve in progress
+    std::atomic<bool> cancel{false};
+    std::atomic<long long> solveCount{0};
+    std::atomic<long long> cancelCount{0};
+
+    // Worker thread only
+    std::shared_ptr<const GraphIndex> graph;
+    DynamicBitset used;
+    bool reused = false;   // the path traces some edge twice
+    EulerSolver solver;
+
+    std::thread worker;
+};
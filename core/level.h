@@ -0,0 +1,17 @@
+#pragma once
+
+#include "types.h"
+
+// A node is a circle point that players connect
+struct Node {
+    Vec2 position;
+    int id;
+    bool isHighlighted;
+};
+
+// An edge is a line connecting two nodes
+struct Edge {
+    int nodeA;
+    int nodeB;
+    int visitCount;
+};
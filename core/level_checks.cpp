@@ -0,0 +1,157 @@
+#include "level_checks.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+const char* LevelIssueName(LevelIssueKind kind) {
+    switch (kind) {
+        case ISSUE_SELF_LOOP: return "self loop";
+        case ISSUE_NODES_TOO_CLOSE: return "nodes too close";
+        case ISSUE_EDGE_THROUGH_NODE: return "edge through node";
+        case ISSUE_DUPLICATE_EDGE: return "duplicate edge";
+        case ISSUE_OVERLAPPING_EDGES: return "overlapping edges";
+    }
+    return "unknown";
+}
+
+float DistanceToSegment(Vec2 p, Vec2 a, Vec2 b) {
+    float abx = b.x - a.x;
+    float aby = b.y - a.y;
+    float lengthSq = abx * abx + aby * aby;
+    float t = 0.0f;
+    if (lengthSq > 0.0f) {
+        t = ((p.x - a.x) * abx + (p.y - a.y) * aby) / lengthSq;
+        t = min(1.0f, max(0.0f, t));
+    }
+    Vec2 closest = {a.x + abx * t, a.y + aby * t};
+    return Distance(p, closest);
+}
+
+bool SegmentHitsCircle(Vec2 a, Vec2 b, Vec2 center, float radius) {
+    return DistanceToSegment(center, a, b) < radius;
+}
+
+bool SegmentsOverlap(Vec2 a, Vec2 b, Vec2 c, Vec2 d, float tolerance) {
+    float abx = b.x - a.x;
+    float aby = b.y - a.y;
+    float length = sqrtf(abx * abx + aby * aby);
+    if (length <= 0.0f) return false;
+
+    // Perpendicular distance of c and d from the line through ab
+    float nx = -aby / length;
+    float ny = abx / length;
+    float distC = (c.x - a.x) * nx + (c.y - a.y) * ny;
+    float distD = (d.x - a.x) * nx + (d.y - a.y) * ny;
+    if (fabsf(distC) > tolerance || fabsf(distD) > tolerance) return false;
+
+    // Project cd onto ab and intersect the two intervals
+    float ux = abx / length;
+    float uy = aby / length;
+    float tc = (c.x - a.x) * ux + (c.y - a.y) * uy;
+    float td = (d.x - a.x) * ux + (d.y - a.y) * uy;
+    float shared = min(length, max(tc, td)) - max(0.0f, min(tc, td));
+    return shared > tolerance;
+}
+
+// Sort one check's issues into the order an all-pairs loop finds them in
+static void SortIssues(vector<LevelIssue>& issues, size_t from) {
+    sort(issues.begin() + from, issues.end(), [](const LevelIssue& l, const LevelIssue& r) {
+        return l.a < r.a || (l.a == r.a && l.b < r.b);
+    });
+}
+
+// Every check compares things that must be close together, so each one
+// sweeps along x in sorted order and only looks at what is within reach,
+// instead of all pairs. Big boards check in near-linear time; the issues
+// come out exactly as the all-pairs loops would list them.
+void CheckLevelGeometry(const vector<Node>& nodes, const vector<Edge>& edges,
+                        float nodeRadius, vector<LevelIssue>& issues) {
+    int nodeCount = (int)nodes.size();
+    int edgeCount = (int)edges.size();
+
+    vector<int> byX(nodeCount);
+    for (int i = 0; i < nodeCount; i++) byX[i] = i;
+    sort(byX.begin(), byX.end(), [&](int l, int r) { return nodes[l].position.x < nodes[r].position.x; });
+    vector<float> xs(nodeCount);
+    for (int i = 0; i < nodeCount; i++) xs[i] = nodes[byX[i]].position.x;
+
+    size_t from = issues.size();
+    float diameter = nodeRadius * 2.0f;
+    for (int s = 0; s < nodeCount; s++) {
+        for (int t = s + 1; t < nodeCount && xs[t] - xs[s] < diameter; t++) {
+            int i = min(byX[s], byX[t]);
+            int j = max(byX[s], byX[t]);
+            if (Distance(nodes[i].position, nodes[j].position) < diameter) {
+                issues.push_back({ISSUE_NODES_TOO_CLOSE, i, j});
+            }
+        }
+    }
+    SortIssues(issues, from);
+
+    from = issues.size();
+    for (int e = 0; e < edgeCount; e++) {
+        const Edge& edge = edges[e];
+        if (edge.nodeA == edge.nodeB) {
+            issues.push_back({ISSUE_SELF_LOOP, e, e});
+            continue;
+        }
+        Vec2 a = nodes[edge.nodeA].position;
+        Vec2 b = nodes[edge.nodeB].position;
+        float top = min(a.y, b.y) - nodeRadius;
+        float bottom = max(a.y, b.y) + nodeRadius;
+        float right = max(a.x, b.x) + nodeRadius;
+        int s = (int)(lower_bound(xs.begin(), xs.end(), min(a.x, b.x) - nodeRadius) - xs.begin());
+        for (; s < nodeCount && xs[s] <= right; s++) {
+            int n = byX[s];
+            if (n == edge.nodeA || n == edge.nodeB) continue;
+            Vec2 center = nodes[n].position;
+            if (center.y < top || center.y > bottom) continue;
+            if (SegmentHitsCircle(a, b, center, nodeRadius)) {
+                issues.push_back({ISSUE_EDGE_THROUGH_NODE, e, n});
+            }
+        }
+    }
+    SortIssues(issues, from);
+
+    // Lines are drawn about a third of a node radius thick, so anything
+    // closer than that reads as one line
+    float tolerance = nodeRadius * 0.33f;
+    vector<int> edgesByX;
+    vector<Rect> boxes(edgeCount);
+    for (int e = 0; e < edgeCount; e++) {
+        const Edge& edge = edges[e];
+        if (edge.nodeA == edge.nodeB) continue;
+        Vec2 a = nodes[edge.nodeA].position;
+        Vec2 b = nodes[edge.nodeB].position;
+        boxes[e] = {min(a.x, b.x), min(a.y, b.y), fabsf(a.x - b.x), fabsf(a.y - b.y)};
+        edgesByX.push_back(e);
+    }
+    sort(edgesByX.begin(), edgesByX.end(), [&](int l, int r) { return boxes[l].x < boxes[r].x; });
+
+    from = issues.size();
+    for (size_t s = 0; s < edgesByX.size(); s++) {
+        const Rect& box = boxes[edgesByX[s]];
+        for (size_t t = s + 1; t < edgesByX.size() && boxes[edgesByX[t]].x <= box.x + box.width + tolerance; t++) {
+            const Rect& other = boxes[edgesByX[t]];
+            if (other.y > box.y + box.height + tolerance || box.y > other.y + other.height + tolerance) continue;
+
+            int e = min(edgesByX[s], edgesByX[t]);
+            int f = max(edgesByX[s], edgesByX[t]);
+            const Edge& first = edges[e];
+            const Edge& second = edges[f];
+            bool samePair = (first.nodeA == second.nodeA && first.nodeB == second.nodeB) ||
+                            (first.nodeA == second.nodeB && first.nodeB == second.nodeA);
+            if (samePair) {
+                issues.push_back({ISSUE_DUPLICATE_EDGE, e, f});
+                continue;
+            }
+            if (SegmentsOverlap(nodes[first.nodeA].position, nodes[first.nodeB].position,
+                                nodes[second.nodeA].position, nodes[second.nodeB].position, tolerance)) {
+                issues.push_back({ISSUE_OVERLAPPING_EDGES, e, f});
+            }
+        }
+    }
+    SortIssues(issues, from);
+}
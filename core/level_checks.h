@@ -0,0 +1,41 @@
+#pragma once
+
+#include "level.h"
+#include "types.h"
+
+#include <vector>
+
+// Geometry rules a playable level has to follow. Shared by the level
+// generator, which checks candidates as it builds them, and offline tools
+// that vet whole levels.
+
+enum LevelIssueKind {
+    ISSUE_SELF_LOOP,          // edge a starts and ends on the same node
+    ISSUE_NODES_TOO_CLOSE,    // nodes a and b overlap on screen
+    ISSUE_EDGE_THROUGH_NODE,  // edge a passes through the circle of node b
+    ISSUE_DUPLICATE_EDGE,     // edges a and b join the same two nodes
+    ISSUE_OVERLAPPING_EDGES   // edges a and b run along each other
+};
+
+struct LevelIssue {
+    LevelIssueKind kind;
+    int a;
+    int b;
+};
+
+const char* LevelIssueName(LevelIssueKind kind);
+
+// Distance from p to the segment ab
+float DistanceToSegment(Vec2 p, Vec2 a, Vec2 b);
+
+// True if the segment ab comes within `radius` of `center`
+bool SegmentHitsCircle(Vec2 a, Vec2 b, Vec2 center, float radius);
+
+// True if segments ab and cd are collinear (within `tolerance` pixels) and
+// share more than `tolerance` of their length
+bool SegmentsOverlap(Vec2 a, Vec2 b, Vec2 c, Vec2 d, float tolerance);
+
+// Append every geometry problem in the level to `issues`. Duplicate edges are
+// reported but are legal: the renderer fans parallel edges apart.
+void CheckLevelGeometry(const std::vector<Node>& nodes, const std::vector<Edge>& edges,
+                        float nodeRadius, std::vector<LevelIssue>& issues);
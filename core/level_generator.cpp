@@ -0,0 +1,276 @@
+#include "level_generator.h"
+
+#include "euler_solver.h"
+#include "level_checks.h"
+#include "profiler.h"
+#include "rng.h"
+#include "trail_counter.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+// Edges meeting at a node closer than this angle read as one line
+static const float kMinEdgeAngleCos = 0.95f;   // about 18 degrees
+
+GeneratorParams MakeGeneratorParams(float difficulty, float nodeRadius) {
+    difficulty = min(1.0f, max(0.0f, difficulty));
+    GeneratorParams params;
+    params.difficulty = difficulty;
+    params.nodeCount = 5 + (int)lroundf(difficulty * 9.0f);
+    params.edgeCount = (int)lroundf(params.nodeCount * (1.3f + 0.7f * difficulty));
+    params.area = {450, 270, 980, 560};
+    params.nodeRadius = nodeRadius;
+    params.candidates = 64;
+    return params;
+}
+
+LevelGenerator::LevelGenerator(ThreadPool& pool) : pool(pool), candidatesBuilt(0) {
+}
+
+bool LevelGenerator::Generate(uint64_t seed, const GeneratorParams& params, GeneratedLevel& level) {
+    PROFILE_ZONE("LevelGenerator::Generate");
+    int count = max(1, params.candidates);
+    results.resize(count);
+    built.assign(count, 0);
+    if ((int)scratch.size() < (count + kCandidateGrain - 1) / kCandidateGrain) {
+        scratch.resize((count + kCandidateGrain - 1) / kCandidateGrain);
+    }
+
+    pool.ParallelFor(count, kCandidateGrain, [&](int begin, int end) {
+        CandidateScratch& taskScratch = scratch[begin / kCandidateGrain];
+        for (int i = begin; i < end; i++) {
+            built[i] = BuildCandidate(MixSeed(seed, (uint64_t)i), params, results[i], taskScratch);
+        }
+    });
+    candidatesBuilt += count;
+
+    // Lowest index wins ties so the pick doesn't depend on scheduling
+    int best = -1;
+    float bestError = 0.0f;
+    for (int i = 0; i < count; i++) {
+        if (!built[i]) continue;
+        float error = fabsf(results[i].rating - params.difficulty);
+        if (best == -1 || error < bestError) {
+            best = i;
+            bestError = error;
+        }
+    }
+    if (best == -1) return false;
+
+    level = results[best];
+    return true;
+}
+
+// Empty the first `count` lists, keeping what they had room for
+static void ClearLists(vector<vector<int>>& lists, int count) {
+    if ((int)lists.size() < count) lists.resize(count);
+    for (int i = 0; i < count; i++) lists[i].clear();
+}
+
+// True if edge (from, to) leaves `from` too close in direction to an edge
+// already there
+static bool TooCloseInAngle(const vector<Node>& nodes, const vector<vector<int>>& chosenAt,
+                            int from, int to) {
+    Vec2 origin = nodes[from].position;
+    float dx = nodes[to].position.x - origin.x;
+    float dy = nodes[to].position.y - origin.y;
+    float length = sqrtf(dx * dx + dy * dy);
+    for (int other : chosenAt[from]) {
+        float ox = nodes[other].position.x - origin.x;
+        float oy = nodes[other].position.y - origin.y;
+        float otherLength = sqrtf(ox * ox + oy * oy);
+        if ((dx * ox + dy * oy) > kMinEdgeAngleCos * length * otherLength) return true;
+    }
+    return false;
+}
+
+bool LevelGenerator::BuildCandidate(uint64_t seed, const GeneratorParams& params, GeneratedLevel& level) {
+    CandidateScratch scratch;
+    return BuildCandidate(seed, params, level, scratch);
+}
+
+bool LevelGenerator::BuildCandidate(uint64_t seed, const GeneratorParams& params, GeneratedLevel& level,
+                                    CandidateScratch& scratch) {
+    Rng rng(seed);
+    float radius = params.nodeRadius;
+    int nodeCount = max(3, params.nodeCount);
+
+    // Jittered grid: pick distinct cells, nudge each node inside its cell
+    int cols = max(2, (int)ceilf(sqrtf(nodeCount * params.area.width / params.area.height)));
+    int rows = max(2, (nodeCount + cols - 1) / cols);
+    if (cols * rows < nodeCount + nodeCount / 3) rows++;
+    float cellW = params.area.width / cols;
+    float cellH = params.area.height / rows;
+
+    vector<int>& cells = scratch.cells;
+    cells.resize(cols * rows);
+    for (int i = 0; i < (int)cells.size(); i++) cells[i] = i;
+    for (int i = (int)cells.size() - 1; i > 0; i--) {
+        swap(cells[i], cells[rng.Range(0, i)]);
+    }
+
+    vector<Node>& nodes = scratch.nodes;
+    nodes.resize(nodeCount);
+    for (int i = 0; i < nodeCount; i++) {
+        int cell = cells[i];
+        float jx = (rng.Float01() - 0.5f) * cellW * 0.5f;
+        float jy = (rng.Float01() - 0.5f) * cellH * 0.5f;
+        nodes[i].position = {params.area.x + (cell % cols + 0.5f) * cellW + jx,
+                             params.area.y + (cell / cols + 0.5f) * cellH + jy};
+        nodes[i].id = i;
+        nodes[i].isHighlighted = false;
+    }
+    float minSpacing = radius * 2.6f;
+    for (int i = 0; i < nodeCount; i++) {
+        for (int j = i + 1; j < nodeCount; j++) {
+            if (Distance(nodes[i].position, nodes[j].position) < minSpacing) return false;
+        }
+    }
+
+    // Candidate edges: short enough to read, clear of every other node
+    float maxLength = 2.3f * max(cellW, cellH);
+    float clearance = radius * 1.25f;
+    vector<vector<int>>& candidates = scratch.candidates;
+    ClearLists(candidates, nodeCount);
+    for (int i = 0; i < nodeCount; i++) {
+        for (int j = i + 1; j < nodeCount; j++) {
+            Vec2 a = nodes[i].position;
+            Vec2 b = nodes[j].position;
+            if (Distance(a, b) > maxLength) continue;
+            bool blocked = false;
+            for (int n = 0; n < nodeCount && !blocked; n++) {
+                if (n == i || n == j) continue;
+                blocked = SegmentHitsCircle(a, b, nodes[n].position, clearance);
+            }
+            if (blocked) continue;
+            candidates[i].push_back(j);
+            candidates[j].push_back(i);
+        }
+    }
+
+    // Random walk over the candidates, never reusing a pair, leaning
+    // towards nodes it hasn't reached yet
+    int edgeTarget = max(nodeCount, params.edgeCount);
+    vector<Edge>& edges = scratch.edges;
+    vector<vector<int>>& chosenAt = scratch.chosenAt;
+    vector<char>& reached = scratch.reached;
+    vector<int>& options = scratch.options;
+    vector<int>& fresh = scratch.fresh;
+    edges.clear();
+    ClearLists(chosenAt, nodeCount);
+    reached.assign(nodeCount, 0);
+    int current = rng.Range(0, nodeCount - 1);
+    reached[current] = 1;
+    int reachedCount = 1;
+
+    while ((int)edges.size() < edgeTarget) {
+        options.clear();
+        fresh.clear();
+        for (int next : candidates[current]) {
+            if (find(chosenAt[current].begin(), chosenAt[current].end(), next) != chosenAt[current].end()) continue;
+            if (TooCloseInAngle(nodes, chosenAt, current, next)) continue;
+            if (TooCloseInAngle(nodes, chosenAt, next, current)) continue;
+            options.push_back(next);
+            if (!reached[next]) fresh.push_back(next);
+        }
+        if (options.empty()) break;
+
+        const vector<int>& picks = (!fresh.empty() && rng.Range(0, 3) != 0) ? fresh : options;
+        int next = picks[rng.Range(0, (int)picks.size() - 1)];
+        edges.push_back({current, next, 0});
+        chosenAt[current].push_back(next);
+        chosenAt[next].push_back(current);
+        if (!reached[next]) {
+            reached[next] = 1;
+            reachedCount++;
+        }
+        current = next;
+    }
+
+    if (reachedCount < max(3, nodeCount * 3 / 4)) return false;
+    if ((int)edges.size() < edgeTarget * 3 / 4) return false;
+
+    // Drop nodes the walk never reached and renumber the rest
+    vector<int>& remap = scratch.remap;
+    remap.assign(nodeCount, -1);
+    level.nodes.clear();
+    for (int i = 0; i < nodeCount; i++) {
+        if (!reached[i]) continue;
+        remap[i] = (int)level.nodes.size();
+        Node node = nodes[i];
+        node.id = remap[i];
+        level.nodes.push_back(node);
+    }
+    level.edges.clear();
+    for (const Edge& edge : edges) {
+        level.edges.push_back({remap[edge.nodeA], remap[edge.nodeB], 0});
+    }
+
+    vector<LevelIssue>& issues = scratch.issues;
+    issues.clear();
+    CheckLevelGeometry(level.nodes, level.edges, radius, issues);
+    if (!issues.empty()) return false;
+
+    GraphIndex& graph = scratch.graph;
+    graph.Build((int)level.nodes.size(), level.edges);
+    if (scratch.solver.Validate(graph) != SOLVE_OK) return false;
+
+    // Exact rating when the level is small enough to search quickly,
+    // otherwise sample it
+    TrailStats stats;
+    if (graph.EdgeCount() <= 16 && scratch.counter.Count(graph, stats, 4000)) {
+        level.rating = TrailDifficulty(stats);
+    } else {
+        level.rating = RateLevel(graph, MixSeed(seed, 1), 64, scratch);
+    }
+    level.seed = seed;
+    return true;
+}
+
+float LevelGenerator::RateLevel(const GraphIndex& graph, uint64_t seed, int trials) {
+    CandidateScratch scratch;
+    return RateLevel(graph, seed, trials, scratch);
+}
+
+float LevelGenerator::RateLevel(const GraphIndex& graph, uint64_t seed, int trials, CandidateScratch& scratch) {
+    int nodeCount = graph.NodeCount();
+    int edgeCount = graph.EdgeCount();
+    if (edgeCount == 0 || trials <= 0) return 0.0f;
+
+    vector<int>& starts = scratch.starts;
+    starts.clear();
+    for (int n = 0; n < nodeCount; n++) {
+        if (graph.Degree(n) % 2 == 1) starts.push_back(n);
+    }
+    if (starts.empty()) {
+        for (int n = 0; n < nodeCount; n++) {
+            if (graph.Degree(n) > 0) starts.push_back(n);
+        }
+    }
+
+    Rng rng(seed);
+    vector<char>& used = scratch.used;
+    vector<int>& options = scratch.options;
+    used.resize(edgeCount);
+    int stuck = 0;
+    for (int trial = 0; trial < trials; trial++) {
+        fill(used.begin(), used.end(), 0);
+        int current = starts[rng.Range(0, (int)starts.size() - 1)];
+        int traced = 0;
+        while (true) {
+            options.clear();
+            for (const HalfEdge* he = graph.NeighborsBegin(current); he != graph.NeighborsEnd(current); ++he) {
+                if (!used[he->edge]) options.push_back(he->edge);
+            }
+            if (options.empty()) break;
+            int edge = options[rng.Range(0, (int)options.size() - 1)];
+            used[edge] = 1;
+            current = graph.OtherNode(edge, current);
+            traced++;
+        }
+        if (traced < edgeCount) stuck++;
+    }
+    return (float)stuck / (float)trials;
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "euler_solver.h"
+#include "graph_index.h"
+#include "level.h"
+#include "level_checks.h"
+#include "thread_pool.h"
+#include "trail_counter.h"
+#include "types.h"
+
+#include <cstdint>
+#include <vector>
+
+struct GeneratorParams {
+    float difficulty;   // target rating, 0 (any stroke works) .. 1 (most strokes dead-end)
+    int nodeCount;      // nodes to place; a candidate may use a few less
+    int edgeCount;      // edges to aim for
+    Rect area;          // playfield the node centres must stay inside
+    float nodeRadius;
+    int candidates;     // candidates built per Generate call; the closest rating wins
+};
+
+// Defaults for the game's playfield, scaled by a difficulty in [0, 1]
+GeneratorParams MakeGeneratorParams(float difficulty, float nodeRadius);
+
+struct GeneratedLevel {
+    std::vector<Node> nodes;
+    std::vector<Edge> edges;
+    float rating;       // estimated difficulty, same scale as GeneratorParams::difficulty
+    uint64_t seed;      // candidate seed; BuildCandidate(seed, params) reproduces the level
+};
+
+// Working space for building and rating candidates. Reusing one keeps
+// the next candidate from allocating all of it again.
+struct CandidateScratch {
+    std::vector<int> cells;
+    std::vector<Node> nodes;
+    std::vector<std::vector<int>> candidates;   // by node; only the first nodeCount are in use
+    std::vector<Edge> edges;
+    std::vector<std::vector<int>> chosenAt;
+    std::vector<char> reached;
+    std::vector<int> options;
+    std::vector<int> fresh;
+    std::vector<int> remap;
+    std::vector<LevelIssue> issues;
+    GraphIndex graph;
+    EulerSolver solver;
+    TrailCounter counter;
+    std::vector<int> starts;
+    std::vector<char> used;
+};
+
+// Procedural levels that are solvable by construction. A candidate is built
+// by placing nodes on a jittered grid and then taking a random walk over the
+// edges that pass the layout rules (no edge through another node's circle,
+// no edges running along each other). The walk itself is the solution, so
+// the graph is connected with 0 or 2 odd nodes; the solver re-checks it
+// anyway. Candidates are built in parallel and the one whose rating is
+// closest to the target is kept. The result depends only on the seed, not
+// on the thread count.
+class LevelGenerator {
+public:
+    explicit LevelGenerator(ThreadPool& pool);
+
+    bool Generate(uint64_t seed, const GeneratorParams& params, GeneratedLevel& level);
+
+    // Build and rate one candidate; false if the walk got stuck too early.
+    // Safe to call from several threads at once, each with its own scratch.
+    static bool BuildCandidate(uint64_t seed, const GeneratorParams& params, GeneratedLevel& level);
+    static bool BuildCandidate(uint64_t seed, const GeneratorParams& params, GeneratedLevel& level,
+                               CandidateScratch& scratch);
+
+    // Share of random strokes from a valid start that get stuck before
+    // covering every edge, sampled. Candidates small enough to search are
+    // rated exactly by TrailCounter instead, on the same scale.
+    static float RateLevel(const GraphIndex& graph, uint64_t seed, int trials);
+    static float RateLevel(const GraphIndex& graph, uint64_t seed, int trials, CandidateScratch& scratch);
+
+    // Candidates built over this generator's lifetime, for throughput stats
+    long long CandidatesBuilt() const { return candidatesBuilt; }
+
+private:
+    static constexpr int kCandidateGrain = 4;   // candidates per pool task
+
+    ThreadPool& pool;
+    std::vector<GeneratedLevel> results;
+    std::vector<char> built;
+    std::vector<CandidateScratch> scratch;   // one per pool task
+    long long candidatesBuilt;
+};
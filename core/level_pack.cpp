@@ -0,0 +1,335 @@
+#include "level_pack.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+static const size_t kHeaderSize = 36;
+static const uint16_t kWideRecord = 0xFFFF;
+static const uint16_t kUnrated = 0xFFFF;
+
+static uint16_t ReadU16(const uint8_t* p) {
+    return (uint16_t)(p[0] | p[1] << 8);
+}
+
+static uint32_t ReadU32(const uint8_t* p) {
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static uint64_t ReadU64(const uint8_t* p) {
+    return (uint64_t)ReadU32(p) | (uint64_t)ReadU32(p + 4) << 32;
+}
+
+static float ReadF32(const uint8_t* p) {
+    uint32_t bits = ReadU32(p);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static void WriteU16(vector<uint8_t>& out, uint16_t value) {
+    out.push_back((uint8_t)value);
+    out.push_back((uint8_t)(value >> 8));
+}
+
+static void WriteU32(vector<uint8_t>& out, uint32_t value) {
+    for (int i = 0; i < 4; i++) out.push_back((uint8_t)(value >> (i * 8)));
+}
+
+static void WriteU64(vector<uint8_t>& out, uint64_t value) {
+    WriteU32(out, (uint32_t)value);
+    WriteU32(out, (uint32_t)(value >> 32));
+}
+
+static void WriteF32(vector<uint8_t>& out, float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    WriteU32(out, bits);
+}
+
+static uint16_t Quantize(float value, float origin, float extent) {
+    float t = extent > 0.0f ? (value - origin) / extent : 0.0f;
+    t = min(1.0f, max(0.0f, t));
+    return (uint16_t)lroundf(t * 65535.0f);
+}
+
+LevelPack::LevelPack() : data(nullptr), size(0), levelCount(0), tableOffset(0), bounds{0, 0, 0, 0} {
+#ifdef _WIN32
+    fileHandle = nullptr;
+    mappingHandle = nullptr;
+#endif
+}
+
+LevelPack::~LevelPack() {
+    Close();
+}
+
+bool LevelPack::Open(const char* path) {
+    Close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart < (LONGLONG)kHeaderSize) {
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        return false;
+    }
+    const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    fileHandle = file;
+    mappingHandle = mapping;
+    data = (const uint8_t*)view;
+    size = (size_t)fileSize.QuadPart;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < (off_t)kHeaderSize) {
+        close(fd);
+        return false;
+    }
+    void* view = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping keeps the file alive on its own
+    close(fd);
+    if (view == MAP_FAILED) return false;
+    data = (const uint8_t*)view;
+    size = (size_t)info.st_size;
+#endif
+
+    if (!ReadHeader()) {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void LevelPack::Close() {
+    if (data) {
+#ifdef _WIN32
+        UnmapViewOfFile(data);
+        CloseHandle((HANDLE)mappingHandle);
+        CloseHandle((HANDLE)fileHandle);
+        mappingHandle = nullptr;
+        fileHandle = nullptr;
+#else
+        munmap((void*)data, size);
+#endif
+    }
+    data = nullptr;
+    size = 0;
+    levelCount = 0;
+    tableOffset = 0;
+}
+
+void LevelPack::Swap(LevelPack& other) {
+    swap(data, other.data);
+    swap(size, other.size);
+    swap(levelCount, other.levelCount);
+    swap(tableOffset, other.tableOffset);
+    swap(bounds, other.bounds);
+#ifdef _WIN32
+    swap(fileHandle, other.fileHandle);
+    swap(mappingHandle, other.mappingHandle);
+#endif
+}
+
+bool LevelPack::ReadHeader() {
+    if (memcmp(data, "SXPK", 4) != 0) return false;
+    if (ReadU16(data + 4) != kLevelPackVersion) return false;
+
+    uint32_t count = ReadU32(data + 8);
+    tableOffset = ReadU64(data + 12);
+    bounds = {ReadF32(data + 20), ReadF32(data + 24), ReadF32(data + 28), ReadF32(data + 32)};
+
+    if (count > 0x7FFFFFFF || tableOffset < kHeaderSize || tableOffset > size) return false;
+    if ((size - tableOffset) / 8 < (uint64_t)count) return false;
+    levelCount = (int)count;
+    return true;
+}
+
+// Start of a level's record, or null if its offset is out of bounds. The
+// fixed part of the record (6 bytes) is known to be readable.
+const uint8_t* LevelPack::Record(int index) const {
+    if (!data || index < 0 || index >= levelCount) return nullptr;
+    uint64_t begin = ReadU64(data + tableOffset + (uint64_t)index * 8);
+    if (begin < kHeaderSize || begin > tableOffset || tableOffset - begin < 6) return nullptr;
+    return data + begin;
+}
+
+float LevelPack::LevelDifficulty(int index) const {
+    const uint8_t* p = Record(index);
+    if (!p) return -1.0f;
+    uint16_t difficulty = ReadU16(p);
+    return difficulty == kUnrated ? -1.0f : difficulty / 65534.0f;
+}
+
+uint64_t LevelPack::ContentHash() const {
+    if (!data) return 0;
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ data[i]) * 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+bool LevelPack::DecodeLevel(int index, vector<Node>& nodes, vector<Edge>& edges) const {
+    const uint8_t* p = Record(index);
+    if (!p) return false;
+
+    // Records may not run into the offset table
+    const uint8_t* limit = data + tableOffset;
+    uint32_t nodeCount = ReadU16(p + 2);
+    uint32_t edgeCount = ReadU16(p + 4);
+    bool wide = nodeCount == kWideRecord;
+    p += 6;
+    if (wide) {
+        if (limit - p < 8) return false;
+        nodeCount = ReadU32(p);
+        edgeCount = ReadU32(p + 4);
+        p += 8;
+    }
+
+    uint64_t indexSize = wide ? 4 : 2;
+    uint64_t needed = (uint64_t)nodeCount * 4 + (uint64_t)edgeCount * indexSize * 2;
+    if ((uint64_t)(limit - p) < needed) return false;
+
+    float scaleX = bounds.width / 65535.0f;
+    float scaleY = bounds.height / 65535.0f;
+    nodes.resize(nodeCount);
+    for (uint32_t i = 0; i < nodeCount; i++, p += 4) {
+        nodes[i].position = {bounds.x + ReadU16(p) * scaleX, bounds.y + ReadU16(p + 2) * scaleY};
+        nodes[i].id = (int)i;
+        nodes[i].isHighlighted = false;
+    }
+
+    edges.resize(edgeCount);
+    for (uint32_t i = 0; i < edgeCount; i++) {
+        uint32_t a = wide ? ReadU32(p) : ReadU16(p);
+        uint32_t b = wide ? ReadU32(p + 4) : ReadU16(p + 2);
+        p += indexSize * 2;
+        if (a >= nodeCount || b >= nodeCount) return false;
+        edges[i] = {(int)a, (int)b, 0};
+    }
+    return true;
+}
+
+LevelPackWriter::LevelPackWriter() : file(nullptr), bounds{0, 0, 0, 0}, position(0) {
+}
+
+LevelPackWriter::~LevelPackWriter() {
+    if (file) fclose(file);
+}
+
+bool LevelPackWriter::Begin(const char* path, Rect packBounds) {
+    if (file) fclose(file);
+    file = fopen(path, "wb");
+    if (!file) return false;
+
+    bounds = packBounds;
+    offsets.clear();
+    difficulties.clear();
+
+    // Placeholder header; Finish() rewrites it once the table is placed
+    uint8_t header[kHeaderSize] = {};
+    position = fwrite(header, 1, kHeaderSize, file);
+    return position == kHeaderSize;
+}
+
+bool LevelPackWriter::AddLevel(const vector<Node>& nodes, const vector<Edge>& edges, float difficulty) {
+    if (!file) return false;
+
+    uint16_t storedDifficulty = kUnrated;
+    if (difficulty >= 0.0f) {
+        storedDifficulty = (uint16_t)lroundf(min(1.0f, difficulty) * 65534.0f);
+    }
+
+    bool wide = nodes.size() >= kWideRecord || edges.size() > 0xFFFF;
+    record.clear();
+    WriteU16(record, storedDifficulty);
+    if (wide) {
+        WriteU16(record, kWideRecord);
+        WriteU16(record, 0);
+        WriteU32(record, (uint32_t)nodes.size());
+        WriteU32(record, (uint32_t)edges.size());
+    } else {
+        WriteU16(record, (uint16_t)nodes.size());
+        WriteU16(record, (uint16_t)edges.size());
+    }
+    for (const Node& node : nodes) {
+        WriteU16(record, Quantize(node.position.x, bounds.x, bounds.width));
+        WriteU16(record, Quantize(node.position.y, bounds.y, bounds.height));
+    }
+    for (const Edge& edge : edges) {
+        if (wide) {
+            WriteU32(record, (uint32_t)edge.nodeA);
+            WriteU32(record, (uint32_t)edge.nodeB);
+        } else {
+            WriteU16(record, (uint16_t)edge.nodeA);
+            WriteU16(record, (uint16_t)edge.nodeB);
+        }
+    }
+
+    offsets.push_back(position);
+    difficulties.push_back(storedDifficulty);
+    if (fwrite(record.data(), 1, record.size(), file) != record.size()) return false;
+    position += record.size();
+    return true;
+}
+
+bool LevelPackWriter::Finish(bool sortByDifficulty) {
+    if (!file) return false;
+
+    // Unrated is 0xFFFF, so it sorts last on its own
+    vector<int> order(offsets.size());
+    for (size_t i = 0; i < order.size(); i++) order[i] = (int)i;
+    if (sortByDifficulty) {
+        stable_sort(order.begin(), order.end(), [this](int a, int b) {
+            return difficulties[a] < difficulties[b];
+        });
+    }
+
+    record.clear();
+    for (int index : order) WriteU64(record, offsets[index]);
+    bool ok = fwrite(record.data(), 1, record.size(), file) == record.size();
+
+    record.clear();
+    record.insert(record.end(), {'S', 'X', 'P', 'K'});
+    WriteU16(record, kLevelPackVersion);
+    WriteU16(record, 0);
+    WriteU32(record, (uint32_t)offsets.size());
+    WriteU64(record, position);
+    WriteF32(record, bounds.x);
+    WriteF32(record, bounds.y);
+    WriteF32(record, bounds.width);
+    WriteF32(record, bounds.height);
+    ok = ok && fseek(file, 0, SEEK_SET) == 0;
+    ok = ok && fwrite(record.data(), 1, record.size(), file) == record.size();
+
+    ok = (fclose(file) == 0) && ok;
+    file = nullptr;
+    return ok;
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "level.h"
+#include "types.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+// Binary level pack (.sxpk), little-endian:
+//
+//   header   "SXPK", u16 version, u16 reserved, u32 levelCount,
+//            u64 tableOffset, f32 bounds x/y/width/height
+//   levels   one record per level, back to back
+//   table    u64 file offset of every level's record, in level order
+//
+// A record is u16 difficulty, u16 nodeCount, u16 edgeCount, then nodeCount
+// u16 x/y pairs and edgeCount u16 index pairs. Levels that don't fit 16-bit
+// counts store nodeCount 0xFFFF followed by u32 nodeCount, u32 edgeCount and
+// u32 indices. Positions are quantized to 16 bits across the header bounds,
+// which for the 1880x1060 playfield is a step of about 0.03 px. Difficulty
+// is 0..65534 for 0..1, or 0xFFFF when the level hasn't been rated.
+//
+// Records are self-delimiting and the table only holds start offsets, so
+// reordering a pack only rewrites the table.
+
+const uint16_t kLevelPackVersion = 2;
+
+// Read-only view of a pack file, memory-mapped so opening costs the same
+// for 10 levels or a million: nothing is read until a level is decoded.
+class LevelPack {
+public:
+    LevelPack();
+    ~LevelPack();
+
+    LevelPack(const LevelPack&) = delete;
+    LevelPack& operator=(const LevelPack&) = delete;
+
+    bool Open(const char* path);
+    void Close();
+    // Exchange the open files, so a pack opened on another thread can be
+    // handed over in one step
+    void Swap(LevelPack& other);
+    bool IsOpen() const { return data != nullptr; }
+
+    int LevelCount() const { return levelCount; }
+    Rect Bounds() const { return bounds; }
+
+    // Decode level `index` (0-based) into the given vectors, reusing their
+    // capacity. False if the index is out of range or the record is corrupt.
+    bool DecodeLevel(int index, std::vector<Node>& nodes, std::vector<Edge>& edges) const;
+
+    // Stored difficulty in [0, 1], or -1 if the level is unrated
+    float LevelDifficulty(int index) const;
+
+    // FNV-1a over the whole file, to tell whether two packs hold the same
+    // levels. Reads every byte, so call it once, not per frame.
+    uint64_t ContentHash() const;
+
+private:
+    bool ReadHeader();
+    const uint8_t* Record(int index) const;
+
+    const uint8_t* data;
+    size_t size;
+    int levelCount;
+    uint64_t tableOffset;
+    Rect bounds;
+
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#endif
+};
+
+// Streams levels into a pack file; the offset table goes at the end, so
+// memory use is 10 bytes per level no matter how big the pack gets.
+class LevelPackWriter {
+public:
+    LevelPackWriter();
+    ~LevelPackWriter();
+
+    LevelPackWriter(const LevelPackWriter&) = delete;
+    LevelPackWriter& operator=(const LevelPackWriter&) = delete;
+
+    // Positions outside `bounds` are clamped to its edges
+    bool Begin(const char* path, Rect bounds = Rect{0, 0, 1880, 1060});
+    // `difficulty` in [0, 1], or negative to leave the level unrated
+    bool AddLevel(const std::vector<Node>& nodes, const std::vector<Edge>& edges, float difficulty = -1.0f);
+    // With sortByDifficulty the table lists levels easiest first (stable,
+    // unrated levels last); the records themselves stay where they are
+    bool Finish(bool sortByDifficulty = false);
+
+    int LevelCount() const { return (int)offsets.size(); }
+
+private:
+    FILE* file;
+    Rect bounds;
+    uint64_t position;
+    std::vector<uint64_t> offsets;
+    std::vector<uint16_t> difficulties;
+    std::vector<uint8_t> record;
+};
@@ -0,0 +1,138 @@
+#include "particle_pool.h"
+
+#include "profiler.h"
+
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define STROKEX_PARTICLES_SSE2 1
+#endif
+
+using namespace std;
+
+static const Rgba PARTICLE_COLORS[4] = {
+    {255, 0, 255, 255},
+    {138, 43, 226, 255},
+    {0, 255, 255, 255},
+    {255, 100, 255, 255}
+};
+
+ParticlePool::ParticlePool(int capacity, uint64_t seed) : rng(seed) {
+    // Round up so the SIMD loop never needs a scalar tail
+    this->capacity = (capacity + 3) & ~3;
+    count = 0;
+    rateBudget = 0.0f;
+
+    posX.resize(this->capacity);
+    posY.resize(this->capacity);
+    prevX.resize(this->capacity);
+    prevY.resize(this->capacity);
+    velX.resize(this->capacity);
+    velY.resize(this->capacity);
+    life.resize(this->capacity);
+    invMaxLife.resize(this->capacity);
+    size.resize(this->capacity);
+    color.resize(this->capacity);
+
+    directions.resize(256);
+    for (int i = 0; i < 256; i++) {
+        float angle = (float)i * (6.2831853f / 256.0f);
+        directions[i] = {cosf(angle), sinf(angle)};
+    }
+}
+
+void ParticlePool::Emit(Vec2 position) {
+    int burst = emission.particlesPerBurst;
+    if (emission.maxParticlesPerSecond > 0) {
+        burst = min(burst, (int)rateBudget);
+        rateBudget -= (float)burst;
+    }
+
+    for (int n = 0; n < burst && count < capacity; n++) {
+        // One 32-bit draw feeds every random attribute:
+        // angle 8 bits, speed 8, lifetime 8, size 6, colour 2
+        uint32_t bits = rng.NextU32();
+        Vec2 dir = directions[bits & 0xff];
+        float speed = emission.minSpeed + (emission.maxSpeed - emission.minSpeed) * (float)((bits >> 8) & 0xff) / 255.0f;
+        float lifetime = emission.minLifetime + (emission.maxLifetime - emission.minLifetime) * (float)((bits >> 16) & 0xff) / 255.0f;
+
+        int i = count++;
+        posX[i] = position.x;
+        posY[i] = position.y;
+        prevX[i] = position.x;
+        prevY[i] = position.y;
+        velX[i] = dir.x * speed;
+        velY[i] = dir.y * speed;
+        life[i] = lifetime;
+        invMaxLife[i] = 1.0f / lifetime;
+        size[i] = emission.minSize + (emission.maxSize - emission.minSize) * (float)((bits >> 24) & 0x3f) / 63.0f;
+        color[i] = PARTICLE_COLORS[bits >> 30];
+    }
+}
+
+void ParticlePool::Kill(int i) {
+    int last = --count;
+    posX[i] = posX[last];
+    posY[i] = posY[last];
+    prevX[i] = prevX[last];
+    prevY[i] = prevY[last];
+    velX[i] = velX[last];
+    velY[i] = velY[last];
+    life[i] = life[last];
+    invMaxLife[i] = invMaxLife[last];
+    size[i] = size[last];
+    color[i] = color[last];
+}
+
+void ParticlePool::Update(float deltaTime) {
+    PROFILE_ZONE("Particles");
+    if (emission.maxParticlesPerSecond > 0) {
+        rateBudget = min(rateBudget + emission.maxParticlesPerSecond * deltaTime,
+                         (float)max(emission.particlesPerBurst, 1) + emission.maxParticlesPerSecond * 0.1f);
+    }
+
+    // Integrate every slot up to count rounded to 4; the extra lanes are
+    // spare capacity and their values are never read
+    int padded = (count + 3) & ~3;
+    int i = 0;
+    // Velocity keeps 95% per 60 Hz frame, whatever the step
+    float decay = powf(0.95f, deltaTime * 60.0f);
+
+#ifdef STROKEX_PARTICLES_SSE2
+    __m128 dt = _mm_set1_ps(deltaTime);
+    __m128 damping = _mm_set1_ps(decay);
+    for (; i < padded; i += 4) {
+        __m128 px = _mm_loadu_ps(&posX[i]);
+        __m128 py = _mm_loadu_ps(&posY[i]);
+        __m128 vx = _mm_loadu_ps(&velX[i]);
+        __m128 vy = _mm_loadu_ps(&velY[i]);
+        _mm_storeu_ps(&prevX[i], px);
+        _mm_storeu_ps(&prevY[i], py);
+        _mm_storeu_ps(&posX[i], _mm_add_ps(px, _mm_mul_ps(vx, dt)));
+        _mm_storeu_ps(&posY[i], _mm_add_ps(py, _mm_mul_ps(vy, dt)));
+        _mm_storeu_ps(&velX[i], _mm_mul_ps(vx, damping));
+        _mm_storeu_ps(&velY[i], _mm_mul_ps(vy, damping));
+        _mm_storeu_ps(&life[i], _mm_sub_ps(_mm_loadu_ps(&life[i]), dt));
+    }
+#endif
+
+    for (; i < padded; i++) {
+        prevX[i] = posX[i];
+        prevY[i] = posY[i];
+        posX[i] += velX[i] * deltaTime;
+        posY[i] += velY[i] * deltaTime;
+        velX[i] *= decay;
+        velY[i] *= decay;
+        life[i] -= deltaTime;
+    }
+
+    // Swap-remove dead particles; re-check the slot that was filled
+    for (int j = 0; j < count;) {
+        if (life[j] <= 0) {
+            Kill(j);
+        } else {
+            j++;
+        }
+    }
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "rng.h"
+#include "types.h"
+
+#include <vector>
+
+// How particles are emitted while the player drags
+struct ParticleEmission {
+    int particlesPerBurst = 3;
+    float spawnDistance = 10.0f;       // cursor travel between bursts, pixels
+    float maxParticlesPerSecond = 0;   // 0 = unlimited
+    float minSpeed = 20.0f;
+    float maxSpeed = 60.0f;
+    float minLifetime = 0.3f;
+    float maxLifetime = 0.8f;
+    float minSize = 3.0f;
+    float maxSize = 7.0f;
+};
+
+// Fixed-capacity particle storage in structure-of-arrays form. Update runs
+// one SIMD pass over all live particles and then compacts dead ones with
+// swap-remove, so nothing is allocated or shifted after construction.
+// Particle order is not stable. Positions before the last Update are kept
+// so the renderer can interpolate between steps.
+class ParticlePool {
+public:
+    ParticlePool(int capacity, uint64_t seed);
+
+    void SetEmission(const ParticleEmission& settings) { emission = settings; }
+    const ParticleEmission& GetEmission() const { return emission; }
+
+    // Emit one burst at position; silently drops particles when full or
+    // when the rate limit has no budget left
+    void Emit(Vec2 position);
+    void Update(float deltaTime);
+    void Clear() { count = 0; }
+
+    int Count() const { return count; }
+    int Capacity() const { return capacity; }
+
+    const float* PositionsX() const { return posX.data(); }
+    const float* PositionsY() const { return posY.data(); }
+    const float* PreviousPositionsX() const { return prevX.data(); }
+    const float* PreviousPositionsY() const { return prevY.data(); }
+    const float* Sizes() const { return size.data(); }
+    const Rgba* Colors() const { return color.data(); }
+    // Alpha of particle i as 0..255, fading out over its lifetime
+    float Alpha(int i) const { return life[i] * invMaxLife[i] * 255.0f; }
+
+private:
+    void Kill(int i);
+
+    int capacity;
+    int count;
+    ParticleEmission emission;
+    float rateBudget;
+    Rng rng;
+
+    std::vector<float> posX;
+    std::vector<float> posY;
+    std::vector<float> prevX;
+    std::vector<float> prevY;
+    std::vector<float> velX;
+    std::vector<float> velY;
+    std::vector<float> life;
+    std::vector<float> invMaxLife;
+    std::vector<float> size;
+    std::vector<Rgba> color;
+    std::vector<Vec2> directions;   // unit vectors for 256 angles
+};
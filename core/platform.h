@@ -0,0 +1,88 @@
+#pragma once
+
+#include "types.h"
+
+// Everything the simulation needs from the outside world. The windowed game
+// implements these on top of raylib; the headless runner implements them with
+// a virtual clock and scripted input so the game loop can run without a
+// display or GL context.
+
+// One cursor reading taken between frames by a high-rate input path
+struct InputSample {
+    double time;   // on the Clock's timeline; negative if the source can't tell
+    Vec2 pos;
+    bool down;
+};
+
+// Mouse state for one simulation step
+struct FrameInput {
+    // Readings a source should hand over per frame at most; the core keeps
+    // room for this many
+    static constexpr int kMaxSamples = 256;
+
+    Vec2 mousePos;
+    bool mouseDown;
+    bool mousePressed;
+    bool mouseReleased;
+    bool autoSolvePressed;
+    // Days since the Unix epoch of a daily puzzle to open, or -1
+    int dailyRequest = -1;
+    // Wheel notches this frame, positive to zoom in around the cursor
+    float wheel = 0.0f;
+    // Held to drag the board with the cursor (right or middle button)
+    bool panDown = false;
+    // Cursor readings since the previous Poll, oldest first. Owned by the
+    // InputSource and valid until its next Poll. Sources that only sample
+    // once a frame leave this empty and the core uses mousePos.
+    const InputSample* samples = nullptr;
+    int sampleCount = 0;
+};
+
+class InputSource {
+public:
+    virtual ~InputSource() = default;
+    virtual FrameInput Poll() = 0;
+};
+
+class Clock {
+public:
+    virtual ~Clock() = default;
+    // Seconds since the clock started
+    virtual double Now() = 0;
+    // Duration of the last frame in seconds
+    virtual float FrameDelta() = 0;
+};
+
+// Virtual clock that advances by a fixed step each frame. Used headless so
+// simulated time is independent of how fast the host runs the loop.
+class FixedStepClock : public Clock {
+public:
+    explicit FixedStepClock(float step) : step(step), now(0.0) {}
+
+    void Advance() { now += step; }
+
+    double Now() override { return now; }
+    float FrameDelta() override { return step; }
+
+private:
+    float step;
+    double now;
+};
+
+// Clock that holds one frame's time, set from outside before each Update.
+// The core reads the same values however often it asks within a frame,
+// which is what lets a recording replay bit for bit.
+class FrameClock : public Clock {
+public:
+    void SetFrame(double frameNow, float frameDelta) {
+        now = frameNow;
+        delta = frameDelta;
+    }
+
+    double Now() override { return now; }
+    float FrameDelta() override { return delta; }
+
+private:
+    double now = 0.0;
+    float delta = 0.0f;
+};
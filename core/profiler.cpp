@@ -0,0 +1,163 @@
+#include "profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+using namespace std;
+
+static const char kFrameZone[] = "Frame";
+
+Profiler& Profiler::Get() {
+    static Profiler profiler;
+    return profiler;
+}
+
+int64_t Profiler::Now() {
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+Profiler::Profiler() : origin(Now()) {
+    fill(frameMs, frameMs + kFrameHistory, 0.0f);
+    percentileScratch.reserve(kFrameHistory);
+}
+
+// First use on a thread registers its ring; after that recording is a few
+// plain stores bracketed by the slot's sequence number
+Profiler::ThreadBuffer& Profiler::LocalBuffer() {
+    thread_local ThreadBuffer* local = nullptr;
+    if (!local) {
+        unique_ptr<ThreadBuffer> buffer(new ThreadBuffer());
+        buffer->events.reset(new EventSlot[kEventCapacity]());
+        lock_guard<mutex> lock(threadsMutex);
+        buffer->id = (int)threads.size();
+        local = buffer.get();
+        threads.push_back(move(buffer));
+    }
+    return *local;
+}
+
+void Profiler::Record(const char* name, int64_t start, int64_t end) {
+    ThreadBuffer& buffer = LocalBuffer();
+    uint64_t index = buffer.written.load(memory_order_relaxed);
+    EventSlot& slot = buffer.events[index & (kEventCapacity - 1)];
+    slot.sequence.store(index * 2 + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    slot.name.store(name, memory_order_relaxed);
+    slot.start.store(start, memory_order_relaxed);
+    slot.end.store(end, memory_order_relaxed);
+    slot.sequence.store(index * 2 + 2, memory_order_release);
+    buffer.written.store(index + 1, memory_order_release);
+}
+
+bool Profiler::ReadEvent(const ThreadBuffer& buffer, uint64_t index, ProfileEvent& event) {
+    const EventSlot& slot = buffer.events[index & (kEventCapacity - 1)];
+    if (slot.sequence.load(memory_order_acquire) != index * 2 + 2) return false;
+    event.name = slot.name.load(memory_order_relaxed);
+    event.start = slot.start.load(memory_order_relaxed);
+    event.end = slot.end.load(memory_order_relaxed);
+    atomic_thread_fence(memory_order_acquire);
+    return slot.sequence.load(memory_order_relaxed) == index * 2 + 2;
+}
+
+void Profiler::EndFrame() {
+    int64_t now = Now();
+    if (frameBegin >= 0) {
+        Record(kFrameZone, frameBegin, now);
+        frameMs[framesEnded % kFrameHistory] = (float)((now - frameBegin) / 1e6);
+        framesEnded++;
+        frameThread = LocalBuffer().id;
+        lastFrameZones.clear();
+        {
+            lock_guard<mutex> lock(threadsMutex);
+            for (const unique_ptr<ThreadBuffer>& buffer : threads) CollectZones(*buffer, frameBegin);
+        }
+        sort(lastFrameZones.begin(), lastFrameZones.end(),
+             [](const ZoneTiming& a, const ZoneTiming& b) { return a.ms > b.ms; });
+    }
+    frameBegin = now;
+}
+
+// Add one thread's zones that ended inside the frame, newest first, until
+// the ring runs out or reaches the previous frame. Zones end in order on
+// any one thread. A thread still recording can lap the reader and rewrite
+// the oldest slots; those are gone, so a busy frame may miss a few.
+void Profiler::CollectZones(const ThreadBuffer& buffer, int64_t begin) {
+    uint64_t written = buffer.written.load(memory_order_acquire);
+    uint64_t oldest = written > (uint64_t)kEventCapacity ? written - kEventCapacity : 0;
+    ProfileEvent event;
+    for (uint64_t i = written; i-- > oldest;) {
+        if (!ReadEvent(buffer, i, event)) break;
+        if (event.end < begin) break;
+        if (event.name == kFrameZone) continue;
+        AddZone(event.name, (float)((event.end - event.start) / 1e6));
+    }
+}
+
+void Profiler::AddZone(const char* name, float ms) {
+    for (ZoneTiming& zone : lastFrameZones) {
+        if (zone.name == name || strcmp(zone.name, name) == 0) {
+            zone.ms += ms;
+            zone.calls++;
+            return;
+        }
+    }
+    lastFrameZones.push_back({name, ms, 1});
+}
+
+int Profiler::FrameCount() const {
+    return (int)min<long long>(framesEnded, kFrameHistory);
+}
+
+float Profiler::FrameTime(int age) const {
+    if (age < 0 || age >= FrameCount()) return 0.0f;
+    return frameMs[(framesEnded - 1 - age) % kFrameHistory];
+}
+
+float Profiler::FramePercentile(float fraction) {
+    int count = FrameCount();
+    if (count == 0) return 0.0f;
+    percentileScratch.assign(frameMs, frameMs + count);
+    int rank = min(count - 1, max(0, (int)(fraction * count)));
+    nth_element(percentileScratch.begin(), percentileScratch.begin() + rank, percentileScratch.end());
+    return percentileScratch[rank];
+}
+
+void Profiler::FrameHistogram(int* buckets, int bucketCount, float maxMs) const {
+    fill(buckets, buckets + bucketCount, 0);
+    if (bucketCount <= 0 || maxMs <= 0.0f) return;
+    int count = FrameCount();
+    for (int i = 0; i < count; i++) {
+        int bucket = (int)(frameMs[i] / maxMs * bucketCount);
+        buckets[min(bucketCount - 1, max(0, bucket))]++;
+    }
+}
+
+// Complete ("X") events, one track per thread. A thread still recording
+// may rewrite its oldest slots while they are written out; a profile taken
+// mid-game skips those.
+bool Profiler::WriteChromeTrace(const char* path) const {
+    FILE* file = fopen(path, "w");
+    if (!file) return false;
+
+    fprintf(file, "{\"traceEvents\":[\n");
+    bool first = true;
+    lock_guard<mutex> lock(threadsMutex);
+    for (const unique_ptr<ThreadBuffer>& buffer : threads) {
+        fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s %d\"}}",
+                first ? "" : ",\n", buffer->id, buffer->id == frameThread ? "main" : "thread", buffer->id);
+        first = false;
+
+        uint64_t written = buffer->written.load(memory_order_acquire);
+        uint64_t oldest = written > (uint64_t)kEventCapacity ? written - kEventCapacity : 0;
+        ProfileEvent event;
+        for (uint64_t i = oldest; i < written; i++) {
+            if (!ReadEvent(*buffer, i, event)) continue;
+            fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                    event.name, buffer->id, (event.start - origin) / 1e3, (event.end - event.start) / 1e3);
+        }
+    }
+    fprintf(file, "\n]}\n");
+    return fclose(file) == 0;
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Frame-phase profiling. Code marks regions with PROFILE_ZONE("name"), which
+// times the rest of the enclosing scope; the main loop calls
+// PROFILE_FRAME_END() once per frame. Both compile to nothing unless the
+// build defines STROKEX_PROFILING (cmake -DSTROKEX_PROFILING=ON), so a
+// normal build pays nothing for them.
+//
+// Every thread records into its own ring of the most recent zones, written
+// without locks, so worker threads show up too. Readers check each slot's
+// sequence number and skip slots rewritten under them. Zone names must be
+// string literals: only the pointer is stored.
+#ifdef STROKEX_PROFILING
+#define STROKEX_PROFILE_CONCAT2(a, b) a##b
+#define STROKEX_PROFILE_CONCAT(a, b) STROKEX_PROFILE_CONCAT2(a, b)
+#define PROFILE_ZONE(name) ProfileZone STROKEX_PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define PROFILE_FRAME_END() Profiler::Get().EndFrame()
+#else
+#define PROFILE_ZONE(name) ((void)0)
+#define PROFILE_FRAME_END() ((void)0)
+#endif
+
+struct ProfileEvent {
+    const char* name;
+    int64_t start;   // steady clock, nanoseconds
+    int64_t end;
+};
+
+// Inclusive time spent in one zone during the last frame
+struct ZoneTiming {
+    const char* name;
+    float ms;
+    int calls;
+};
+
+class Profiler {
+public:
+#ifdef STROKEX_PROFILING
+    static constexpr bool kEnabled = true;
+#else
+    static constexpr bool kEnabled = false;
+#endif
+    static constexpr int kEventCapacity = 1 << 16;   // per thread, power of two
+    static constexpr int kFrameHistory = 512;
+
+    static Profiler& Get();
+    static int64_t Now();
+
+    void Record(const char* name, int64_t start, int64_t end);
+
+    // Close the current frame: store its duration and the totals of the
+    // zones that ended during it, on every thread, so work handed to the
+    // simulation thread or the pool shows up as well. Call from the main
+    // loop only.
+    void EndFrame();
+
+    // Frames recorded so far, capped at kFrameHistory
+    int FrameCount() const;
+    // Duration of a recent frame in ms; age 0 is the last one
+    float FrameTime(int age) const;
+    // Frame time at a fraction (0.5 = median, 0.99 = p99) of the history
+    float FramePercentile(float fraction);
+    // Count recent frames into `bucketCount` buckets over [0, maxMs); the
+    // last bucket also takes everything slower
+    void FrameHistogram(int* buckets, int bucketCount, float maxMs) const;
+    // Sorted slowest first
+    const std::vector<ZoneTiming>& LastFrameZones() const { return lastFrameZones; }
+
+    // Write every zone still in the rings as a Chrome trace
+    // (chrome://tracing or ui.perfetto.dev)
+    bool WriteChromeTrace(const char* path) const;
+
+private:
+    // A seqlock: `sequence` is 2n + 1 while write n fills the slot and
+    // 2n + 2 once it's done. The fields are atomics so a racing read is
+    // stale, never undefined.
+    struct EventSlot {
+        std::atomic<uint64_t> sequence;
+        std::atomic<const char*> name;
+        std::atomic<int64_t> start;
+        std::atomic<int64_t> end;
+    };
+
+    struct ThreadBuffer {
+        int id = 0;
+        std::unique_ptr<EventSlot[]> events;
+        std::atomic<uint64_t> written{0};
+    };
+
+    Profiler();
+    ThreadBuffer& LocalBuffer();
+    // False if write `index` is no longer (or not yet) whole in its slot
+    static bool ReadEvent(const ThreadBuffer& buffer, uint64_t index, ProfileEvent& event);
+    void CollectZones(const ThreadBuffer& buffer, int64_t frameBegin);
+    void AddZone(const char* name, float ms);
+
+    int64_t origin;
+    mutable std::mutex threadsMutex;   // recording never takes it
+    std::vector<std::unique_ptr<ThreadBuffer>> threads;
+
+    int64_t frameBegin = -1;
+    int frameThread = -1;
+    float frameMs[kFrameHistory];
+    long long framesEnded = 0;
+    std::vector<float> percentileScratch;
+    std::vector<ZoneTiming> lastFrameZones;
+};
+
+// Times its scope and records it on destruction
+class ProfileZone {
+public:
+    explicit ProfileZone(const char* name) : name(name), start(Profiler::Now()) {}
+    ~ProfileZone() { Profiler::Get().Record(name, start, Profiler::Now()); }
+
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+
+private:
+    const char* name;
+    int64_t start;
+};
@@ -0,0 +1,288 @@
+#include "progress_store.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <io.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+static const size_t kHeaderBytes = 8;
+static const size_t kRecordBytes = 16;
+// Far beyond any real pack; keeps a corrupt-but-checksummed record from
+// allocating gigabytes
+static const int kMaxLevel = 1 << 24;
+
+static uint32_t ReadU32(const uint8_t* p) {
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static void PutU32(uint8_t* p, uint32_t value) {
+    for (int i = 0; i < 4; i++) p[i] = (uint8_t)(value >> (i * 8));
+}
+
+static uint32_t Checksum(const uint8_t* p, size_t size) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= p[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static void EncodeRecord(const JournalRecord& record, uint8_t* out) {
+    PutU32(out, record.type);
+    PutU32(out + 4, (uint32_t)record.a);
+    PutU32(out + 8, (uint32_t)record.b);
+    PutU32(out + 12, Checksum(out, 12));
+}
+
+static bool DecodeRecord(const uint8_t* in, JournalRecord& record) {
+    if (Checksum(in, 12) != ReadU32(in + 12)) return false;
+    record.type = ReadU32(in);
+    record.a = (int32_t)ReadU32(in + 4);
+    record.b = (int32_t)ReadU32(in + 8);
+    return record.type == RECORD_PROGRESS || record.type == RECORD_BEST_TIME;
+}
+
+static void EncodeHeader(uint8_t* out) {
+    memcpy(out, "SXPJ", 4);
+    PutU32(out + 4, kProgressJournalVersion);
+}
+
+// Flush to the OS, then have the OS put it on the disk
+static bool SyncFile(FILE* file) {
+    if (fflush(file) != 0) return false;
+#ifdef _WIN32
+    return _commit(_fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
+}
+
+// Atomically put `from` in place of `to`
+static bool ReplaceFile(const string& from, const string& to) {
+#ifdef _WIN32
+    return MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    if (rename(from.c_str(), to.c_str()) != 0) return false;
+    // The rename lives in the directory; sync that too so it survives a
+    // power cut
+    size_t slash = to.find_last_of('/');
+    string dir = slash == string::npos ? "." : slash == 0 ? "/" : to.substr(0, slash);
+    int fd = open(dir.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        fsync(fd);
+        close(fd);
+    }
+    return true;
+#endif
+}
+
+void SavedProgress::Apply(const JournalRecord& record) {
+    if (record.type == RECORD_PROGRESS) {
+        maxUnlockedLevel = record.a;
+        totalScore = record.b;
+    } else if (record.type == RECORD_BEST_TIME && record.a >= 0 && record.a < kMaxLevel) {
+        if ((int)bestTimes.size() <= record.a) bestTimes.resize(record.a + 1, -1.0f);
+        memcpy(&bestTimes[record.a], &record.b, sizeof(float));
+    }
+}
+
+void SavedProgress::Snapshot(vector<JournalRecord>& out) const {
+    out.clear();
+    out.push_back({RECORD_PROGRESS, maxUnlockedLevel, totalScore});
+    for (int level = 0; level < (int)bestTimes.size(); level++) {
+        if (bestTimes[level] < 0.0f) continue;
+        JournalRecord record = {RECORD_BEST_TIME, level, 0};
+        memcpy(&record.b, &bestTimes[level], sizeof(float));
+        out.push_back(record);
+    }
+}
+
+ProgressStore::~ProgressStore() {
+    Close();
+}
+
+bool ProgressStore::Open(const char* filePath) {
+    Close();
+    path = filePath;
+    progress = SavedProgress();
+    droppedBytes = 0;
+    journalRecords = 0;
+    writeError = false;
+
+    auto start = chrono::steady_clock::now();
+    vector<uint8_t> bytes;
+    FILE* file = fopen(filePath, "rb");
+    if (file) {
+        if (fseek(file, 0, SEEK_END) == 0) {
+            long size = ftell(file);
+            if (size > 0 && fseek(file, 0, SEEK_SET) == 0) {
+                bytes.resize((size_t)size);
+                bytes.resize(fread(bytes.data(), 1, bytes.size(), file));
+            }
+        }
+        fclose(file);
+    }
+
+    uint8_t header[kHeaderBytes];
+    EncodeHeader(header);
+    // A header cut short by a crash during the very first compaction
+    // counts as an empty journal
+    size_t offset = min(bytes.size(), kHeaderBytes);
+    bool intact = offset == 0 || memcmp(bytes.data(), header, offset) == 0;
+    JournalRecord record;
+    while (intact && offset + kRecordBytes <= bytes.size() && DecodeRecord(&bytes[offset], record)) {
+        progress.Apply(record);
+        offset += kRecordBytes;
+        journalRecords++;
+    }
+    droppedBytes = (long long)(bytes.size() - offset);
+    loadMicros = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+
+    // Something else lives at `path`; leave it alone and keep progress in
+    // memory only
+    if (!intact) return false;
+
+    // A new file needs its header and a damaged one its tail cut off; the
+    // writer does either by starting with a compaction
+    written = progress;
+    overflow.clear();
+    needsCompact = offset < kHeaderBytes || droppedBytes > 0;
+    stopping = false;
+    writer = thread(&ProgressStore::WriterLoop, this);
+    return true;
+}
+
+void ProgressStore::Close() {
+    if (!writer.joinable()) return;
+    {
+        lock_guard<mutex> lock(stopMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    writer.join();
+    // Whatever never fit in the ring; the writer is gone, so write it here
+    if (!overflow.empty()) {
+        for (const JournalRecord& record : overflow) written.Apply(record);
+        if (!Append(overflow) && !Compact()) writeError = true;
+        overflow.clear();
+    }
+    if (journal) fclose(journal);
+    journal = nullptr;
+}
+
+void ProgressStore::SetProgress(int maxUnlockedLevel, int totalScore) {
+    if (maxUnlockedLevel == progress.maxUnlockedLevel && totalScore == progress.totalScore) return;
+    Queue({RECORD_PROGRESS, maxUnlockedLevel, totalScore});
+}
+
+void ProgressStore::RecordTime(int level, float seconds) {
+    if (level < 0 || level >= kMaxLevel || !(seconds >= 0.0f)) return;
+    float best = progress.BestTime(level);
+    if (best >= 0.0f && best <= seconds) return;
+    JournalRecord record = {RECORD_BEST_TIME, level, 0};
+    memcpy(&record.b, &seconds, sizeof(float));
+    Queue(record);
+}
+
+void ProgressStore::ReserveLevel(int level) {
+    if (level < 0 || level >= kMaxLevel || level < (int)progress.bestTimes.size()) return;
+    progress.bestTimes.resize(level + 1, -1.0f);
+}
+
+// No lock and no wakeup: the writer looks at the ring on its own schedule
+void ProgressStore::Queue(const JournalRecord& record) {
+    progress.Apply(record);
+    if (!IsOpen()) return;
+    // Keep order: a backlog goes first, and while one remains so does this
+    size_t moved = 0;
+    while (moved < overflow.size() && pending.Push(overflow[moved])) moved++;
+    overflow.erase(overflow.begin(), overflow.begin() + moved);
+    if (!overflow.empty() || !pending.Push(record)) overflow.push_back(record);
+}
+
+void ProgressStore::WriterLoop() {
+    if (needsCompact && !Compact()) writeError = true;
+
+    vector<JournalRecord> batch;
+    batch.reserve(kQueueRecords);
+    while (true) {
+        bool stop;
+        {
+            // Records pile up in between, so a burst shares one fsync
+            unique_lock<mutex> lock(stopMutex);
+            wake.wait_for(lock, chrono::milliseconds(kBatchMs), [this] { return stopping; });
+            stop = stopping;
+        }
+
+        JournalRecord next;
+        while (pending.Pop(next)) batch.push_back(next);
+        if (batch.empty()) {
+            if (stop) return;
+            continue;
+        }
+
+        for (const JournalRecord& record : batch) written.Apply(record);
+        bool ok = Append(batch) || Compact();
+        batch.clear();
+
+        // Compact once overwritten records outnumber live ones
+        long long live = 1;
+        for (float best : written.bestTimes) live += best >= 0.0f ? 1 : 0;
+        if (ok && journalRecords > kCompactRecords && journalRecords > live * 2) ok = Compact();
+        if (!ok) writeError = true;
+    }
+}
+
+bool ProgressStore::Append(const vector<JournalRecord>& records) {
+    // After a failed compaction there is no journal to append to; a new
+    // snapshot already holds these records
+    if (!journal) return Compact();
+
+    vector<uint8_t> bytes(records.size() * kRecordBytes);
+    for (size_t i = 0; i < records.size(); i++) EncodeRecord(records[i], &bytes[i * kRecordBytes]);
+    bool ok = fwrite(bytes.data(), 1, bytes.size(), journal) == bytes.size() && SyncFile(journal);
+    journalRecords += (long long)records.size();
+    if (!ok) {
+        // Part of the batch may be on disk; never append after a torn record
+        fclose(journal);
+        journal = nullptr;
+    }
+    return ok;
+}
+
+bool ProgressStore::Compact() {
+    if (journal) fclose(journal);
+    journal = nullptr;
+
+    vector<JournalRecord> records;
+    written.Snapshot(records);
+    vector<uint8_t> bytes(kHeaderBytes + records.size() * kRecordBytes);
+    EncodeHeader(bytes.data());
+    for (size_t i = 0; i < records.size(); i++) EncodeRecord(records[i], &bytes[kHeaderBytes + i * kRecordBytes]);
+
+    string temp = path + ".tmp";
+    FILE* file = fopen(temp.c_str(), "wb");
+    if (!file) return false;
+    bool ok = fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size() && SyncFile(file);
+    ok = fclose(file) == 0 && ok;
+    if (!ok || !ReplaceFile(temp, path)) {
+        remove(temp.c_str());
+        return false;
+    }
+
+    journal = fopen(path.c_str(), "ab");
+    journalRecords = (long long)records.size();
+    return journal != nullptr;
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "spsc_queue.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Journal file (.sxj), little-endian: "SXPJ", u32 version, then 16-byte
+// records of u32 type, i32 a, i32 b and a u32 FNV-1a checksum of the first
+// 12 bytes:
+//
+//   RECORD_PROGRESS    a = max unlocked level, b = total score
+//   RECORD_BEST_TIME   a = level, b = best time in seconds as f32 bits
+//
+// Later records override earlier ones. A record torn by a crash fails its
+// checksum, and loading stops at the last intact one.
+const uint32_t kProgressJournalVersion = 1;
+
+enum JournalRecordType {
+    RECORD_PROGRESS = 1,
+    RECORD_BEST_TIME = 2
+};
+
+struct JournalRecord {
+    uint32_t type;
+    int32_t a;
+    int32_t b;
+};
+
+struct SavedProgress {
+    int maxUnlockedLevel = 1;
+    int totalScore = 0;
+    std::vector<float> bestTimes;   // by level; negative when unplayed
+
+    float BestTime(int level) const {
+        return level >= 0 && level < (int)bestTimes.size() ? bestTimes[level] : -1.0f;
+    }
+    void Apply(const JournalRecord& record);
+    // The fewest records that rebuild this state
+    void Snapshot(std::vector<JournalRecord>& out) const;
+};
+
+// Player progress, kept in memory and saved through an append-only journal.
+// Setters only update memory and push a record onto a fixed ring; a writer
+// thread drains it every kBatchMs and appends the records in one batch, one
+// fsync per batch, so the frame loop never waits on the disk or a lock. Once the journal holds mostly overwritten records the
+// writer rewrites it as a snapshot into a temporary file and renames that
+// over the journal, which either happens completely or not at all.
+class ProgressStore {
+public:
+    static constexpr int kBatchMs = 50;       // wait for more records before an fsync
+    static constexpr int kCompactRecords = 256;
+    static constexpr int kQueueRecords = 1024;
+
+    ProgressStore() = default;
+    ~ProgressStore();
+
+    ProgressStore(const ProgressStore&) = delete;
+    ProgressStore& operator=(const ProgressStore&) = delete;
+
+    // Load the journal and start the writer. A missing file starts fresh;
+    // a damaged tail is dropped and the journal rewritten without it.
+    // False when the file is not a progress journal; it is left untouched
+    // and progress is only kept in memory.
+    bool Open(const char* path);
+    // Write everything queued and stop the writer
+    void Close();
+    bool IsOpen() const { return writer.joinable(); }
+
+    const SavedProgress& Progress() const { return progress; }
+    double LoadMicros() const { return loadMicros; }
+    // Bytes after the last intact record found by Open
+    long long DroppedBytes() const { return droppedBytes; }
+    bool HasWriteError() const { return writeError.load(std::memory_order_relaxed); }
+
+    // Queue a record only when something changed
+    void SetProgress(int maxUnlockedLevel, int totalScore);
+    // Keeps the faster of `seconds` and the stored best
+    void RecordTime(int level, float seconds);
+    // Make room for `level`'s best time now, so RecordTime on it later
+    // doesn't allocate; call when the level loads
+    void ReserveLevel(int level);
+
+private:
+    void Queue(const JournalRecord& record);
+    void WriterLoop();
+    bool Append(const std::vector<JournalRecord>& records);
+    bool Compact();
+
+    std::string path;
+    SavedProgress progress;          // main thread's view
+    double loadMicros = 0.0;
+    long long droppedBytes = 0;
+
+    // Records cross to the writer through `pending`. Should the writer fall
+    // a whole ring behind, the rest wait in `overflow` on the setters' side.
+    SpscQueue<JournalRecord, kQueueRecords> pending;
+    std::vector<JournalRecord> overflow;
+    std::mutex stopMutex;
+    std::condition_variable wake;
+    bool stopping = false;                // guarded by stopMutex
+    std::thread writer;
+
+    // Writer thread only, after Open
+    FILE* journal = nullptr;
+    SavedProgress written;
+    long long journalRecords = 0;
+    bool needsCompact = false;
+    std::atomic<bool> writeError{false};
+};
@@ -0,0 +1,627 @@
+#include "puzzle_core.h"
+
+#include "profiler.h"
+#include "rng.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+// Base seeds for generated levels; fixed so every player gets the same ones
+static const uint64_t kEndlessSeed = 0x51c0e7e5d1e55ULL;
+static const uint64_t kDailySeed = 0xda11ca1e5eedULL;
+// Each wheel notch zooms by this much
+static const float kWheelZoom = 1.15f;
+static const SolveResult kNoHint = {SOLVE_NO_EDGES, 0, {}, {}};
+
+PuzzleCore::PuzzleCore(Clock& clock, unsigned int seed)
+    : clock(clock), timestep(1.0 / kTickRate), seed(seed), shakeRng(MixSeed(seed, RNG_STREAM_SHAKE)),
+      particles(4096, MixSeed(seed, RNG_STREAM_PARTICLES)), generator(pool) {
+    gameState = START_SCREEN;
+    isDrawing = false;
+    levelComplete = false;
+    currentLevel = 1;
+    maxUnlockedLevel = 1;
+    dailyLevel = false;
+    dailyDay = 0;
+    nodeRadius = 39.2f;
+    levelStartTime = 0.0f;
+    levelEndTime = 0.0f;
+    currentScore = 0;
+    totalScore = 0;
+    timerRunning = false;
+    particleSpawnTimer = 0.0f;
+    lastCursor = {0, 0};
+    lastParticleSpawnPos = {0, 0};
+    showHintPopup = false;
+    hintPopupAlpha = 0.0f;
+    hintPopupFadingIn = false;
+    puzzleFailed = false;
+    shakeTimer = 0.0f;
+    shakeIntensity = 0.0f;
+    shakeOffset = {0, 0};
+    hintActive = false;
+    highlightedNode = -1;
+    levelVersion = 0;
+    pathVersion = 0;
+    highlightVersion = 0;
+    pathHash = 0;
+    pathSerial = 0;
+    requestedHintKey = 0;
+    worldSamples.reserve(FrameInput::kMaxSamples);
+    
+    startButton = {679, 471, 522, 131};
+    resetButton = {1567, 177, 261, 92};
+    nextLevelButton = {1567, 883, 261, 92};
+    prevLevelButton = {1280, 883, 261, 92};
+    hintButton = {1567, 295, 261, 92};
+    // Boards too big for the window are fitted between the HUD and the
+    // buttons
+    view.SetViewport({0, 0, 1880, 1060}, {260, 220, 1000, 740});
+    lastPanPos = {0, 0};
+    panning = false;
+    
+    SetBackground(kBackgroundDots, {0, 0, 1880, 1060});
+}
+
+void PuzzleCore::SetBackground(int dotCount, Rect bounds) {
+    background.Reset(dotCount, bounds, MixSeed(seed, RNG_STREAM_BACKGROUND));
+}
+
+int PuzzleCore::CountOddDegreeNodes() const {
+    int oddCount = 0;
+    for (int i = 0; i < graph.NodeCount(); i++) {
+        if (graph.Degree(i) % 2 == 1) oddCount++;
+    }
+    
+    return oddCount;
+}
+
+int PuzzleCore::GetFirstOddDegreeNode() const {
+    for (int i = 0; i < graph.NodeCount(); i++) {
+        if (graph.Degree(i) % 2 == 1) {
+            return i;
+        }
+    }
+    
+    return 0; // If all even, can start anywhere
+}
+
+void PuzzleCore::TriggerShakeAnimation() {
+    puzzleFailed = true;
+    shakeTimer = 0.5f; // 0.5 second shake
+    shakeIntensity = 10.0f;
+}
+
+void PuzzleCore::UpdateShakeAnimation(float deltaTime) {
+    if (shakeTimer > 0) {
+        shakeTimer -= deltaTime;
+        
+        // Generate random shake offset
+        float angle = DegreesToRadians((float)shakeRng.Range(0, 360));
+        float currentIntensity = shakeIntensity * (shakeTimer / 0.5f);
+        shakeOffset.x = cosf(angle) * currentIntensity;
+        shakeOffset.y = sinf(angle) * currentIntensity;
+        
+        if (shakeTimer <= 0) {
+            shakeOffset = {0, 0};
+            puzzleFailed = false;
+        }
+    }
+}
+
+// Spawn particles along the drawing path
+void PuzzleCore::SpawnParticles(Vec2 position) {
+    float distance = Distance(lastParticleSpawnPos, position);
+    if (distance < particles.GetEmission().spawnDistance) return;
+    
+    lastParticleSpawnPos = position;
+    particles.Emit(position);
+}
+
+// Everything a level change resets, before the new layout goes in
+void PuzzleCore::ClearLevel() {
+    nodes.clear();
+    edges.clear();
+    currentPath.clear();
+    pathEdges.clear();
+    pathPoints.clear();
+    particles.Clear();
+    isDrawing = false;
+    levelComplete = false;
+    timerRunning = false;
+    levelStartTime = 0.0f;
+    levelEndTime = 0.0f;
+    currentScore = 0;
+    showHintPopup = false;
+    hintPopupAlpha = 0.0f;
+    puzzleFailed = false;
+    shakeTimer = 0.0f;
+    hintActive = false;
+    highlightedNode = -1;
+    pathHash = 0;
+    pathSerial++;
+    levelVersion++;
+    pathVersion++;
+}
+
+// Rebuild the indexes over a freshly loaded layout
+void PuzzleCore::FinishLoading() {
+    graph.Build((int)nodes.size(), edges);
+    nodeGrid.Build(nodes, nodeRadius);
+    edgeGrid.Build(nodes, edges);
+    
+    Rect bounds = {0, 0, 0, 0};
+    if (!nodes.empty()) {
+        float minX = nodes[0].position.x, maxX = minX;
+        float minY = nodes[0].position.y, maxY = minY;
+        for (const auto& node : nodes) {
+            minX = min(minX, node.position.x);
+            maxX = max(maxX, node.position.x);
+            minY = min(minY, node.position.y);
+            maxY = max(maxY, node.position.y);
+        }
+        bounds = {minX - nodeRadius, minY - nodeRadius, maxX - minX + nodeRadius * 2, maxY - minY + nodeRadius * 2};
+    }
+    view.Fit(bounds);
+    panning = false;
+    hints.SetLevel(graph);
+    
+    // Room for a whole stroke up front, so playing the level never
+    // allocates; the buffers keep the largest level's size from then on
+    currentPath.reserve(edges.size() + 1);
+    pathEdges.reserve(edges.size());
+    pathPoints.reserve(edges.size() + 1);
+    segmentHits.reserve(nodes.size());
+    deadEnds.Reserve(graph);
+}
+
+bool PuzzleCore::LoadGeneratedLevel(uint64_t seed, float difficulty) {
+    GeneratorParams params = MakeGeneratorParams(difficulty, nodeRadius);
+    // A batch where every candidate fails is rare; just try another batch
+    for (uint64_t attempt = 0; attempt < 4; attempt++) {
+        if (generator.Generate(MixSeed(seed, attempt), params, generated)) {
+            nodes = generated.nodes;
+            edges = generated.edges;
+            return true;
+        }
+    }
+    return false;
+}
+
+void PuzzleCore::LoadDailyLevel(int day) {
+    ClearLevel();
+    dailyLevel = true;
+    dailyDay = day;
+    if (!LoadGeneratedLevel(MixSeed(kDailySeed, (uint64_t)day), 0.6f)) {
+        LoadLevel(currentLevel);
+        return;
+    }
+    FinishLoading();
+}
+
+void PuzzleCore::LoadLevel(int level) {
+    PROFILE_ZONE("PuzzleCore::LoadLevel");
+    ClearLevel();
+    dailyLevel = false;
+    
+    if (level < 1) {
+        currentLevel = 1;
+        level = 1;
+    }
+    // Solving it then records the time without touching the heap
+    if (progressStore) progressStore->ReserveLevel(level);
+    
+    // Levels from the pack are decoded straight into nodes/edges
+    if (level <= GetPackLevelCount() && levelPack.DecodeLevel(level - 1, nodes, edges)) {
+        FinishLoading();
+        return;
+    }
+    
+    // Endless mode: difficulty climbs with every level past the pack
+    int step = max(0, level - GetPackLevelCount() - 1);
+    float difficulty = min(1.0f, 0.3f + 0.04f * (float)step);
+    if (!LoadGeneratedLevel(MixSeed(kEndlessSeed, (uint64_t)level), difficulty)) {
+        // Only reachable if the generator is broken; keep the game usable
+        nodes = {{{705, 530}, 0, false}, {{1175, 530}, 1, false}};
+        edges = {{0, 1, 0}};
+    }
+    FinishLoading();
+}
+
+bool PuzzleCore::OpenLevelPack(const char* path) {
+    return levelPack.Open(path);
+}
+
+void PuzzleCore::AttachProgressStore(ProgressStore* store, bool restore) {
+    progressStore = store;
+    if (!store || !restore) return;
+    const SavedProgress& saved = store->Progress();
+    maxUnlockedLevel = max(1, saved.maxUnlockedLevel);
+    totalScore = saved.totalScore;
+    currentLevel = maxUnlockedLevel;
+}
+
+void PuzzleCore::MarkEdgeVisited(int edge) {
+    edges[edge].visitCount++;
+}
+
+// Extend the path by one edge and update the live dead-end verdict
+void PuzzleCore::TraceEdge(int edge, int from, int to) {
+    currentPath.push_back(to);
+    pathEdges.push_back(edge);
+    pathPoints.push_back(nodes[to].position);
+    MarkEdgeVisited(edge);
+    deadEnds.Step(edge, from, to);
+    pathHash ^= MixSeed((uint64_t)edge, 0);
+}
+
+int PuzzleCore::GetNodeAtPosition(Vec2 pos) const {
+    return nodeGrid.FindNearest(pos);
+}
+
+// The service has usually solved this path already; if not, UpdateHints
+// picks the hint up once it has
+void PuzzleCore::RequestHint() {
+    hintActive = true;
+    hintResult = hints.Find(HintKey());
+}
+
+const SolveResult& PuzzleCore::GetHint() const {
+    return hintResult ? *hintResult : kNoHint;
+}
+
+// Names the path state a hint is for: the level, which edges were traced
+// and where the path ends
+uint64_t PuzzleCore::HintKey() const {
+    uint64_t end = (uint64_t)levelVersion << 32 | (uint32_t)(currentPath.empty() ? 0 : currentPath.back() + 1);
+    return MixSeed(MixSeed(pathHash, pathEdges.size()), end);
+}
+
+// Keep the hint service on the path as it is now, and take the hint the
+// player asked for once it is ready. Hints only feed the display, so when
+// they arrive never changes how the game plays.
+void PuzzleCore::UpdateHints() {
+    PROFILE_ZONE("PuzzleCore::UpdateHints");
+    if (levelComplete) return;
+    uint64_t key = HintKey();
+    if (key != requestedHintKey) {
+        hints.Request(key, pathEdges, currentPath.empty() ? -1 : currentPath.back(), pathSerial);
+        requestedHintKey = key;
+    }
+    if (hintActive && !hintResult) hintResult = hints.Find(key);
+}
+
+SolveStatus PuzzleCore::ValidateLevel() {
+    return solver.Validate(graph);
+}
+
+void PuzzleCore::AutoSolve() {
+    PROFILE_ZONE("PuzzleCore::AutoSolve");
+    if (gameState != PLAYING || levelComplete) return;
+    
+    solver.SolveFromEdges(graph, pathEdges, currentPath.empty() ? -1 : currentPath.back(), autoTrail);
+    if (autoTrail.status != SOLVE_OK && autoTrail.status != SOLVE_ALREADY_COMPLETE) {
+        ResetPath();
+        solver.SolveFromEdges(graph, pathEdges, -1, autoTrail);
+    }
+    if (autoTrail.status != SOLVE_OK && autoTrail.status != SOLVE_ALREADY_COMPLETE) return;
+    
+    if (currentPath.empty()) {
+        StartPath(autoTrail.nodes[0], clock.Now());
+    }
+    for (size_t i = 0; i < autoTrail.edges.size(); i++) {
+        TraceEdge(autoTrail.edges[i], autoTrail.nodes[i], autoTrail.nodes[i + 1]);
+    }
+    hintActive = false;
+    pathVersion++;
+    
+    CheckSolution(clock.Now());
+    isDrawing = false;
+}
+
+double PuzzleCore::SampleTime(const InputSample& sample) {
+    return sample.time >= 0.0 ? sample.time : clock.Now();
+}
+
+void PuzzleCore::StartPath(int nodeId, double time) {
+    ResetPath();
+    currentPath.push_back(nodeId);
+    pathPoints.push_back(nodes[nodeId].position);
+    deadEnds.Reset(graph, nodeId);
+    isDrawing = true;
+    lastParticleSpawnPos = nodes[nodeId].position;
+    lastCursor = nodes[nodeId].position;
+    
+    if (!timerRunning) {
+        levelStartTime = time;
+        timerRunning = true;
+    }
+}
+
+// Follow the cursor through the readings taken while the button was held.
+// Returns how many that was; the reading after them is the release.
+int PuzzleCore::UpdatePath(const InputSample* samples, int count) {
+    PROFILE_ZONE("PuzzleCore::UpdatePath");
+    if (currentPath.empty()) return 0;
+    
+    bool wasStuck = deadEnds.IsStuck();
+    // Finish any dead-end search left over from earlier steps
+    deadEnds.Poll();
+    
+    int held = 0;
+    while (held < count && samples[held].down) {
+        TraceSegment(lastCursor, samples[held].pos);
+        lastCursor = samples[held].pos;
+        held++;
+    }
+    
+    // Tell the player the moment the stroke can't be finished rather than
+    // on release
+    if (!wasStuck && deadEnds.IsStuck()) {
+        TriggerShakeAnimation();
+        pathVersion++;
+    }
+    return held;
+}
+
+// Take every node the cursor passed over between two readings, in the order
+// it reached them, so a swipe faster than the sample rate still registers
+// the nodes in between
+void PuzzleCore::TraceSegment(Vec2 from, Vec2 to) {
+    nodeGrid.FindAlongSegment(from, to, segmentHits);
+    for (const SegmentHit& hit : segmentHits) {
+        // A trail uses every edge once, so a longer path has already
+        // failed; stopping here keeps it inside the room made at load
+        if (pathEdges.size() >= edges.size()) break;
+        int lastNode = currentPath.back();
+        if (hit.node == lastNode) continue;
+        
+        int edge = graph.FindEdge(lastNode, hit.node, edges);
+        if (edge != -1) {
+            TraceEdge(edge, lastNode, hit.node);
+            hintActive = false;
+            pathVersion++;
+        }
+    }
+}
+
+void PuzzleCore::ResetPath() {
+    currentPath.clear();
+    pathEdges.clear();
+    pathPoints.clear();
+    particles.Clear();
+    isDrawing = false;
+    hintActive = false;
+    pathHash = 0;
+    pathSerial++;
+    
+    for (auto& edge : edges) {
+        edge.visitCount = 0;
+    }
+    
+    SetHighlightedNode(-1);
+    pathVersion++;
+}
+
+int PuzzleCore::CalculateScore(float timeTaken) const {
+    int baseScore = 100;
+    int timePenalty = (int)(timeTaken * 2);
+    int score = max(20, baseScore - timePenalty);
+    return score;
+}
+
+void PuzzleCore::CheckSolution(double endTime) {
+    bool allVisitedOnce = true;
+    bool anyVisitedTwice = false;
+    
+    for (const auto& edge : edges) {
+        if (edge.visitCount != 1) {
+            allVisitedOnce = false;
+        }
+        if (edge.visitCount > 1) {
+            anyVisitedTwice = true;
+        }
+    }
+    
+    if (allVisitedOnce) {
+        levelComplete = true;
+        levelEndTime = endTime;
+        float timeTaken = levelEndTime - levelStartTime;
+        currentScore = CalculateScore(timeTaken);
+        totalScore += currentScore;
+        
+        if (!dailyLevel && currentLevel == maxUnlockedLevel) {
+            maxUnlockedLevel = currentLevel + 1;
+        }
+        
+        if (progressStore) {
+            if (!dailyLevel) progressStore->RecordTime(currentLevel, timeTaken);
+            progressStore->SetProgress(maxUnlockedLevel, totalScore);
+        }
+    } else if (anyVisitedTwice) {
+        // Puzzle failed - trigger shake
+        TriggerShakeAnimation();
+    }
+}
+
+float PuzzleCore::GetCurrentTime() const {
+    if (!timerRunning) return 0.0f;
+    if (levelComplete) return levelEndTime - levelStartTime;
+    return clock.Now() - levelStartTime;
+}
+
+// One fixed simulation step
+void PuzzleCore::Tick(float deltaTime) {
+    if (gameState == START_SCREEN) {
+        background.Step(deltaTime, pool);
+        return;
+    }
+    
+    particles.Update(deltaTime);
+    UpdateShakeAnimation(deltaTime);
+    
+    // Update hint popup fade
+    if (showHintPopup && hintPopupFadingIn) {
+        hintPopupAlpha += deltaTime * 4.0f;
+        if (hintPopupAlpha >= 1.0f) {
+            hintPopupAlpha = 1.0f;
+            hintPopupFadingIn = false;
+        }
+    } else if (!showHintPopup && hintPopupAlpha > 0) {
+        hintPopupAlpha -= deltaTime * 4.0f;
+        if (hintPopupAlpha < 0) {
+            hintPopupAlpha = 0;
+        }
+    }
+}
+
+void PuzzleCore::Update(const FrameInput& input) {
+    PROFILE_ZONE("PuzzleCore::Update");
+    long long allocationsBefore = AllocCounter::ThreadAllocations();
+    bool wasPlaying = gameState == PLAYING;
+    unsigned int levelBefore = levelVersion;
+    
+    HandleInput(input);
+    if (gameState == PLAYING) UpdateHints();
+    
+    // Everything a level needs while it is played was sized when it loaded
+    if (AllocCounter::kEnabled && wasPlaying && gameState == PLAYING && levelVersion == levelBefore) {
+        long long allocations = AllocCounter::ThreadAllocations() - allocationsBefore;
+        frameAllocs.AddFrame(allocations);
+        AllocCounter::ExpectNone(allocations, "PuzzleCore::Update");
+    }
+}
+
+void PuzzleCore::HandleInput(const FrameInput& input) {
+    Vec2 mousePos = input.mousePos;
+    
+    int ticks = timestep.Advance(clock.FrameDelta());
+    for (int i = 0; i < ticks; i++) {
+        Tick((float)timestep.Step());
+    }
+    
+    if (gameState == START_SCREEN) {
+        // Lines only need to follow the dots once per drawn frame
+        if (ticks > 0) background.FindLinks(kMaxBackgroundLinks, pool);
+        
+        if (input.mousePressed) {
+            if (PointInRect(mousePos, startButton)) {
+                gameState = PLAYING;
+                LoadLevel(currentLevel);
+            }
+        }
+        return;
+    }
+    
+    // The camera moves first, so this frame's cursor lands on the board
+    // as it is now drawn
+    if (input.wheel != 0.0f) view.ZoomAt(mousePos, powf(kWheelZoom, input.wheel));
+    if (input.panDown && panning) view.Pan({mousePos.x - lastPanPos.x, mousePos.y - lastPanPos.y});
+    panning = input.panDown;
+    lastPanPos = mousePos;
+    
+    // Handle hint popup clicks
+    if (showHintPopup && input.mousePressed) {
+        showHintPopup = false;
+    }
+    
+    if (input.mousePressed && !showHintPopup) {
+        if (PointInRect(mousePos, resetButton)) {
+            ResetPath();
+            return;
+        }
+        if (PointInRect(mousePos, hintButton)) {
+            RequestHint();
+            showHintPopup = true;
+            hintPopupFadingIn = true;
+            return;
+        }
+        if (PointInRect(mousePos, nextLevelButton)) {
+            if (dailyLevel) {
+                LoadLevel(currentLevel);
+            } else if (currentLevel < maxUnlockedLevel) {
+                currentLevel++;
+                LoadLevel(currentLevel);
+            }
+            return;
+        }
+        if (PointInRect(mousePos, prevLevelButton)) {
+            if (dailyLevel) {
+                LoadLevel(currentLevel);
+            } else if (currentLevel > 1) {
+                currentLevel--;
+                LoadLevel(currentLevel);
+            }
+            return;
+        }
+    }
+    
+    if (input.dailyRequest >= 0) {
+        LoadDailyLevel(input.dailyRequest);
+        return;
+    }
+    
+    if (input.autoSolvePressed && !levelComplete) {
+        showHintPopup = false;
+        AutoSolve();
+        return;
+    }
+    
+    if (levelComplete || showHintPopup) return;
+    
+    // Sub-frame readings when the platform has them, else the frame's
+    // cursor as the only reading, all moved onto the board
+    Vec2 boardPos = view.ScreenToWorld(mousePos);
+    worldSamples.clear();
+    if (input.sampleCount > 0) {
+        for (int i = 0; i < input.sampleCount; i++) {
+            InputSample sample = input.samples[i];
+            sample.pos = view.ScreenToWorld(sample.pos);
+            worldSamples.push_back(sample);
+        }
+    } else {
+        worldSamples.push_back({-1.0, boardPos, input.mouseDown});
+    }
+    const InputSample* samples = worldSamples.data();
+    int sampleCount = (int)worldSamples.size();
+    int first = 0;
+    
+    if (input.mousePressed) {
+        // Start where the button went down, not where the cursor had got
+        // to by the end of the frame
+        while (first < sampleCount - 1 && !samples[first].down) first++;
+        int nodeId = GetNodeAtPosition(samples[first].pos);
+        if (nodeId != -1) {
+            StartPath(nodeId, SampleTime(samples[first]));
+        }
+    }
+    
+    if (isDrawing) {
+        if (input.mouseDown) SpawnParticles(boardPos);
+        first += UpdatePath(samples + first, sampleCount - first);
+    }
+    
+    if (input.mouseReleased && isDrawing) {
+        // The timer stops at the reading where the button came up
+        CheckSolution(first < sampleCount ? SampleTime(samples[first]) : clock.Now());
+        isDrawing = false;
+    }
+    
+    int hoveredNode = -1;
+    if (!levelComplete && !isDrawing) {
+        hoveredNode = GetNodeAtPosition(boardPos);
+    }
+    SetHighlightedNode(hoveredNode);
+}
+
+// Only touches the nodes whose state changes, and tells the renderer
+void PuzzleCore::SetHighlightedNode(int nodeId) {
+    if (nodeId == highlightedNode) return;
+    
+    if (highlightedNode != -1) nodes[highlightedNode].isHighlighted = false;
+    if (nodeId != -1) nodes[nodeId].isHighlighted = true;
+    highlightedNode = nodeId;
+    highlightVersion++;
+}
@@ -0,0 +1,260 @@
+#pragma once
+
+#include "alloc_counter.h"
+#include "dead_end_checker.h"
+#include "dot_field.h"
+#include "euler_solver.h"
+#include "fixed_timestep.h"
+#include "graph_index.h"
+#include "hint_service.h"
+#include "level.h"
+#include "level_generator.h"
+#include "level_pack.h"
+#include "particle_pool.h"
+#include "progress_store.h"
+#include "spatial_grid.h"
+#include "platform.h"
+#include "rng.h"
+#include "thread_pool.h"
+#include "types.h"
+#include "view_camera.h"
+
+#include <memory>
+#include <vector>
+
+// Every randomized subsystem draws from its own stream of the session
+// seed, so changing how much one of them draws (more background dots, a
+// longer shake) never shifts what the others see
+enum RngStream {
+    RNG_STREAM_PARTICLES,
+    RNG_STREAM_SHAKE,
+    RNG_STREAM_BACKGROUND
+};
+
+// Game has two states: start screen and playing
+enum GameState {
+    START_SCREEN,
+    PLAYING
+};
+
+// Window-independent game logic. Owns the level, the path being traced,
+// scoring and all effect simulation; reads time from an injected Clock and
+// takes mouse input as a FrameInput per step. Drawing lives elsewhere.
+//
+// Nodes, edges, the path and particles are in world space; the cursor and
+// the buttons are in screen space, and the view camera maps between them.
+//
+// Input is handled once per frame, but everything that moves (background
+// dots, particles, shake, fades) advances in fixed kTickRate steps, so the
+// game plays the same at 30, 60 or 240 frames a second.
+class PuzzleCore {
+public:
+    static constexpr int kTickRate = 120;
+    static constexpr int kBackgroundDots = 100;
+    static constexpr int kMaxBackgroundLinks = 12000;
+
+    PuzzleCore(Clock& clock, unsigned int seed);
+
+    void Update(const FrameInput& input);
+    // Levels 1..GetPackLevelCount() come from the level pack; later ones are
+    // generated, and level n always gets the same layout
+    void LoadLevel(int level);
+    // Without a pack every level is generated
+    bool OpenLevelPack(const char* path);
+    // Take over a pack opened elsewhere (e.g. by a loader thread); `pack`
+    // gets the previous one
+    void AdoptLevelPack(LevelPack& pack) { levelPack.Swap(pack); }
+    // Save progress and best times to `store` from now on. With `restore`
+    // the saved progress is taken over first and play resumes at the
+    // furthest unlocked level; recordings skip that so their replays
+    // start from a fresh game like strokex_headless does.
+    void AttachProgressStore(ProgressStore* store, bool restore);
+    // Generated level shared by everyone on the same day (days since the
+    // Unix epoch). PREV/NEXT leave it for the regular levels.
+    void LoadDailyLevel(int day);
+    void ResetPath();
+    // Start screen background: how many dots, drifting over which area
+    void SetBackground(int dotCount, Rect bounds);
+
+    // Trace the rest of a valid trail from the current path (or from
+    // scratch when the path is a dead end) and finish the level
+    void AutoSolve();
+    SolveStatus ValidateLevel();
+
+    int CountOddDegreeNodes() const;
+    int GetFirstOddDegreeNode() const;
+    // `pos` in world space
+    int GetNodeAtPosition(Vec2 pos) const;
+    // Nodes whose centres and edges whose bounding boxes fall inside a
+    // world rect, ascending; the renderer's view culling
+    void FindNodesInRect(Rect rect, std::vector<int>& out) const { nodeGrid.FindInRect(rect, out); }
+    void FindEdgesInRect(Rect rect, std::vector<int>& out) const { edgeGrid.FindInRect(rect, out); }
+    float GetCurrentTime() const;
+    int GetPackLevelCount() const { return levelPack.LevelCount(); }
+    // 0 without a pack; see LevelPack::ContentHash
+    uint64_t GetPackHash() const { return levelPack.ContentHash(); }
+    uint64_t GetSeed() const { return seed; }
+
+    const GraphIndex& GetGraph() const { return graph; }
+    const ViewCamera& GetView() const { return view; }
+    // Solver output for the path as it was when the hint was requested;
+    // only meaningful while IsHintActive() and IsHintReady()
+    const SolveResult& GetHint() const;
+    bool IsHintActive() const { return hintActive; }
+    // Hints are worked out off the frame loop; false while the one asked
+    // for is still being solved
+    bool IsHintReady() const { return hintResult != nullptr; }
+    const HintService& GetHintService() const { return hints; }
+    // Heap allocations made by Update on frames that began and ended on the
+    // same level; all zero unless AllocCounter::kEnabled
+    const FrameAllocStats& GetFrameAllocStats() const { return frameAllocs; }
+    // Verdict on the stroke being traced, updated on every step: stuck as
+    // soon as the untraced edges can no longer be finished from its end
+    bool IsPathStuck() const { return !currentPath.empty() && deadEnds.IsStuck(); }
+    SolveStatus GetPathStatus() const { return deadEnds.Status(); }
+
+    const std::vector<Node>& GetNodes() const { return nodes; }
+    const std::vector<Edge>& GetEdges() const { return edges; }
+    const std::vector<int>& GetCurrentPath() const { return currentPath; }
+    // Edge ids traced so far; pathEdges[i] joins currentPath[i] and currentPath[i + 1]
+    const std::vector<int>& GetPathEdges() const { return pathEdges; }
+    const std::vector<Vec2>& GetPathPoints() const { return pathPoints; }
+    const DotField& GetBackground() const { return background; }
+    const ParticlePool& GetParticles() const { return particles; }
+    // How far the current frame is between the previous simulation step
+    // and the latest, 0..1; draw moving things at lerp(previous, current)
+    float GetRenderAlpha() const { return timestep.Alpha(); }
+    void SetParticleEmission(const ParticleEmission& emission) { particles.SetEmission(emission); }
+
+    GameState GetGameState() const { return gameState; }
+    bool IsDrawing() const { return isDrawing; }
+    bool IsLevelComplete() const { return levelComplete; }
+    int GetCurrentLevel() const { return currentLevel; }
+    int GetMaxUnlockedLevel() const { return maxUnlockedLevel; }
+    bool IsDailyLevel() const { return dailyLevel; }
+    int GetDailyDay() const { return dailyDay; }
+    LevelGenerator& GetLevelGenerator() { return generator; }
+    float GetNodeRadius() const { return nodeRadius; }
+    float GetLevelTime() const { return levelEndTime - levelStartTime; }
+    int GetCurrentScore() const { return currentScore; }
+    int GetTotalScore() const { return totalScore; }
+    // Saved best time for a level in seconds; negative if there is none
+    float GetBestTime(int level) const { return progressStore ? progressStore->Progress().BestTime(level) : -1.0f; }
+    Vec2 GetShakeOffset() const { return shakeOffset; }
+    bool IsHintPopupVisible() const { return showHintPopup; }
+    float GetHintPopupAlpha() const { return hintPopupAlpha; }
+
+    // Bumped whenever the matching part of the state changes, so a renderer
+    // can cache what it drew and redraw only when a version moves
+    unsigned int GetLevelVersion() const { return levelVersion; }
+    unsigned int GetPathVersion() const { return pathVersion; }
+    unsigned int GetHighlightVersion() const { return highlightVersion; }
+    // Bumped whenever the path starts over; in between it only grows
+    unsigned int GetPathSerial() const { return pathSerial; }
+    // Node under the cursor, or -1
+    int GetHighlightedNode() const { return highlightedNode; }
+
+    Rect GetStartButton() const { return startButton; }
+    Rect GetResetButton() const { return resetButton; }
+    Rect GetNextLevelButton() const { return nextLevelButton; }
+    Rect GetPrevLevelButton() const { return prevLevelButton; }
+    Rect GetHintButton() const { return hintButton; }
+
+private:
+    void Tick(float deltaTime);
+    void TriggerShakeAnimation();
+    void UpdateShakeAnimation(float deltaTime);
+    void SpawnParticles(Vec2 position);
+    void ClearLevel();
+    void FinishLoading();
+    bool LoadGeneratedLevel(uint64_t seed, float difficulty);
+    void MarkEdgeVisited(int edge);
+    void TraceEdge(int edge, int from, int to);
+    void SetHighlightedNode(int nodeId);
+    void RequestHint();
+    uint64_t HintKey() const;
+    void UpdateHints();
+    void HandleInput(const FrameInput& input);
+    double SampleTime(const InputSample& sample);
+    void StartPath(int nodeId, double time);
+    int UpdatePath(const InputSample* samples, int count);
+    void TraceSegment(Vec2 from, Vec2 to);
+    int CalculateScore(float timeTaken) const;
+    void CheckSolution(double endTime);
+
+    Clock& clock;
+    FixedTimestep timestep;
+    uint64_t seed;
+    Rng shakeRng;
+
+    LevelPack levelPack;
+    ProgressStore* progressStore = nullptr;
+    std::vector<Node> nodes;
+    std::vector<Edge> edges;
+    std::vector<int> currentPath;
+    std::vector<int> pathEdges;
+    std::vector<Vec2> pathPoints;
+    ParticlePool particles;
+
+    GraphIndex graph;
+    NodeGrid nodeGrid;
+    EdgeGrid edgeGrid;
+    ViewCamera view;
+    std::vector<InputSample> worldSamples;   // this frame's readings mapped to the board
+    Vec2 lastPanPos;
+    bool panning;
+    std::vector<SegmentHit> segmentHits;
+    EulerSolver solver;
+    DeadEndChecker deadEnds;
+    ThreadPool pool;
+    LevelGenerator generator;
+    GeneratedLevel generated;
+    DotField background;
+    HintService hints;
+    std::shared_ptr<const SolveResult> hintResult;
+    bool hintActive;
+    SolveResult autoTrail;
+    uint64_t pathHash;            // XOR of the mixed ids of the traced edges
+    unsigned int pathSerial;      // bumped whenever the path starts over
+    uint64_t requestedHintKey;
+    FrameAllocStats frameAllocs;
+
+    int highlightedNode;
+    unsigned int levelVersion;
+    unsigned int pathVersion;
+    unsigned int highlightVersion;
+
+    GameState gameState;
+    bool isDrawing;
+    bool levelComplete;
+    int currentLevel;
+    int maxUnlockedLevel;
+    bool dailyLevel;
+    int dailyDay;
+
+    float nodeRadius;
+    float levelStartTime;
+    float levelEndTime;
+    int currentScore;
+    int totalScore;
+    bool timerRunning;
+
+    Vec2 lastCursor;   // last reading the path was traced up to
+    Vec2 lastParticleSpawnPos;
+    float particleSpawnTimer;
+
+    Rect startButton;
+    Rect resetButton;
+    Rect nextLevelButton;
+    Rect prevLevelButton;
+    Rect hintButton;
+
+    bool showHintPopup;
+    float hintPopupAlpha;
+    bool hintPopupFadingIn;
+
+    bool puzzleFailed;
+    float shakeTimer;
+    float shakeIntensity;
+    Vec2 shakeOffset;
+};
@@ -0,0 +1,336 @@
+#include "replay.h"
+
+#include <cmath>
+#include <cstring>
+
+using namespace std;
+
+static const size_t kHeaderSize = 24;
+static const uint8_t kEndMarker = 0x80;
+static const float kPositionScale = 64.0f;   // 1/64 px steps
+
+enum FrameFlags {
+    FRAME_DOWN = 1,
+    FRAME_PRESSED = 2,
+    FRAME_RELEASED = 4,
+    FRAME_AUTO_SOLVE = 8,
+    FRAME_MOVED = 16,
+    FRAME_SAMPLES = 32,
+    FRAME_EXTRAS = 64
+};
+
+// Rarer inputs, behind FRAME_EXTRAS
+enum ExtraFlags {
+    EXTRA_DAILY = 1,
+    EXTRA_PAN = 2,
+    EXTRA_WHEEL = 4
+};
+
+enum SampleFlags {
+    SAMPLE_DOWN = 1,
+    SAMPLE_TIMED = 2
+};
+
+static void WriteU16(vector<uint8_t>& out, uint16_t value) {
+    out.push_back((uint8_t)value);
+    out.push_back((uint8_t)(value >> 8));
+}
+
+static void WriteU32(vector<uint8_t>& out, uint32_t value) {
+    for (int i = 0; i < 4; i++) out.push_back((uint8_t)(value >> (i * 8)));
+}
+
+static void WriteU64(vector<uint8_t>& out, uint64_t value) {
+    WriteU32(out, (uint32_t)value);
+    WriteU32(out, (uint32_t)(value >> 32));
+}
+
+static uint32_t ReadU32(const uint8_t* p) {
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static uint64_t ReadU64(const uint8_t* p) {
+    return (uint64_t)ReadU32(p) | (uint64_t)ReadU32(p + 4) << 32;
+}
+
+static void WriteVarint(vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back((uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back((uint8_t)value);
+}
+
+static void WriteSigned(vector<uint8_t>& out, int64_t value) {
+    WriteVarint(out, ((uint64_t)value << 1) ^ (uint64_t)(value >> 63));
+}
+
+static int64_t ToMicros(double seconds) {
+    return llround(seconds * 1e6);
+}
+
+static double MicrosToSeconds(int64_t micros) {
+    return (double)micros / 1e6;
+}
+
+static int32_t ToUnits(float position) {
+    return (int32_t)lroundf(position * kPositionScale);
+}
+
+static float UnitsToPosition(int32_t units) {
+    return (float)units / kPositionScale;
+}
+
+InputRecorder::InputRecorder()
+    : file(nullptr), frames(0), lastNow(0), lastStep(0), lastX(0), lastY(0), ok(false) {
+}
+
+InputRecorder::~InputRecorder() {
+    if (file) fclose(file);
+}
+
+bool InputRecorder::Begin(const char* path, uint64_t seed, uint64_t packHash) {
+    if (file) fclose(file);
+    file = fopen(path, "wb");
+    if (!file) return false;
+
+    frames = 0;
+    lastNow = 0;
+    lastStep = 0;
+    lastX = 0;
+    lastY = 0;
+    ok = true;
+
+    buffer.assign({'S', 'X', 'R', 'C'});
+    WriteU16(buffer, kRecordingVersion);
+    WriteU16(buffer, 0);
+    WriteU64(buffer, seed);
+    WriteU64(buffer, packHash);
+    Flush();
+    return ok;
+}
+
+void InputRecorder::Flush() {
+    if (!buffer.empty() && fwrite(buffer.data(), 1, buffer.size(), file) != buffer.size()) ok = false;
+    buffer.clear();
+}
+
+void InputRecorder::RecordFrame(FrameClock& clock, FrameInput& input) {
+    if (!file) return;
+
+    int64_t now = ToMicros(clock.Now());
+    int64_t step = now - lastNow;
+    int64_t delta = ToMicros(clock.FrameDelta());
+    clock.SetFrame(MicrosToSeconds(now), (float)MicrosToSeconds(delta));
+
+    uint8_t flags = 0;
+    if (input.mouseDown) flags |= FRAME_DOWN;
+    if (input.mousePressed) flags |= FRAME_PRESSED;
+    if (input.mouseReleased) flags |= FRAME_RELEASED;
+    if (input.autoSolvePressed) flags |= FRAME_AUTO_SOLVE;
+    if (input.sampleCount > 0) flags |= FRAME_SAMPLES;
+    uint8_t extras = 0;
+    if (input.dailyRequest >= 0) extras |= EXTRA_DAILY;
+    if (input.panDown) extras |= EXTRA_PAN;
+    int32_t wheel = ToUnits(input.wheel);
+    if (wheel != 0) extras |= EXTRA_WHEEL;
+    input.wheel = UnitsToPosition(wheel);
+    if (extras) flags |= FRAME_EXTRAS;
+
+    // Samples first; the frame's cursor is then stored against the last
+    // of them, which it usually equals
+    size_t flagsAt = buffer.size();
+    buffer.push_back(0);
+    WriteSigned(buffer, step - lastStep);
+    WriteSigned(buffer, delta - step);
+    lastNow = now;
+    lastStep = step;
+
+    if (input.sampleCount > 0) {
+        samples.assign(input.samples, input.samples + input.sampleCount);
+        WriteVarint(buffer, samples.size());
+        for (InputSample& sample : samples) {
+            uint8_t sampleFlags = (sample.down ? SAMPLE_DOWN : 0) | (sample.time >= 0.0 ? SAMPLE_TIMED : 0);
+            buffer.push_back(sampleFlags);
+            if (sample.time >= 0.0) {
+                int64_t time = ToMicros(sample.time);
+                WriteSigned(buffer, time - now);
+                sample.time = MicrosToSeconds(time);
+            }
+            int32_t x = ToUnits(sample.pos.x);
+            int32_t y = ToUnits(sample.pos.y);
+            WriteSigned(buffer, x - lastX);
+            WriteSigned(buffer, y - lastY);
+            sample.pos = {UnitsToPosition(x), UnitsToPosition(y)};
+            lastX = x;
+            lastY = y;
+        }
+        input.samples = samples.data();
+    }
+
+    int32_t x = ToUnits(input.mousePos.x);
+    int32_t y = ToUnits(input.mousePos.y);
+    if (x != lastX || y != lastY) {
+        flags |= FRAME_MOVED;
+        WriteSigned(buffer, x - lastX);
+        WriteSigned(buffer, y - lastY);
+        lastX = x;
+        lastY = y;
+    }
+    input.mousePos = {UnitsToPosition(x), UnitsToPosition(y)};
+
+    if (extras) {
+        WriteVarint(buffer, extras);
+        if (extras & EXTRA_DAILY) WriteVarint(buffer, (uint64_t)input.dailyRequest);
+        if (extras & EXTRA_WHEEL) WriteSigned(buffer, wheel);
+    }
+    buffer[flagsAt] = flags;
+
+    frames++;
+    if (buffer.size() >= 64 * 1024) Flush();
+}
+
+bool InputRecorder::Finish(int totalScore, int maxLevel) {
+    if (!file) return false;
+    buffer.push_back(kEndMarker);
+    WriteU64(buffer, (uint64_t)frames);
+    WriteU32(buffer, (uint32_t)totalScore);
+    WriteU32(buffer, (uint32_t)maxLevel);
+    Flush();
+    ok = (fclose(file) == 0) && ok;
+    file = nullptr;
+    return ok;
+}
+
+bool InputReplayer::Open(const char* path, FrameClock& frameClock) {
+    valid = false;
+    clock = &frameClock;
+    data.clear();
+
+    FILE* file = fopen(path, "rb");
+    if (!file) return false;
+    uint8_t chunk[64 * 1024];
+    size_t read;
+    while ((read = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        data.insert(data.end(), chunk, chunk + read);
+    }
+    fclose(file);
+
+    // The trailer is fixed size, so the frame stream ends right before it
+    const size_t trailerSize = 1 + 8 + 4 + 4;
+    if (data.size() < kHeaderSize + trailerSize) return false;
+    if (memcmp(data.data(), "SXRC", 4) != 0) return false;
+    uint16_t version = (uint16_t)(data[4] | data[5] << 8);
+    if (version != kRecordingVersion) return false;
+    frameEnd = data.size() - trailerSize;
+    const uint8_t* trailer = data.data() + frameEnd;
+    if (trailer[0] != kEndMarker) return false;
+
+    info.seed = ReadU64(data.data() + 8);
+    info.packHash = ReadU64(data.data() + 16);
+    info.frames = (long long)ReadU64(trailer + 1);
+    info.totalScore = (int)ReadU32(trailer + 9);
+    info.maxLevel = (int)ReadU32(trailer + 13);
+
+    position = kHeaderSize;
+    frame = 0;
+    lastNow = 0;
+    lastStep = 0;
+    lastX = 0;
+    lastY = 0;
+    valid = true;
+    return true;
+}
+
+bool InputReplayer::ReadVarint(uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (position >= frameEnd) return false;
+        uint8_t byte = data[position++];
+        value |= (uint64_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+bool InputReplayer::ReadSigned(int64_t& value) {
+    uint64_t raw;
+    if (!ReadVarint(raw)) return false;
+    value = (int64_t)(raw >> 1) ^ -(int64_t)(raw & 1);
+    return true;
+}
+
+FrameInput InputReplayer::Poll() {
+    FrameInput input = {{UnitsToPosition(lastX), UnitsToPosition(lastY)}, false, false, false, false};
+    if (!valid || frame >= info.frames || position >= frameEnd) {
+        valid = valid && frame >= info.frames;
+        return input;
+    }
+
+    uint8_t flags = data[position++];
+    int64_t stepChange = 0;
+    int64_t deltaOffset = 0;
+    bool good = ReadSigned(stepChange) && ReadSigned(deltaOffset);
+    int64_t step = lastStep + stepChange;
+    int64_t now = lastNow + step;
+    lastNow = now;
+    lastStep = step;
+    clock->SetFrame(MicrosToSeconds(now), (float)MicrosToSeconds(step + deltaOffset));
+
+    input.mouseDown = (flags & FRAME_DOWN) != 0;
+    input.mousePressed = (flags & FRAME_PRESSED) != 0;
+    input.mouseReleased = (flags & FRAME_RELEASED) != 0;
+    input.autoSolvePressed = (flags & FRAME_AUTO_SOLVE) != 0;
+
+    if (good && (flags & FRAME_SAMPLES)) {
+        uint64_t count = 0;
+        good = ReadVarint(count) && count <= frameEnd - position;
+        samples.clear();
+        for (uint64_t i = 0; good && i < count; i++) {
+            InputSample sample = {-1.0, {0, 0}, false};
+            uint8_t sampleFlags = position < frameEnd ? data[position++] : 0;
+            sample.down = (sampleFlags & SAMPLE_DOWN) != 0;
+            int64_t time = 0;
+            int64_t dx = 0;
+            int64_t dy = 0;
+            if (sampleFlags & SAMPLE_TIMED) {
+                good = ReadSigned(time);
+                sample.time = MicrosToSeconds(now + time);
+            }
+            good = good && ReadSigned(dx) && ReadSigned(dy);
+            lastX += (int32_t)dx;
+            lastY += (int32_t)dy;
+            sample.pos = {UnitsToPosition(lastX), UnitsToPosition(lastY)};
+            samples.push_back(sample);
+        }
+        input.samples = samples.data();
+        input.sampleCount = (int)samples.size();
+    }
+
+    if (good && (flags & FRAME_MOVED)) {
+        int64_t dx = 0;
+        int64_t dy = 0;
+        good = ReadSigned(dx) && ReadSigned(dy);
+        lastX += (int32_t)dx;
+        lastY += (int32_t)dy;
+    }
+    input.mousePos = {UnitsToPosition(lastX), UnitsToPosition(lastY)};
+
+    uint64_t extras = 0;
+    if (good && (flags & FRAME_EXTRAS)) good = ReadVarint(extras);
+    if (good && (extras & EXTRA_DAILY)) {
+        uint64_t day = 0;
+        good = ReadVarint(day);
+        input.dailyRequest = (int)day;
+    }
+    input.panDown = (extras & EXTRA_PAN) != 0;
+    if (good && (extras & EXTRA_WHEEL)) {
+        int64_t wheel = 0;
+        good = ReadSigned(wheel);
+        input.wheel = UnitsToPosition((int32_t)wheel);
+    }
+
+    valid = good && !(flags & kEndMarker);
+    frame++;
+    return input;
+}
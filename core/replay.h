@@ -0,0 +1,107 @@
+#pragma once
+
+#include "platform.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+// Session recording (.sxrec), little-endian:
+//
+//   header   "SXRC", u16 version, u16 reserved, u64 session seed,
+//            u64 level pack hash (0 without a pack)
+//   frames   one record per frame, back to back
+//   trailer  u8 0x80, u64 frame count, i32 total score, i32 max level
+//
+// A frame record starts with a flags byte (button down / pressed /
+// released, auto-solve, cursor moved, has samples, has extras). The rest
+// follows in this order, as zigzag varints unless noted:
+//
+//   time     how much the step in Now() differs from the previous frame's
+//            step, then how far FrameDelta() is from the step, both in
+//            microseconds
+//   samples  (if flagged) an unsigned varint count, then per sub-frame
+//            reading a flags byte, its time against the frame's in
+//            microseconds (if it has one) and its move against the
+//            previous reading in 1/64 px
+//   cursor   (if moved) the move against the last reading in 1/64 px
+//   extras   (if flagged) an unsigned flags varint for daily request, pan
+//            button and wheel, then the daily day (unsigned) and the
+//            wheel in 1/64 notches
+//
+// A frame with a still cursor and a steady frame rate costs 3 bytes.
+//
+// Everything is quantized before the core sees it, so the recorded session
+// and its replay run on identical numbers and reach the identical score.
+
+const uint16_t kRecordingVersion = 2;
+
+struct RecordingInfo {
+    uint64_t seed;
+    uint64_t packHash;
+    long long frames;
+    int totalScore;
+    int maxLevel;
+};
+
+class InputRecorder {
+public:
+    InputRecorder();
+    ~InputRecorder();
+
+    InputRecorder(const InputRecorder&) = delete;
+    InputRecorder& operator=(const InputRecorder&) = delete;
+
+    bool Begin(const char* path, uint64_t seed, uint64_t packHash);
+    bool IsRecording() const { return file != nullptr; }
+
+    // Quantize this frame's clock and input in place and append them. The
+    // input's samples are redirected to the recorder's own copy.
+    void RecordFrame(FrameClock& clock, FrameInput& input);
+
+    // Write the result the replay has to reproduce and close the file
+    bool Finish(int totalScore, int maxLevel);
+
+private:
+    void Flush();
+
+    FILE* file;
+    std::vector<uint8_t> buffer;
+    std::vector<InputSample> samples;
+    long long frames;
+    int64_t lastNow;
+    int64_t lastStep;
+    int32_t lastX;
+    int32_t lastY;
+    bool ok;
+};
+
+// Feeds a recording back as input, setting the clock for every frame
+class InputReplayer : public InputSource {
+public:
+    bool Open(const char* path, FrameClock& clock);
+    const RecordingInfo& Info() const { return info; }
+    // Frames left to replay
+    bool HasFrames() const { return frame < info.frames; }
+    // False if the recording ended early or is corrupt
+    bool IsValid() const { return valid; }
+
+    FrameInput Poll() override;
+
+private:
+    bool ReadVarint(uint64_t& value);
+    bool ReadSigned(int64_t& value);
+
+    FrameClock* clock = nullptr;
+    std::vector<uint8_t> data;
+    size_t position = 0;
+    size_t frameEnd = 0;
+    RecordingInfo info = {};
+    long long frame = 0;
+    std::vector<InputSample> samples;
+    int64_t lastNow = 0;
+    int64_t lastStep = 0;
+    int32_t lastX = 0;
+    int32_t lastY = 0;
+    bool valid = false;
+};
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+
+// PCG32 (O'Neill): small, fast and statistically solid. Cheap enough to
+// call per particle, unlike going through <random> distributions.
+class Rng {
+public:
+    explicit Rng(uint64_t seed = 0x853c49e6748fea9bULL) { Seed(seed); }
+
+    void Seed(uint64_t seed) {
+        state = 0;
+        NextU32();
+        state += seed;
+        NextU32();
+    }
+
+    uint32_t NextU32() {
+        uint64_t old = state;
+        state = old * 6364136223846793005ULL + 1442695040888963407ULL;
+        uint32_t xorshifted = (uint32_t)(((old >> 18u) ^ old) >> 27u);
+        uint32_t rot = (uint32_t)(old >> 59u);
+        return (xorshifted >> rot) | (xorshifted << ((32 - rot) & 31));
+    }
+
+    // Inclusive on both ends, like raylib's GetRandomValue
+    int Range(int min, int max) {
+        uint32_t span = (uint32_t)(max - min) + 1;
+        return min + (int)(((uint64_t)NextU32() * span) >> 32);
+    }
+
+    // Uniform in [0, 1)
+    float Float01() { return (float)(NextU32() >> 8) * (1.0f / 16777216.0f); }
+
+private:
+    uint64_t state;
+};
+
+// SplitMix64 finaliser over a seed and a stream number, for deriving
+// independent seeds (per level, per candidate, ...) from one base seed
+inline uint64_t MixSeed(uint64_t seed, uint64_t stream) {
+    uint64_t z = seed + 0x9e3779b97f4a7c15ULL * (stream + 1);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
@@ -0,0 +1,102 @@
+#include "simulation_thread.h"
+
+#include "profiler.h"
+
+using namespace std;
+
+SimulationThread::SimulationThread(PuzzleCore& core, FrameClock& clock, InputRecorder* recorder)
+    : core(core), clock(clock), recorder(recorder) {}
+
+SimulationThread::~SimulationThread() {
+    Stop();
+}
+
+void SimulationThread::Start() {
+    if (thread.joinable()) return;
+    stopping = false;
+    thread = std::thread(&SimulationThread::Run, this);
+}
+
+void SimulationThread::Stop() {
+    if (!thread.joinable()) return;
+    {
+        lock_guard<mutex> lock(queueMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    thread.join();
+}
+
+void SimulationThread::PostFrame(double now, float delta, const FrameInput& input) {
+    {
+        lock_guard<mutex> lock(queueMutex);
+        PostedFrame frame = {now, delta, input, (int)queuedSamples.size()};
+        frame.input.samples = nullptr;
+        queuedSamples.insert(queuedSamples.end(), input.samples, input.samples + input.sampleCount);
+        queued.push_back(frame);
+        postedFrames++;
+    }
+    wake.notify_one();
+}
+
+void SimulationThread::PostLevelPack(LevelPack& pack) {
+    {
+        lock_guard<mutex> lock(queueMutex);
+        postedPack.Swap(pack);
+        packAt = (int)queued.size();
+    }
+    wake.notify_one();
+}
+
+void SimulationThread::Flush() {
+    unique_lock<mutex> lock(queueMutex);
+    long long target = postedFrames;
+    drained.wait(lock, [&] { return publishedFrames >= target || !thread.joinable(); });
+}
+
+void SimulationThread::Run() {
+    vector<PostedFrame> frames;
+    vector<InputSample> samples;
+    LevelPack pack;
+    while (true) {
+        int adoptAt;
+        long long batchEnd;
+        {
+            unique_lock<mutex> lock(queueMutex);
+            wake.wait(lock, [this] { return stopping || !queued.empty() || packAt >= 0; });
+            if (queued.empty() && packAt < 0) return;
+            frames.swap(queued);
+            samples.swap(queuedSamples);
+            adoptAt = packAt;
+            if (adoptAt >= 0) pack.Swap(postedPack);
+            packAt = -1;
+            batchEnd = postedFrames;
+        }
+
+        {
+            PROFILE_ZONE("SimulationThread::Frames");
+            for (int i = 0; i <= (int)frames.size(); i++) {
+                // The pack goes in between the same two frames it did on
+                // the render thread
+                if (i == adoptAt) core.AdoptLevelPack(pack);
+                if (i == (int)frames.size()) break;
+                PostedFrame& frame = frames[i];
+                if (frame.input.sampleCount > 0) frame.input.samples = &samples[frame.firstSample];
+                clock.SetFrame(frame.now, frame.delta);
+                if (recorder) recorder->RecordFrame(clock, frame.input);
+                core.Update(frame.input);
+            }
+        }
+        // Only the last of a batch is ever drawn
+        writer.Capture(core, snapshots.WriteSlot());
+        snapshots.Publish();
+        frames.clear();
+        samples.clear();
+
+        {
+            lock_guard<mutex> lock(queueMutex);
+            publishedFrames = batchEnd;
+        }
+        drained.notify_all();
+    }
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "frame_snapshot.h"
+#include "level_pack.h"
+#include "platform.h"
+#include "puzzle_core.h"
+#include "replay.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Runs the core on a thread of its own, so drawing a frame and simulating
+// the next one overlap and a slow update on a big board doesn't hold up
+// the display. The render thread posts each frame's clock and input and
+// draws the newest snapshot published; it never touches the core while
+// the thread runs.
+//
+// Posted frames are simulated in order, each exactly once, with the clock
+// set to what was posted, so a recording made here replays the same as one
+// made on a single thread. When the simulation falls behind, the frames
+// queue up and it catches up on them before publishing again.
+class SimulationThread {
+public:
+    // `core` and `clock` belong to the thread from Start until Stop.
+    // `recorder` may be null; otherwise every frame is recorded as it is
+    // simulated.
+    SimulationThread(PuzzleCore& core, FrameClock& clock, InputRecorder* recorder);
+    ~SimulationThread();
+
+    SimulationThread(const SimulationThread&) = delete;
+    SimulationThread& operator=(const SimulationThread&) = delete;
+
+    // Set before Start; see SnapshotWriter::SetCullMargin
+    void SetCullMargin(float world, float screen) { writer.SetCullMargin(world, screen); }
+    void Start();
+    // Simulate everything posted so far, then stop
+    void Stop();
+    bool IsRunning() const { return thread.joinable(); }
+
+    // Queue one frame. The input's samples are copied.
+    void PostFrame(double now, float delta, const FrameInput& input);
+    // Swapped into the core before the next frame is simulated; `pack`
+    // gets an empty one
+    void PostLevelPack(LevelPack& pack);
+    // Wait until every frame posted so far has been simulated and its
+    // snapshot published
+    void Flush();
+
+    // See SnapshotWriter::GetAllocStats; read once stopped
+    const FrameAllocStats& GetCaptureAllocStats() const { return writer.GetAllocStats(); }
+
+    // The newest snapshot; see SnapshotBuffer::Acquire. Render thread only.
+    const FrameSnapshot* Acquire() { return snapshots.Acquire(); }
+
+private:
+    struct PostedFrame {
+        double now;
+        float delta;
+        FrameInput input;
+        int firstSample;   // into the samples posted with it
+    };
+
+    void Run();
+
+    PuzzleCore& core;
+    FrameClock& clock;
+    InputRecorder* recorder;
+    SnapshotWriter writer;
+    SnapshotBuffer snapshots;
+
+    std::mutex queueMutex;
+    std::condition_variable wake;
+    std::condition_variable drained;
+    // Guarded by queueMutex
+    std::vector<PostedFrame> queued;
+    std::vector<InputSample> queuedSamples;
+    LevelPack postedPack;
+    int packAt = -1;          // adopted before queued[packAt]; -1 if none
+    bool stopping = false;
+    long long postedFrames = 0;
+    long long publishedFrames = 0;
+
+    std::thread thread;
+};
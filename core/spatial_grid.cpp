@@ -0,0 +1,331 @@
+#include "spatial_grid.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define STROKEX_GRID_SSE2 1
+#endif
+
+using namespace std;
+
+void NodeGrid::Build(const vector<Node>& nodes, float hitRadius) {
+    radius = hitRadius;
+    xs.clear();
+    ys.clear();
+    ids.clear();
+    cellStart.assign(1, 0);
+    cols = rows = 0;
+    if (nodes.empty()) return;
+
+    float minX = nodes[0].position.x, maxX = minX;
+    float minY = nodes[0].position.y, maxY = minY;
+    for (const auto& node : nodes) {
+        minX = min(minX, node.position.x);
+        maxX = max(maxX, node.position.x);
+        minY = min(minY, node.position.y);
+        maxY = max(maxY, node.position.y);
+    }
+
+    // A cell one diameter wide means a hit circle touches at most 2x2 cells.
+    // Sparse layouts grow the cells so the grid stays O(nodes) in size.
+    cellSize = max(radius * 2.0f, 1.0f);
+    size_t maxCells = max<size_t>(1024, nodes.size() * 4);
+    while (true) {
+        cols = (int)((maxX - minX) / cellSize) + 1;
+        rows = (int)((maxY - minY) / cellSize) + 1;
+        if ((size_t)cols * (size_t)rows <= maxCells) break;
+        cellSize *= 2.0f;
+    }
+    originX = minX;
+    originY = minY;
+
+    // Counting sort of nodes by cell
+    vector<int>& nodeCell = cells;
+    nodeCell.resize(nodes.size());
+    cellStart.assign((size_t)cols * rows + 1, 0);
+    for (size_t i = 0; i < nodes.size(); i++) {
+        int cx = (int)((nodes[i].position.x - originX) / cellSize);
+        int cy = (int)((nodes[i].position.y - originY) / cellSize);
+        nodeCell[i] = cy * cols + cx;
+        cellStart[nodeCell[i] + 1]++;
+    }
+    for (size_t c = 1; c < cellStart.size(); c++) {
+        cellStart[c] += cellStart[c - 1];
+    }
+
+    xs.resize(nodes.size());
+    ys.resize(nodes.size());
+    ids.resize(nodes.size());
+    cursor.assign(cellStart.begin(), cellStart.end() - 1);
+    for (size_t i = 0; i < nodes.size(); i++) {
+        int slot = cursor[nodeCell[i]]++;
+        xs[slot] = nodes[i].position.x;
+        ys[slot] = nodes[i].position.y;
+        ids[slot] = nodes[i].id;
+    }
+}
+
+int NodeGrid::FindNearest(Vec2 pos) const {
+    if (ids.empty()) return -1;
+
+    int x0 = (int)floorf((pos.x - radius - originX) / cellSize);
+    int x1 = (int)floorf((pos.x + radius - originX) / cellSize);
+    int y0 = (int)floorf((pos.y - radius - originY) / cellSize);
+    int y1 = (int)floorf((pos.y + radius - originY) / cellSize);
+    if (x1 < 0 || y1 < 0 || x0 >= cols || y0 >= rows) return -1;
+    x0 = max(x0, 0);
+    y0 = max(y0, 0);
+    x1 = min(x1, cols - 1);
+    y1 = min(y1, rows - 1);
+
+    // Strict comparisons against a threshold just above r^2 accept nodes
+    // exactly on the rim and keep the earliest node on ties
+    float bestDist = nextafterf(radius * radius, INFINITY);
+    int bestSlot = -1;
+
+    for (int cy = y0; cy <= y1; cy++) {
+        // Cells of one row are stored back to back, so the row's candidates
+        // form a single run
+        int begin = cellStart[cy * cols + x0];
+        int end = cellStart[cy * cols + x1 + 1];
+        int i = begin;
+
+#ifdef STROKEX_GRID_SSE2
+        if (end - begin >= 4) {
+            __m128 px = _mm_set1_ps(pos.x);
+            __m128 py = _mm_set1_ps(pos.y);
+            __m128 best = _mm_set1_ps(bestDist);
+            __m128i bestIdx = _mm_set1_epi32(-1);
+            __m128i idx = _mm_setr_epi32(begin, begin + 1, begin + 2, begin + 3);
+            __m128i four = _mm_set1_epi32(4);
+
+            for (; i + 4 <= end; i += 4) {
+                __m128 dx = _mm_sub_ps(_mm_loadu_ps(&xs[i]), px);
+                __m128 dy = _mm_sub_ps(_mm_loadu_ps(&ys[i]), py);
+                __m128 d2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+                __m128 closer = _mm_cmplt_ps(d2, best);
+                best = _mm_or_ps(_mm_and_ps(closer, d2), _mm_andnot_ps(closer, best));
+                __m128i closerI = _mm_castps_si128(closer);
+                bestIdx = _mm_or_si128(_mm_and_si128(closerI, idx), _mm_andnot_si128(closerI, bestIdx));
+                idx = _mm_add_epi32(idx, four);
+            }
+
+            float laneDist[4];
+            int laneIdx[4];
+            _mm_storeu_ps(laneDist, best);
+            _mm_storeu_si128((__m128i*)laneIdx, bestIdx);
+            for (int lane = 0; lane < 4; lane++) {
+                if (laneIdx[lane] < 0) continue;
+                if (laneDist[lane] < bestDist || (laneDist[lane] == bestDist && laneIdx[lane] < bestSlot)) {
+                    bestDist = laneDist[lane];
+                    bestSlot = laneIdx[lane];
+                }
+            }
+        }
+#endif
+
+        for (; i < end; i++) {
+            float dx = xs[i] - pos.x;
+            float dy = ys[i] - pos.y;
+            float d2 = dx * dx + dy * dy;
+            if (d2 < bestDist) {
+                bestDist = d2;
+                bestSlot = i;
+            }
+        }
+    }
+
+    return bestSlot == -1 ? -1 : ids[bestSlot];
+}
+
+void NodeGrid::FindAlongSegment(Vec2 a, Vec2 b, vector<SegmentHit>& hits) const {
+    hits.clear();
+    if (ids.empty()) return;
+
+    float dx = b.x - a.x;
+    float dy = b.y - a.y;
+    double lengthSq = (double)dx * dx + (double)dy * dy;
+    double radiusSq = (double)radius * radius;
+
+    int y0 = (int)floorf((min(a.y, b.y) - radius - originY) / cellSize);
+    int y1 = (int)floorf((max(a.y, b.y) + radius - originY) / cellSize);
+    y0 = max(y0, 0);
+    y1 = min(y1, rows - 1);
+
+    for (int cy = y0; cy <= y1; cy++) {
+        // Only the part of the segment within a radius of this row's band
+        // can touch its nodes, so the run is clipped to that x range
+        float bandTop = originY + cy * cellSize - radius;
+        float bandBottom = originY + (cy + 1) * cellSize + radius;
+        float tMin = 0.0f;
+        float tMax = 1.0f;
+        if (dy != 0.0f) {
+            float tTop = (bandTop - a.y) / dy;
+            float tBottom = (bandBottom - a.y) / dy;
+            tMin = max(0.0f, min(tTop, tBottom));
+            tMax = min(1.0f, max(tTop, tBottom));
+            if (tMin > tMax) continue;
+        }
+        float xa = a.x + dx * tMin;
+        float xb = a.x + dx * tMax;
+        int x0 = max((int)floorf((min(xa, xb) - radius - originX) / cellSize), 0);
+        int x1 = min((int)floorf((max(xa, xb) + radius - originX) / cellSize), cols - 1);
+        if (x0 > x1) continue;
+
+        int end = cellStart[cy * cols + x1 + 1];
+        for (int i = cellStart[cy * cols + x0]; i < end; i++) {
+            // Solve |a + t(b - a) - c| = r for the entry t, rim inclusive.
+            // Double, since the discriminant cancels badly on long swipes.
+            double fx = a.x - xs[i];
+            double fy = a.y - ys[i];
+            double c = fx * fx + fy * fy - radiusSq;
+            double t = 0.0;
+            if (c > 0.0) {
+                if (lengthSq == 0.0) continue;
+                double halfB = fx * dx + fy * dy;
+                double disc = halfB * halfB - lengthSq * c;
+                if (halfB >= 0.0 || disc < 0.0) continue;
+                t = (-halfB - sqrt(disc)) / lengthSq;
+                if (t > 1.0) continue;
+            }
+            hits.push_back({(float)t, ids[i]});
+        }
+    }
+
+    sort(hits.begin(), hits.end(), [](const SegmentHit& l, const SegmentHit& r) {
+        return l.t < r.t || (l.t == r.t && l.node < r.node);
+    });
+}
+
+void NodeGrid::FindInRect(Rect rect, vector<int>& out) const {
+    out.clear();
+    if (ids.empty()) return;
+
+    float right = rect.x + rect.width;
+    float bottom = rect.y + rect.height;
+    int x0 = max((int)floorf((rect.x - originX) / cellSize), 0);
+    int x1 = min((int)floorf((right - originX) / cellSize), cols - 1);
+    int y0 = max((int)floorf((rect.y - originY) / cellSize), 0);
+    int y1 = min((int)floorf((bottom - originY) / cellSize), rows - 1);
+    if (x0 > x1 || y0 > y1) return;
+
+    for (int cy = y0; cy <= y1; cy++) {
+        int end = cellStart[cy * cols + x1 + 1];
+        for (int i = cellStart[cy * cols + x0]; i < end; i++) {
+            if (xs[i] >= rect.x && xs[i] <= right && ys[i] >= rect.y && ys[i] <= bottom) out.push_back(ids[i]);
+        }
+    }
+    sort(out.begin(), out.end());
+}
+
+void EdgeGrid::Build(const vector<Node>& nodes, const vector<Edge>& edges) {
+    minXs.clear();
+    minYs.clear();
+    maxXs.clear();
+    maxYs.clear();
+    ids.clear();
+    longEdges.clear();
+    longBoxes.clear();
+    cellStart.assign(1, 0);
+    cols = rows = 0;
+    reach = 0.0f;
+    if (edges.empty()) return;
+
+    boxes.resize(edges.size());
+    float minX = INFINITY, minY = INFINITY, maxX = -INFINITY, maxY = -INFINITY;
+    double totalExtent = 0.0;
+    for (size_t i = 0; i < edges.size(); i++) {
+        Vec2 a = nodes[edges[i].nodeA].position;
+        Vec2 b = nodes[edges[i].nodeB].position;
+        boxes[i] = {min(a.x, b.x), min(a.y, b.y), fabsf(a.x - b.x), fabsf(a.y - b.y)};
+        minX = min(minX, boxes[i].x);
+        minY = min(minY, boxes[i].y);
+        maxX = max(maxX, boxes[i].x + boxes[i].width);
+        maxY = max(maxY, boxes[i].y + boxes[i].height);
+        totalExtent += max(boxes[i].width, boxes[i].height);
+    }
+
+    // Cells about twice the typical edge, and edges over four times it set
+    // aside, so a query widens by at most two cells. Sparse layouts grow
+    // the cells so the grid stays O(edges) in size.
+    float typical = max((float)(totalExtent / edges.size()), 1.0f);
+    float longLimit = typical * 4.0f;
+    cellSize = typical * 2.0f;
+    size_t maxCells = max<size_t>(1024, edges.size() * 4);
+    while (true) {
+        cols = (int)((maxX - minX) / cellSize) + 1;
+        rows = (int)((maxY - minY) / cellSize) + 1;
+        if ((size_t)cols * (size_t)rows <= maxCells) break;
+        cellSize *= 2.0f;
+    }
+    originX = minX;
+    originY = minY;
+
+    // Counting sort of the filed edges by the cell of their midpoint
+    vector<int>& edgeCell = cells;
+    edgeCell.assign(edges.size(), -1);
+    cellStart.assign((size_t)cols * rows + 1, 0);
+    for (size_t i = 0; i < edges.size(); i++) {
+        const Rect& box = boxes[i];
+        if (max(box.width, box.height) > longLimit) {
+            longEdges.push_back((int)i);
+            longBoxes.push_back(box);
+            continue;
+        }
+        reach = max(reach, max(box.width, box.height) * 0.5f);
+        int cx = min((int)((box.x + box.width * 0.5f - originX) / cellSize), cols - 1);
+        int cy = min((int)((box.y + box.height * 0.5f - originY) / cellSize), rows - 1);
+        edgeCell[i] = cy * cols + cx;
+        cellStart[edgeCell[i] + 1]++;
+    }
+    for (size_t c = 1; c < cellStart.size(); c++) {
+        cellStart[c] += cellStart[c - 1];
+    }
+
+    size_t filed = edges.size() - longEdges.size();
+    minXs.resize(filed);
+    minYs.resize(filed);
+    maxXs.resize(filed);
+    maxYs.resize(filed);
+    ids.resize(filed);
+    cursor.assign(cellStart.begin(), cellStart.end() - 1);
+    for (size_t i = 0; i < edges.size(); i++) {
+        if (edgeCell[i] < 0) continue;
+        int slot = cursor[edgeCell[i]]++;
+        minXs[slot] = boxes[i].x;
+        minYs[slot] = boxes[i].y;
+        maxXs[slot] = boxes[i].x + boxes[i].width;
+        maxYs[slot] = boxes[i].y + boxes[i].height;
+        ids[slot] = (int)i;
+    }
+}
+
+void EdgeGrid::FindInRect(Rect rect, vector<int>& out) const {
+    out.clear();
+    float right = rect.x + rect.width;
+    float bottom = rect.y + rect.height;
+
+    if (!ids.empty()) {
+        int x0 = max((int)floorf((rect.x - reach - originX) / cellSize), 0);
+        int x1 = min((int)floorf((right + reach - originX) / cellSize), cols - 1);
+        int y0 = max((int)floorf((rect.y - reach - originY) / cellSize), 0);
+        int y1 = min((int)floorf((bottom + reach - originY) / cellSize), rows - 1);
+        for (int cy = y0; x0 <= x1 && cy <= y1; cy++) {
+            int end = cellStart[cy * cols + x1 + 1];
+            for (int i = cellStart[cy * cols + x0]; i < end; i++) {
+                if (maxXs[i] >= rect.x && minXs[i] <= right && maxYs[i] >= rect.y && minYs[i] <= bottom) {
+                    out.push_back(ids[i]);
+                }
+            }
+        }
+    }
+    for (size_t i = 0; i < longEdges.size(); i++) {
+        const Rect& box = longBoxes[i];
+        if (box.x + box.width >= rect.x && box.x <= right && box.y + box.height >= rect.y && box.y <= bottom) {
+            out.push_back(longEdges[i]);
+        }
+    }
+    sort(out.begin(), out.end());
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "level.h"
+
+#include <vector>
+
+// A node circle crossed by a cursor segment; t in [0, 1] is where along the
+// segment the cursor first touched it
+struct SegmentHit {
+    float t;
+    int node;
+};
+
+// Uniform grid over node centres for hit testing. Nodes are bucketed by
+// cell and stored as structure-of-arrays in cell order, so the candidates
+// for a query are a few contiguous runs that can be tested four at a time.
+class NodeGrid {
+public:
+    // Rebuild for a level; radius is the node hit radius
+    void Build(const std::vector<Node>& nodes, float radius);
+
+    // Id of the node whose centre is nearest to pos, considering only nodes
+    // within the hit radius. -1 if there is none.
+    int FindNearest(Vec2 pos) const;
+
+    // Every node whose hit circle the segment a -> b touches, ordered by
+    // where the segment enters it. A cursor that moved from a to b passed
+    // over exactly these nodes, however far it went in one step.
+    void FindAlongSegment(Vec2 a, Vec2 b, std::vector<SegmentHit>& hits) const;
+
+    // Ids of every node whose centre lies inside rect, ascending
+    void FindInRect(Rect rect, std::vector<int>& out) const;
+
+private:
+    float radius = 0.0f;
+    float cellSize = 1.0f;
+    float originX = 0.0f;
+    float originY = 0.0f;
+    int cols = 0;
+    int rows = 0;
+
+    std::vector<int> cellStart;   // nodes of cell c are [cellStart[c], cellStart[c + 1])
+    std::vector<float> xs;
+    std::vector<float> ys;
+    std::vector<int> ids;
+
+    // Build's working space, kept so the next level reuses it
+    std::vector<int> cells;
+    std::vector<int> cursor;
+};
+
+// Uniform grid over edge bounding boxes for view culling. Each edge is
+// filed under the cell holding its midpoint, with its box stored
+// structure-of-arrays in cell order; a query widens the rect by the
+// largest half-extent among filed edges, so no edge needs listing twice.
+// The few edges much longer than the rest are kept aside and tested on
+// every query instead of widening it for all.
+class EdgeGrid {
+public:
+    void Build(const std::vector<Node>& nodes, const std::vector<Edge>& edges);
+
+    // Ids of every edge whose bounding box meets rect, ascending
+    void FindInRect(Rect rect, std::vector<int>& out) const;
+
+private:
+    float cellSize = 1.0f;
+    float reach = 0.0f;   // largest half-extent of a filed edge
+    float originX = 0.0f;
+    float originY = 0.0f;
+    int cols = 0;
+    int rows = 0;
+
+    std::vector<int> cellStart;   // edges of cell c are [cellStart[c], cellStart[c + 1])
+    std::vector<float> minXs;
+    std::vector<float> minYs;
+    std::vector<float> maxXs;
+    std::vector<float> maxYs;
+    std::vector<int> ids;
+    std::vector<int> longEdges;
+    std::vector<Rect> longBoxes;
+
+    // Build's working space, kept so the next level reuses it
+    std::vector<Rect> boxes;
+    std::vector<int> cells;
+    std::vector<int> cursor;
+};
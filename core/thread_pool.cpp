@@ -0,0 +1,136 @@
+#include "thread_pool.h"
+
+#include "profiler.h"
+
+#include <algorithm>
+
+using namespace std;
+
+// Queue a worker thread pushes to and pops from first; -1 off the pool
+static thread_local int currentWorker = -1;
+
+ThreadPool::ThreadPool(int threadCount) : pending(0), nextQueue(0), stopping(false) {
+    if (threadCount <= 0) {
+        threadCount = max(0, (int)thread::hardware_concurrency() - 1);
+    }
+    int queueCount = max(1, threadCount);
+    for (int i = 0; i < queueCount; i++) {
+        queues.push_back(make_unique<WorkQueue>());
+    }
+    queued = 0;
+    for (int i = 0; i < threadCount; i++) {
+        workers.emplace_back(&ThreadPool::WorkerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    Wait();
+    {
+        lock_guard<mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::Submit(function<void()> task) {
+    int target = currentWorker;
+    if (target < 0) {
+        target = (int)(nextQueue.fetch_add(1, memory_order_relaxed) % queues.size());
+    }
+    pending.fetch_add(1, memory_order_relaxed);
+    {
+        lock_guard<mutex> lock(queues[target]->mutex);
+        queues[target]->tasks.push_back(move(task));
+    }
+    {
+        lock_guard<mutex> lock(sleepMutex);
+        queued++;
+    }
+    wake.notify_one();
+    idle.notify_all();
+}
+
+// Pop from our own queue's back, else steal from the front of another
+bool ThreadPool::TryRunOne(int home) {
+    function<void()> task;
+    int queueCount = (int)queues.size();
+    for (int i = 0; i < queueCount && !task; i++) {
+        WorkQueue& queue = *queues[(home + i) % queueCount];
+        lock_guard<mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) continue;
+        if (i == 0) {
+            task = move(queue.tasks.back());
+            queue.tasks.pop_back();
+        } else {
+            task = move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+    }
+    if (!task) return false;
+
+    {
+        lock_guard<mutex> lock(sleepMutex);
+        queued--;
+    }
+    {
+        PROFILE_ZONE("Task");
+        task();
+    }
+    if (pending.fetch_sub(1, memory_order_acq_rel) == 1) {
+        lock_guard<mutex> lock(sleepMutex);
+        idle.notify_all();
+    }
+    return true;
+}
+
+void ThreadPool::WorkerLoop(int index) {
+    currentWorker = index;
+    while (true) {
+        if (TryRunOne(index)) continue;
+
+        unique_lock<mutex> lock(sleepMutex);
+        wake.wait(lock, [this] { return stopping || queued > 0; });
+        if (stopping && queued == 0) return;
+    }
+}
+
+void ThreadPool::Wait() {
+    WaitForZero(pending);
+}
+
+// Run queued tasks, any caller's, until counter drops to zero
+void ThreadPool::WaitForZero(const atomic<int>& counter) {
+    int home = currentWorker >= 0 ? currentWorker : 0;
+    while (true) {
+        if (counter.load(memory_order_acquire) == 0) return;
+        if (TryRunOne(home)) continue;
+
+        unique_lock<mutex> lock(sleepMutex);
+        idle.wait(lock, [this, &counter] { return counter.load(memory_order_acquire) == 0 || queued > 0; });
+    }
+}
+
+void ThreadPool::ParallelFor(int count, int grain, const function<void(int, int)>& body) {
+    if (count <= 0) return;
+    grain = max(1, grain);
+    if (count <= grain) {
+        body(0, count);
+        return;
+    }
+    // Our own counter, so nested or concurrent calls never wait on each other
+    atomic<int> remaining((count + grain - 1) / grain);
+    for (int begin = 0; begin < count; begin += grain) {
+        int end = min(count, begin + grain);
+        Submit([this, &body, &remaining, begin, end] {
+            body(begin, end);
+            if (remaining.fetch_sub(1, memory_order_acq_rel) == 1) {
+                lock_guard<mutex> lock(sleepMutex);
+                idle.notify_all();
+            }
+        });
+    }
+    WaitForZero(remaining);
+}
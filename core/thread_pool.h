@@ -0,0 +1,57 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Small work-stealing pool. Every worker owns a deque: it pops its own work
+// from the back and, when that runs dry, steals from the front of the others.
+// Work submitted from outside the pool is dealt round-robin. Threads that
+// call Wait() run queued tasks themselves instead of blocking, so the pool
+// still makes progress on a single-core machine.
+class ThreadPool {
+public:
+    // 0 picks one worker per hardware thread, minus the calling thread
+    explicit ThreadPool(int threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int WorkerCount() const { return (int)workers.size(); }
+
+    void Submit(std::function<void()> task);
+
+    // Block until every submitted task has finished
+    void Wait();
+
+    // Run body(begin, end) over [0, count) in chunks of at most `grain`
+    // indices and wait for those chunks only; safe to nest inside a task
+    void ParallelFor(int count, int grain, const std::function<void(int, int)>& body);
+
+private:
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    void WorkerLoop(int index);
+    bool TryRunOne(int home);
+    void WaitForZero(const std::atomic<int>& counter);
+
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    std::vector<std::thread> workers;
+
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    std::condition_variable idle;
+    int queued;                 // tasks sitting in a queue; guarded by sleepMutex
+    std::atomic<int> pending;   // queued plus running
+    std::atomic<unsigned int> nextQueue;
+    bool stopping;
+};
@@ -0,0 +1,221 @@
+#include "trail_counter.h"
+
+#include "rng.h"
+
+#include <algorithm>
+#include <atomic>
+
+using namespace std;
+
+static uint64_t SaturatingAdd(uint64_t a, uint64_t b, bool& saturated) {
+    uint64_t sum = a + b;
+    if (sum < a) {
+        saturated = true;
+        return UINT64_MAX;
+    }
+    return sum;
+}
+
+void TrailCounter::Prepare(const GraphIndex& g, long long stateBudget) {
+    graph = &g;
+    int nodeCount = g.NodeCount();
+    int edgeCount = g.EdgeCount();
+
+    // Fixed seed: the keys only need to be distinct, not secret
+    Rng rng(0x7a0b1157ULL);
+    nodeKeys.resize(nodeCount);
+    edgeKeys.resize(edgeCount);
+    for (uint64_t& key : nodeKeys) key = (uint64_t)rng.NextU32() << 32 | rng.NextU32();
+    for (uint64_t& key : edgeKeys) key = (uint64_t)rng.NextU32() << 32 | rng.NextU32();
+
+    // Small levels and small budgets have few states; don't clear a big
+    // table for them
+    int bits = 10;
+    while (bits < 18 && bits < edgeCount + 4 && ((long long)1 << bits) < stateBudget * 2) bits++;
+    Entry empty = {};
+    empty.node = -1;
+    table.assign((size_t)1 << bits, empty);
+    tableMask = ((uint64_t)1 << bits) - 1;
+
+    used[0] = used[1] = 0;
+    hash = 0;
+    states = 0;
+    budget = stateBudget;
+    aborted = false;
+    saturated = false;
+}
+
+void TrailCounter::ValidStarts(vector<int>& starts) const {
+    starts.clear();
+    int nodeCount = graph->NodeCount();
+    for (int n = 0; n < nodeCount; n++) {
+        if (graph->Degree(n) % 2 == 1) starts.push_back(n);
+    }
+    if (starts.size() == 2) return;
+
+    bool allEven = starts.empty();
+    starts.clear();
+    if (!allEven) return;
+    for (int n = 0; n < nodeCount; n++) {
+        if (graph->Degree(n) > 0) starts.push_back(n);
+    }
+}
+
+TrailCounter::Result TrailCounter::Take(int node, int edge, int remaining) {
+    uint64_t bit = (uint64_t)1 << (edge & 63);
+    used[edge >> 6] |= bit;
+    hash ^= edgeKeys[edge];
+    Result result = Search(graph->OtherNode(edge, node), remaining - 1);
+    used[edge >> 6] &= ~bit;
+    hash ^= edgeKeys[edge];
+    return result;
+}
+
+TrailCounter::Result TrailCounter::Search(int node, int remaining) {
+    if (remaining == 0) return {1, 0, 1.0};
+
+    uint64_t key = hash ^ nodeKeys[node];
+    Entry& entry = table[key & tableMask];
+    if (entry.key == key && entry.node == node && entry.used[0] == used[0] && entry.used[1] == used[1]) {
+        return entry.result;
+    }
+    if (aborted || ++states > budget) {
+        aborted = true;
+        return {0, 0, 0.0};
+    }
+
+    Result result = {0, 0, 0.0};
+    int options = 0;
+    for (const HalfEdge* he = graph->NeighborsBegin(node); he != graph->NeighborsEnd(node); ++he) {
+        int edge = he->edge;
+        if (used[edge >> 6] & ((uint64_t)1 << (edge & 63))) continue;
+
+        Result child = Take(node, edge, remaining);
+        result.trails = SaturatingAdd(result.trails, child.trails, saturated);
+        result.deadEnds = SaturatingAdd(result.deadEnds, child.deadEnds, saturated);
+        result.chance += child.chance;
+        options++;
+    }
+    if (options == 0) return {0, 1, 0.0};
+    result.chance /= options;
+
+    // Always replace: the table is a cache, a lost entry only costs time.
+    // The slot may have moved if the recursion reused it, so look it up again.
+    if (!aborted) {
+        Entry& slot = table[key & tableMask];
+        slot.key = key;
+        slot.used[0] = used[0];
+        slot.used[1] = used[1];
+        slot.node = node;
+        slot.result = result;
+    }
+    return result;
+}
+
+bool TrailCounter::Count(const GraphIndex& g, TrailStats& stats, long long stateBudget) {
+    stats = TrailStats{0, 0, 0.0, 0, false, false};
+    int edgeCount = g.EdgeCount();
+    if (edgeCount > kMaxEdges) return false;
+    if (edgeCount == 0) {
+        stats.successChance = 1.0;
+        stats.exact = true;
+        return true;
+    }
+
+    Prepare(g, stateBudget);
+    vector<int> starts;
+    ValidStarts(starts);
+
+    for (int start : starts) {
+        Result result = Search(start, edgeCount);
+        stats.trails = SaturatingAdd(stats.trails, result.trails, saturated);
+        stats.deadEnds = SaturatingAdd(stats.deadEnds, result.deadEnds, saturated);
+        stats.successChance += result.chance;
+    }
+    if (!starts.empty()) stats.successChance /= (double)starts.size();
+
+    stats.states = states;
+    stats.exact = !aborted;
+    stats.saturated = saturated;
+    return stats.exact;
+}
+
+bool TrailCounter::CountParallel(ThreadPool& pool, const GraphIndex& g, TrailStats& stats,
+                                 long long stateBudget) {
+    stats = TrailStats{0, 0, 0.0, 0, false, false};
+    int edgeCount = g.EdgeCount();
+    if (edgeCount > kMaxEdges) return false;
+    if (edgeCount == 0) {
+        stats.successChance = 1.0;
+        stats.exact = true;
+        return true;
+    }
+
+    vector<int> starts;
+    {
+        TrailCounter probe;
+        probe.graph = &g;
+        probe.ValidStarts(starts);
+    }
+
+    // One task per (start, first edge)
+    struct Task {
+        int start;
+        int edge;
+        Result result;
+        long long states;
+        bool exact;
+        bool saturated;
+    };
+    vector<Task> tasks;
+    for (int start : starts) {
+        for (const HalfEdge* he = g.NeighborsBegin(start); he != g.NeighborsEnd(start); ++he) {
+            tasks.push_back({start, he->edge, {0, 0, 0.0}, 0, false, false});
+        }
+    }
+
+    // One lane per thread that can run, pulling tasks in order. A table
+    // entry holds a whole (node, used edges) state of this graph, so it stays
+    // valid from one task to the next and is never cleared in between.
+    int taskCount = (int)tasks.size();
+    int lanes = min(pool.WorkerCount() + 1, taskCount);
+    atomic<int> nextTask(0);
+    pool.ParallelFor(lanes, 1, [&](int, int) {
+        // Kept per thread so later calls reuse the table's memory
+        static thread_local TrailCounter counter;
+        counter.Prepare(g, stateBudget);
+        int i;
+        while ((i = nextTask.fetch_add(1, memory_order_relaxed)) < taskCount) {
+            Task& task = tasks[i];
+            long long statesBefore = counter.states;
+            task.result = counter.Take(task.start, task.edge, edgeCount);
+            task.states = counter.states - statesBefore;
+            task.exact = !counter.aborted;
+            task.saturated = counter.saturated;
+        }
+    });
+
+    // A start's chance is the mean over its first moves
+    bool saturated = false;
+    bool exact = true;
+    size_t i = 0;
+    for (int start : starts) {
+        double chance = 0.0;
+        int options = g.Degree(start);
+        for (int k = 0; k < options; k++, i++) {
+            const Task& task = tasks[i];
+            stats.trails = SaturatingAdd(stats.trails, task.result.trails, saturated);
+            stats.deadEnds = SaturatingAdd(stats.deadEnds, task.result.deadEnds, saturated);
+            chance += task.result.chance;
+            stats.states += task.states;
+            exact = exact && task.exact;
+            saturated = saturated || task.saturated;
+        }
+        stats.successChance += chance / options;
+    }
+    if (!starts.empty()) stats.successChance /= (double)starts.size();
+
+    stats.exact = exact;
+    stats.saturated = saturated;
+    return exact;
+}
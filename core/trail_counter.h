@@ -0,0 +1,78 @@
+#pragma once
+
+#include "graph_index.h"
+#include "thread_pool.h"
+
+#include <cstdint>
+#include <vector>
+
+struct TrailStats {
+    uint64_t trails;        // complete trails over every edge, per start node and direction
+    uint64_t deadEnds;      // strokes from a valid start that get stuck with edges left
+    double successChance;   // chance a stroke picking uniformly among free edges completes
+    long long states;       // (node, used edges) states expanded
+    bool exact;             // false if the level was too big or the state budget ran out
+    bool saturated;         // a count overflowed 64 bits and was clamped
+};
+
+// 0 when every stroke from a valid start succeeds, 1 when none can. This is
+// the exact value of what LevelGenerator::RateLevel samples.
+inline float TrailDifficulty(const TrailStats& stats) {
+    return (float)(1.0 - stats.successChance);
+}
+
+// Exact trail analysis by memoized search over (current node, used edges).
+// Trails, dead ends and the success chance from a state only depend on
+// that state, so each one is solved once and cached in a transposition
+// table keyed by a Zobrist hash that is updated as edges are taken. Only
+// strokes from valid starts are counted: the two odd nodes, or any node
+// when all degrees are even.
+//
+// (The BEST theorem counts Euler circuits in closed form, but only for
+// directed graphs; for undirected ones the count is #P-complete, hence the
+// search.)
+class TrailCounter {
+public:
+    static constexpr int kMaxEdges = 128;
+
+    bool Count(const GraphIndex& graph, TrailStats& stats, long long stateBudget = 2000000);
+
+    // Same result, with the first move from every start searched as its
+    // own task. Each pool thread prepares one counter and keeps its table
+    // across the tasks it takes, so moves that meet again share work; the
+    // state budget applies per thread.
+    static bool CountParallel(ThreadPool& pool, const GraphIndex& graph, TrailStats& stats,
+                              long long stateBudget = 2000000);
+
+private:
+    struct Result {
+        uint64_t trails;
+        uint64_t deadEnds;
+        double chance;
+    };
+
+    struct Entry {
+        uint64_t key;
+        uint64_t used[2];
+        int node;
+        Result result;
+    };
+
+    void Prepare(const GraphIndex& graph, long long stateBudget);
+    // Search with the edge set as it is; the stroke currently stands on `node`
+    Result Search(int node, int remaining);
+    Result Take(int node, int edge, int remaining);
+    void ValidStarts(std::vector<int>& starts) const;
+
+    const GraphIndex* graph;
+    std::vector<uint64_t> nodeKeys;
+    std::vector<uint64_t> edgeKeys;
+    std::vector<Entry> table;
+    uint64_t tableMask;
+    uint64_t used[2];
+    uint64_t hash;
+    long long states;
+    long long budget;
+    bool aborted;
+    bool saturated;
+};
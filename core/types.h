@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cmath>
+
+// Plain math/color types used by the headless core. They mirror the memory
+// layout of raylib's Vector2 / Color / Rectangle so the renderer can convert
+// between them for free, but the core never includes raylib.h.
+
+struct Vec2 {
+    float x;
+    float y;
+};
+
+struct Rgba {
+    unsigned char r;
+    unsigned char g;
+    unsigned char b;
+    unsigned char a;
+};
+
+struct Rect {
+    float x;
+    float y;
+    float width;
+    float height;
+};
+
+inline float DegreesToRadians(float degrees) {
+    return degrees * 0.017453292519943295f;
+}
+
+inline float Distance(Vec2 a, Vec2 b) {
+    float dx = b.x - a.x;
+    float dy = b.y - a.y;
+    return sqrtf(dx * dx + dy * dy);
+}
+
+inline bool PointInRect(Vec2 point, Rect rect) {
+    return point.x >= rect.x && point.x < rect.x + rect.width &&
+           point.y >= rect.y && point.y < rect.y + rect.height;
+}
@@ -0,0 +1,77 @@
+#include "view_camera.h"
+
+#include <algorithm>
+
+using namespace std;
+
+static const float kMaxZoom = 4.0f;
+// How far past the home view the player may zoom out
+static const float kZoomOutSlack = 0.5f;
+
+void ViewCamera::SetViewport(Rect windowRect, Rect playRect) {
+    window = windowRect;
+    playArea = playRect;
+    Fit(bounds);
+}
+
+void ViewCamera::Fit(Rect boardBounds) {
+    bounds = boardBounds;
+    bool fits = bounds.x >= window.x && bounds.y >= window.y && bounds.x + bounds.width <= window.x + window.width &&
+                bounds.y + bounds.height <= window.y + window.height;
+    if (fits) {
+        zoom = 1.0f;
+        anchor = {window.x + window.width * 0.5f, window.y + window.height * 0.5f};
+        target = anchor;
+    } else {
+        zoom = min(playArea.width / max(bounds.width, 1.0f), playArea.height / max(bounds.height, 1.0f));
+        anchor = {playArea.x + playArea.width * 0.5f, playArea.y + playArea.height * 0.5f};
+        target = {bounds.x + bounds.width * 0.5f, bounds.y + bounds.height * 0.5f};
+    }
+    minZoom = min(zoom, 1.0f) * kZoomOutSlack;
+    identity = fits;
+
+    // Panning may go anywhere over the board, and back to the home view
+    Vec2 middle = ScreenToWorld({window.x + window.width * 0.5f, window.y + window.height * 0.5f});
+    float left = min(bounds.x, middle.x);
+    float top = min(bounds.y, middle.y);
+    limits = {left, top, max(bounds.x + bounds.width, middle.x) - left, max(bounds.y + bounds.height, middle.y) - top};
+    Changed();
+}
+
+void ViewCamera::Pan(Vec2 screenDelta) {
+    if (screenDelta.x == 0.0f && screenDelta.y == 0.0f) return;
+    target.x -= screenDelta.x / zoom;
+    target.y -= screenDelta.y / zoom;
+    Clamp();
+    Changed();
+}
+
+void ViewCamera::ZoomAt(Vec2 screenPos, float factor) {
+    float newZoom = min(max(zoom * factor, minZoom), kMaxZoom);
+    if (newZoom == zoom) return;
+    Vec2 pivot = ScreenToWorld(screenPos);
+    zoom = newZoom;
+    target.x = pivot.x - (screenPos.x - anchor.x) / zoom;
+    target.y = pivot.y - (screenPos.y - anchor.y) / zoom;
+    Clamp();
+    Changed();
+}
+
+// Keep the middle of the window over the board so it can't be lost
+void ViewCamera::Clamp() {
+    Vec2 middle = ScreenToWorld({window.x + window.width * 0.5f, window.y + window.height * 0.5f});
+    float x = min(max(middle.x, limits.x), limits.x + limits.width);
+    float y = min(max(middle.y, limits.y), limits.y + limits.height);
+    target.x += x - middle.x;
+    target.y += y - middle.y;
+}
+
+void ViewCamera::Changed() {
+    identity = zoom == 1.0f && target.x == anchor.x && target.y == anchor.y;
+    version++;
+}
+
+Rect ViewCamera::VisibleWorld() const {
+    Vec2 topLeft = ScreenToWorld({window.x, window.y});
+    return {topLeft.x, topLeft.y, window.width / zoom, window.height / zoom};
+}
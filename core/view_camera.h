@@ -0,0 +1,55 @@
+#pragma once
+
+#include "types.h"
+
+// Pan and zoom over the board. Levels live in world space of any size;
+// a world point p is drawn at (p - target) * zoom + anchor on screen.
+//
+// A level that fits the window is shown 1:1 where it was laid out, so
+// every level made for the 1880x1060 playfield looks as it always has.
+// Anything larger starts zoomed out to fit the play area, and from there
+// the player can zoom in around the cursor and drag the board around.
+class ViewCamera {
+public:
+    // `window` is the whole screen, `playArea` the part of it clear of the
+    // HUD that a large board is fitted into
+    void SetViewport(Rect window, Rect playArea);
+    // Home view for a board covering `bounds`
+    void Fit(Rect bounds);
+
+    void Pan(Vec2 screenDelta);
+    // Scale by `factor`, keeping the world point under `screenPos` still
+    void ZoomAt(Vec2 screenPos, float factor);
+
+    // Exact pass-through at the 1:1 view, so those levels see the very
+    // same numbers as before there was a camera
+    Vec2 WorldToScreen(Vec2 world) const {
+        if (identity) return world;
+        return {(world.x - target.x) * zoom + anchor.x, (world.y - target.y) * zoom + anchor.y};
+    }
+    Vec2 ScreenToWorld(Vec2 screen) const {
+        if (identity) return screen;
+        return {(screen.x - anchor.x) / zoom + target.x, (screen.y - anchor.y) / zoom + target.y};
+    }
+    float Zoom() const { return zoom; }
+    // The part of the world the window shows
+    Rect VisibleWorld() const;
+    bool IsIdentity() const { return identity; }
+    // Bumped on every change, for caching what was drawn through it
+    unsigned int Version() const { return version; }
+
+private:
+    void Clamp();
+    void Changed();
+
+    Rect window = {0, 0, 1, 1};
+    Rect playArea = {0, 0, 1, 1};
+    Rect bounds = {0, 0, 0, 0};
+    Rect limits = {0, 0, 0, 0};   // where the middle of the window may go
+    Vec2 target = {0, 0};
+    Vec2 anchor = {0, 0};
+    float zoom = 1.0f;
+    float minZoom = 1.0f;
+    bool identity = true;
+    unsigned int version = 0;
+};
@@ -1,1008 +1,799 @@
-#include "raylib.h"
-#include <vector>
-#include <cmath>
-#include <algorithm>
-
-using namespace std;
-
-// Game has two states: start screen and playing
-enum GameState {
-    START_SCREEN,
-    PLAYING
-};
-
-// Particle struct for drawing effects
-struct Particle {
-    Vector2 position;
-    Vector2 velocity;
-    Color color;
-    float lifetime;
-    float maxLifetime;
-    float size;
-};
-
-// A node is a circle point that players connect
-struct Node {
-    Vector2 position;
-    int id;
-    bool isHighlighted;
-};
-
-// An edge is a line connecting two nodes
-struct Edge {
-    int nodeA;
-    int nodeB;
-    int visitCount;
-};
-
-// Animated dot for start screen
-struct AnimatedDot {
-    Vector2 position;
-    Vector2 velocity;
-    float size;
-    Color color;
-    float speed;
-};
-
-// Main game class
-class OneLinePuzzle {
-private:
-    vector<Node> nodes;
-    vector<Edge> edges;
-    vector<int> currentPath;
-    vector<Vector2> pathPoints;
-    vector<AnimatedDot> animatedDots;
-    vector<Particle> particles;
-    
-    GameState gameState;
-    bool isDrawing;
-    bool levelComplete;
-    int currentLevel;
-    int maxUnlockedLevel;
-    
-    float nodeRadius;
-    float levelStartTime;
-    float levelEndTime;
-    int currentScore;
-    int totalScore;
-    bool timerRunning;
-    
-    Vector2 lastParticleSpawnPos;
-    float particleSpawnTimer;
-    
-    Rectangle startButton;
-    Rectangle resetButton;
-    Rectangle nextLevelButton;
-    Rectangle prevLevelButton;
-    Rectangle hintButton;
-    
-    bool showHintPopup;
-    float hintPopupAlpha;
-    bool hintPopupFadingIn;
-    
-    bool puzzleFailed;
-    float shakeTimer;
-    float shakeIntensity;
-    Vector2 shakeOffset;
-    
-public:
-    OneLinePuzzle() {
-        gameState = START_SCREEN;
-        isDrawing = false;
-        levelComplete = false;
-        currentLevel = 1;
-        maxUnlockedLevel = 1;
-        nodeRadius = 39.2f;
-        levelStartTime = 0.0f;
-        levelEndTime = 0.0f;
-        currentScore = 0;
-        totalScore = 0;
-        timerRunning = false;
-        particleSpawnTimer = 0.0f;
-        lastParticleSpawnPos = {0, 0};
-        showHintPopup = false;
-        hintPopupAlpha = 0.0f;
-        hintPopupFadingIn = false;
-        puzzleFailed = false;
-        shakeTimer = 0.0f;
-        shakeIntensity = 0.0f;
-        shakeOffset = {0, 0};
-        
-        startButton = {679, 471, 522, 131};
-        resetButton = {1567, 177, 261, 92};
-        nextLevelButton = {1567, 883, 261, 92};
-        prevLevelButton = {1280, 883, 261, 92};
-        hintButton = {1567, 295, 261, 92};
-        
-        InitializeAnimatedDots();
-    }
-    
-    void InitializeAnimatedDots() {
-        animatedDots.clear();
-        for (int i = 0; i < 100; i++) {
-            AnimatedDot dot;
-            dot.position.x = (float)(GetRandomValue(0, 1880));
-            dot.position.y = (float)(GetRandomValue(0, 1060));
-            dot.size = 4.0f + (i % 5);
-            dot.speed = 0.5f + (float)(i % 10) * 0.1f;
-            
-            float angle = (float)(i * 37) / 10.0f;
-            dot.velocity.x = cosf(angle) * dot.speed;
-            dot.velocity.y = sinf(angle) * dot.speed;
-            
-            switch(i % 4) {
-                case 0: dot.color = Color{255, 0, 255, 180}; break;
-                case 1: dot.color = Color{0, 255, 255, 180}; break;
-                case 2: dot.color = Color{138, 43, 226, 180}; break;
-                case 3: dot.color = Color{0, 255, 127, 180}; break;
-            }
-            
-            animatedDots.push_back(dot);
-        }
-    }
-    
-    void UpdateAnimatedDots() {
-        for (auto& dot : animatedDots) {
-            dot.position.x += dot.velocity.x;
-            dot.position.y += dot.velocity.y;
-            
-            if (dot.position.x <= 0 || dot.position.x >= 1880) {
-                dot.velocity.x *= -1;
-                dot.position.x = (dot.position.x <= 0) ? 0 : 1880;
-            }
-            if (dot.position.y <= 0 || dot.position.y >= 1060) {
-                dot.velocity.y *= -1;
-                dot.position.y = (dot.position.y <= 0) ? 0 : 1060;
-            }
-        }
-    }
-    
-    int CountOddDegreeNodes() {
-        vector<int> degrees(nodes.size(), 0);
-        
-        for (const auto& edge : edges) {
-            degrees[edge.nodeA]++;
-            degrees[edge.nodeB]++;
-        }
-        
-        int oddCount = 0;
-        for (int degree : degrees) {
-            if (degree % 2 == 1) oddCount++;
-        }
-        
-        return oddCount;
-    }
-    
-    int GetFirstOddDegreeNode() {
-        vector<int> degrees(nodes.size(), 0);
-        
-        for (const auto& edge : edges) {
-            degrees[edge.nodeA]++;
-            degrees[edge.nodeB]++;
-        }
-        
-        for (size_t i = 0; i < degrees.size(); i++) {
-            if (degrees[i] % 2 == 1) {
-                return i;
-            }
-        }
-        
-        return 0; // If all even, can start anywhere
-    }
-    
-    void TriggerShakeAnimation() {
-        puzzleFailed = true;
-        shakeTimer = 0.5f; // 0.5 second shake
-        shakeIntensity = 10.0f;
-    }
-    
-    void UpdateShakeAnimation(float deltaTime) {
-        if (shakeTimer > 0) {
-            shakeTimer -= deltaTime;
-            
-            // Generate random shake offset
-            float angle = (float)GetRandomValue(0, 360) * DEG2RAD;
-            float currentIntensity = shakeIntensity * (shakeTimer / 0.5f);
-            shakeOffset.x = cosf(angle) * currentIntensity;
-            shakeOffset.y = sinf(angle) * currentIntensity;
-            
-            if (shakeTimer <= 0) {
-                shakeOffset = {0, 0};
-                puzzleFailed = false;
-            }
-        }
-    }
-    
-    // Spawn particles along the drawing path
-    void SpawnParticles(Vector2 position) {
-        float distance = CalculateDistance(lastParticleSpawnPos, position);
-        if (distance < 10.0f) return;
-        
-        lastParticleSpawnPos = position;
-        
-        for (int i = 0; i < 3; i++) {
-            Particle p;
-            p.position = position;
-            
-            float angle = (float)GetRandomValue(0, 360) * DEG2RAD;
-            float speed = (float)GetRandomValue(20, 60);
-            p.velocity.x = cosf(angle) * speed;
-            p.velocity.y = sinf(angle) * speed;
-            
-            p.maxLifetime = (float)GetRandomValue(30, 80) / 100.0f;
-            p.lifetime = p.maxLifetime;
-            p.size = (float)GetRandomValue(3, 7);
-            
-            int colorChoice = GetRandomValue(0, 3);
-            switch(colorChoice) {
-                case 0: p.color = Color{255, 0, 255, 255}; break;
-                case 1: p.color = Color{138, 43, 226, 255}; break;
-                case 2: p.color = Color{0, 255, 255, 255}; break;
-                case 3: p.color = Color{255, 100, 255, 255}; break;
-            }
-            
-            particles.push_back(p);
-        }
-    }
-    
-    void UpdateParticles(float deltaTime) {
-        for (auto it = particles.begin(); it != particles.end();) {
-            it->lifetime -= deltaTime;
-            
-            if (it->lifetime <= 0) {
-                it = particles.erase(it);
-            } else {
-                it->position.x += it->velocity.x * deltaTime;
-                it->position.y += it->velocity.y * deltaTime;
-                
-                it->velocity.x *= 0.95f;
-                it->velocity.y *= 0.95f;
-                
-                float alpha = (it->lifetime / it->maxLifetime) * 255;
-                it->color.a = (unsigned char)alpha;
-                
-                ++it;
-            }
-        }
-    }
-    
-    void DrawParticles() {
-        for (const auto& p : particles) {
-            DrawCircleV(p.position, p.size, p.color);
-        }
-    }
-    
-    void DrawGlowText(const char* text, int x, int y, int fontSize, Color color) {
-        for (int i = 3; i > 0; i--) {
-            Color glowColor = color;
-            glowColor.a = 50;
-            DrawText(text, x - i, y, fontSize, glowColor);
-            DrawText(text, x + i, y, fontSize, glowColor);
-            DrawText(text, x, y - i, fontSize, glowColor);
-            DrawText(text, x, y + i, fontSize, glowColor);
-        }
-        DrawText(text, x, y, fontSize, color);
-    }
-    
-    void DrawGlowRect(Rectangle rect, Color color) {
-        for (int i = 4; i > 0; i--) {
-            Color glowColor = color;
-            glowColor.a = 30;
-            Rectangle glowRect = {rect.x - i, rect.y - i, rect.width + i*2, rect.height + i*2};
-            DrawRectangleRounded(glowRect, 0.3f, 8, glowColor);
-        }
-        DrawRectangleRoundedLines(rect, 0.3f, 8, color);
-    }
-    
-    // Enhanced button drawing with light background and glow on hover
-    void DrawNeonButton(Rectangle button, const char* text, Color color, bool disabled = false, bool hovered = false) {
-        Color btnColor = disabled ? Color{150, 150, 150, 255} : color;
-        
-        // Draw light background fill
-        Color bgColor = btnColor;
-        bgColor.a = hovered ? 60 : 30;
-        DrawRectangleRounded(button, 0.3f, 8, bgColor);
-        
-        // Draw glow layers if hovered
-        if (hovered && !disabled) {
-            for (int i = 8; i > 0; i--) {
-                Color glowColor = btnColor;
-                glowColor.a = 20;
-                Rectangle glowRect = {button.x - i, button.y - i, button.width + i*2, button.height + i*2};
-                DrawRectangleRoundedLines(glowRect, 0.3f, 8, glowColor);
-            }
-        }
-        
-        // Draw outline
-        DrawRectangleRoundedLines(button, 0.3f, 8, btnColor);
-        
-        // Draw text with glow if hovered
-        int textWidth = MeasureText(text, 37);
-        int textX = (int)button.x + ((int)button.width - textWidth) / 2;
-        int textY = (int)button.y + 26;
-        
-        if (hovered && !disabled) {
-            for (int i = 3; i > 0; i--) {
-                Color glowColor = btnColor;
-                glowColor.a = 50;
-                DrawText(text, textX - i, textY, 37, glowColor);
-                DrawText(text, textX + i, textY, 37, glowColor);
-                DrawText(text, textX, textY - i, 37, glowColor);
-                DrawText(text, textX, textY + i, 37, glowColor);
-            }
-        }
-        DrawText(text, textX, textY, 37, btnColor);
-    }
-    
-    void DrawHintPopup() {
-        if (!showHintPopup && hintPopupAlpha <= 0) return;
-        
-        // Semi-transparent overlay
-        Color overlayColor = Color{0, 0, 0, (unsigned char)(100 * hintPopupAlpha)};
-        DrawRectangle(0, 0, 1880, 1060, overlayColor);
-        
-        // Popup box
-        Rectangle popupBox = {540, 380, 800, 300};
-        Color popupBg = Color{245, 245, 245, (unsigned char)(255 * hintPopupAlpha)};
-        DrawRectangleRounded(popupBox, 0.2f, 10, popupBg);
-        
-        // Popup border with glow
-        Color borderColor = Color{138, 43, 226, (unsigned char)(255 * hintPopupAlpha)};
-        for (int i = 3; i > 0; i--) {
-            Color glowColor = borderColor;
-            glowColor.a = (unsigned char)(30 * hintPopupAlpha);
-            Rectangle glowRect = {popupBox.x - i, popupBox.y - i, popupBox.width + i*2, popupBox.height + i*2};
-            DrawRectangleRoundedLines(glowRect, 0.2f, 10, glowColor);
-        }
-        DrawRectangleRoundedLines(popupBox, 0.2f, 10, borderColor);
-        
-        // Title
-        const char* title = "HINT";
-        Color titleColor = Color{255, 0, 255, (unsigned char)(255 * hintPopupAlpha)};
-        int titleWidth = MeasureText(title, 60);
-        DrawText(title, 940 - titleWidth / 2, 410, 60, titleColor);
-        
-        // Hint text
-        int oddCount = CountOddDegreeNodes();
-        const char* hintText;
-        Color hintColor = Color{50, 50, 50, (unsigned char)(255 * hintPopupAlpha)};
-        
-        if (oddCount == 0 || oddCount == 2) {
-            if (oddCount == 2) {
-                hintText = "Start from a node with odd connections!";
-            } else {
-                hintText = "You can start from any node!";
-            }
-        } else {
-            hintText = "This puzzle has a solution - keep trying!";
-        }
-        
-        int hintWidth = MeasureText(hintText, 36);
-        DrawText(hintText, 940 - hintWidth / 2, 520, 36, hintColor);
-        
-        // Additional tip
-        const char* tip = "Trace through each line exactly once.";
-        Color tipColor = Color{100, 100, 100, (unsigned char)(255 * hintPopupAlpha)};
-        int tipWidth = MeasureText(tip, 28);
-        DrawText(tip, 940 - tipWidth / 2, 590, 28, tipColor);
-        
-        // Close instruction
-        const char* closeText = "Click anywhere to close";
-        Color closeColor = Color{138, 43, 226, (unsigned char)(200 * hintPopupAlpha)};
-        int closeWidth = MeasureText(closeText, 24);
-        DrawText(closeText, 940 - closeWidth / 2, 640, 24, closeColor);
-    }
-    
-    void DrawStartScreen() {
-        ClearBackground(WHITE);
-        
-        for (const auto& dot : animatedDots) {
-            DrawCircleV(dot.position, dot.size, dot.color);
-        }
-        
-        for (int i = 0; i < 6; i++) {
-            Vector2 start = {196.0f, 141 + i * 143.0f};
-            Vector2 end = {1684.0f, 188 + i * 143.0f};
-            DrawLineEx(start, end, 3.3f, Color{138, 43, 226, 150});
-        }
-        
-        const char* title = "StrokeX";
-        int titleSize = 196;
-        int titleX = 940 - MeasureText(title, titleSize) / 2;
-        DrawGlowText(title, titleX, 165, titleSize, Color{255, 0, 255, 255});
-        
-        const char* subtitle = "One-Stroke Puzzle Challenge";
-        int subSize = 42;
-        int subX = 940 - MeasureText(subtitle, subSize) / 2;
-        DrawText(subtitle, subX, 377, subSize, Color{138, 43, 226, 255});
-        
-        Vector2 mousePos = GetMousePosition();
-        bool hovered = CheckCollisionPointRec(mousePos, startButton);
-        
-        Color buttonColor = hovered ? Color{255, 0, 255, 255} : Color{138, 43, 226, 255};
-        DrawGlowRect(startButton, buttonColor);
-        
-        const char* buttonText = "START";
-        int btnTextSize = 65;
-        int btnTextX = (int)startButton.x + ((int)startButton.width - MeasureText(buttonText, btnTextSize)) / 2;
-        DrawGlowText(buttonText, btnTextX, (int)startButton.y + 33, btnTextSize, buttonColor);
-        
-        const char* inst1 = "Draw through all lines once";
-        const char* inst2 = "without lifting your finger!";
-        DrawText(inst1, 940 - MeasureText(inst1, 36) / 2, 730, 36, Color{138, 43, 226, 255});
-        DrawText(inst2, 940 - MeasureText(inst2, 36) / 2, 777, 36, Color{138, 43, 226, 255});
-        
-        Vector2 corners[4] = {{104, 94}, {1776, 94}, {1776, 966}, {104, 966}};
-        for (int i = 0; i < 4; i++) {
-            for (int j = 0; j < 3; j++) {
-                float radius = 33 + j * 15;
-                Color circleColor = Color{138, 43, 226, (unsigned char)(100 - j * 30)};
-                DrawCircleLines((int)corners[i].x, (int)corners[i].y, radius, circleColor);
-            }
-        }
-    }
-    
-    void LoadLevel(int level) {
-        nodes.clear();
-        edges.clear();
-        currentPath.clear();
-        pathPoints.clear();
-        particles.clear();
-        isDrawing = false;
-        levelComplete = false;
-        timerRunning = false;
-        levelStartTime = 0.0f;
-        levelEndTime = 0.0f;
-        currentScore = 0;
-        showHintPopup = false;
-        hintPopupAlpha = 0.0f;
-        puzzleFailed = false;
-        shakeTimer = 0.0f;
-        
-        switch(level) {
-            case 1:
-                nodes = {
-                    {{940, 441}, 0, false},
-                    {{705, 707}, 1, false},
-                    {{1175, 707}, 2, false}
-                };
-                edges = {
-                    {0,1,0},{1,2,0},{2,0,0}
-                };
-                break;
-                
-            case 2:
-                nodes = {
-                    {{705,353},0,false}, {{940,353},1,false}, {{1175,353},2,false},
-                    {{705,530},3,false}, {{940,530},4,false}, {{1175,530},5,false},
-                    {{705,707},6,false}, {{940,707},7,false}, {{1175,707},8,false}
-                };
-                edges = {
-                    {0,1,0}, {1,2,0}, {2,5,0}, {5,8,0},
-                    {8,7,0}, {7,6,0}, {6,3,0}, {3,0,0},
-                    {1,4,0}, {4,6,0}
-                };
-                break;
-                
-            case 3:
-                nodes = {
-                    {{940, 318}, 0, false}, {{1175, 495}, 1, false},
-                    {{1081, 742}, 2, false}, {{799, 742}, 3, false},
-                    {{705, 495}, 4, false}
-                };
-                edges = {
-                    {0, 1, 0}, {1, 2, 0}, {2, 3, 0}, {3, 4, 0}, {4, 0, 0},
-                    {0, 2, 0}, {1, 3, 0}, {2, 4, 0}, {3, 0, 0}, {4, 1, 0}
-                };
-                break;
-                
-            case 4:
-                nodes = {
-                    {{705, 441}, 0, false}, {{940, 441}, 1, false}, {{1175, 441}, 2, false},
-                    {{705, 707}, 3, false}, {{940, 707}, 4, false}, {{1175, 707}, 5, false}
-                };
-                edges = {
-                    {0, 1, 0}, {1, 2, 0}, {3, 4, 0}, {4, 5, 0},
-                    {0, 3, 0}, {1, 4, 0}, {2, 5, 0}
-                };
-                break;
-                
-            case 5:
-                nodes = {
-                    {{588, 353}, 0, false}, {{822, 353}, 1, false},
-                    {{1057, 353}, 2, false}, {{1292, 353}, 3, false},
-                    {{705, 618}, 4, false}, {{940, 618}, 5, false},
-                    {{1175, 618}, 6, false}
-                };
-                edges = {
-                    {0, 1, 0}, {0, 4, 0}, {1, 2, 0}, {1, 4, 0},
-                    {1, 5, 0}, {2, 3, 0}, {2, 5, 0}, {2, 6, 0},
-                    {3, 6, 0}, {4, 5, 0}, {5, 6, 0}
-                };
-                break;
-                
-            case 6:
-                nodes = {
-                    {{940, 353}, 0, false}, {{822, 530}, 1, false},
-                    {{1057, 530}, 2, false}, {{940, 795}, 3, false}
-                };
-                edges = {
-                    {0, 1, 0}, {0, 2, 0}, {1, 2, 0}, {1, 3, 0}, {2, 3, 0}
-                };
-                break;
-                
-            case 7:
-                nodes = {
-                    {{940, 353}, 0, false}, {{705, 530}, 1, false},
-                    {{1175, 530}, 2, false}, {{1175, 795}, 3, false},
-                    {{705, 795}, 4, false}
-                };
-                edges = {
-                    {0, 1, 0}, {0, 2, 0}, {1, 2, 0},
-                    {1, 4, 0}, {2, 3, 0}, {3, 4, 0}
-                };
-                break;
-                
-            case 8:
-                nodes = {
-                    {{658, 318}, 0, false}, {{1128, 318}, 1, false},
-                    {{1363, 565}, 2, false}, {{1128, 795}, 3, false},
-                    {{658, 795}, 4, false}
-                };
-                edges = {
-                    {0, 1, 0}, {0, 4, 0}, {1, 2, 0},
-                    {1, 3, 0}, {1, 4, 0}, {2, 3, 0}, {3, 4, 0}
-                };
-                break;
-                
-            case 9:
-                nodes = {
-                    {{705, 353}, 0, false}, {{1175, 353}, 1, false},
-                    {{1410, 618}, 2, false}, {{1175, 795}, 3, false},
-                    {{705, 795}, 4, false}, {{470, 618}, 5, false}
-                };
-                edges = {
-                    {0, 1, 0}, {0, 5, 0}, {1, 2, 0},
-                    {1, 4, 0}, {2, 3, 0}, {3, 4, 0}, {4, 5, 0}
-                };
-                break;
-                
-            case 10:
-                nodes = {
-                    {{940,353},0,false},
-                    {{822,530},1,false}, {{1057,530},2,false},
-                    {{940,707},3,false},
-                    {{1292,530},4,false}
-                };
-                edges = {
-                    {0,1,0},{0,2,0},{1,3,0},{2,3,0},
-                    {2,4,0}
-                };
-                break;
-                
-            case 11:
-                nodes = {
-                    {{705, 353}, 0, false}, {{822, 283}, 1, false},
-                    {{940, 353}, 2, false}, {{940, 495}, 3, false},
-                    {{822, 565}, 4, false}, {{705, 495}, 5, false},
-                    {{1057, 283}, 6, false}, {{1175, 353}, 7, false},
-                    {{1175, 495}, 8, false}, {{1057, 565}, 9, false}
-                };
-                edges = {
-                    {0, 1, 0}, {1, 2, 0}, {2, 3, 0}, {3, 4, 0},
-                    {4, 5, 0}, {5, 0, 0}, {2, 6, 0}, {6, 7, 0},
-                    {7, 8, 0}, {8, 9, 0}, {9, 3, 0}
-                };
-                break;
-                
-            case 12:
-                nodes = {
-                    {{822,441},0,false}, {{705,618},1,false},
-                    {{940,618},2,false}, {{1175,618},3,false}
-                };
-                edges = {
-                    {0,1,0},{0,2,0},{1,2,0},
-                    {2,3,0}
-                };
-                break;
-                
-            case 13:
-                nodes = {
-                    {{822,441},0,false}, {{1057,441},1,false},
-                    {{940,530},2,false},
-                    {{822,618},3,false}, {{1057,618},4,false}
-                };
-                edges = {
-                    {0,1,0},{1,2,0},{2,0,0},
-                    {2,3,0},{3,4,0},{4,2,0}
-                };
-                break;
-                
-            case 14:
-                nodes = {
-                    {{658, 389}, 0, false}, {{940, 389}, 1, false},
-                    {{1222, 389}, 2, false}, {{658, 707}, 3, false},
-                    {{1222, 707}, 4, false}
-                };
-                edges = {
-                    {0, 1, 0}, {1, 2, 0}, {1, 4, 0}, {0, 3, 0}, {3, 4, 0}
-                };
-                break;
-                
-            default:
-                currentLevel = 1;
-                LoadLevel(1);
-                break;
-        }
-    }
-    
-    bool AreNodesConnected(int nodeA, int nodeB) {
-        for (const auto& edge : edges) {
-            if ((edge.nodeA == nodeA && edge.nodeB == nodeB) ||
-                (edge.nodeA == nodeB && edge.nodeB == nodeA)) {
-                return true;
-            }
-        }
-        return false;
-    }
-    
-    void MarkEdgeVisited(int nodeA, int nodeB) {
-        for (auto& edge : edges) {
-            if ((edge.nodeA == nodeA && edge.nodeB == nodeB) ||
-                (edge.nodeA == nodeB && edge.nodeB == nodeA)) {
-                edge.visitCount++;
-                return;
-            }
-        }
-    }
-    
-    int GetEdgeVisitCount(int nodeA, int nodeB) {
-        for (const auto& edge : edges) {
-            if ((edge.nodeA == nodeA && edge.nodeB == nodeB) ||
-                (edge.nodeA == nodeB && edge.nodeB == nodeA)) {
-                return edge.visitCount;
-            }
-        }
-        return 0;
-    }
-    
-    float CalculateDistance(Vector2 a, Vector2 b) {
-        float dx = b.x - a.x;
-        float dy = b.y - a.y;
-        return sqrtf(dx * dx + dy * dy);
-    }
-    
-    int GetNodeAtPosition(Vector2 pos) {
-        for (const auto& node : nodes) {
-            float distance = CalculateDistance(pos, node.position);
-            if (distance <= nodeRadius) {
-                return node.id;
-            }
-        }
-        return -1;
-    }
-    
-    void StartPath(int nodeId) {
-        ResetPath();
-        currentPath.push_back(nodeId);
-        pathPoints.push_back(nodes[nodeId].position);
-        isDrawing = true;
-        lastParticleSpawnPos = nodes[nodeId].position;
-        
-        if (!timerRunning) {
-            levelStartTime = GetTime();
-            timerRunning = true;
-        }
-    }
-    
-    void UpdatePath(Vector2 mousePos) {
-        if (currentPath.empty()) return;
-        
-        int lastNode = currentPath.back();
-        int nearestNode = GetNodeAtPosition(mousePos);
-        
-        if (nearestNode != -1 && nearestNode != lastNode) {
-            if (AreNodesConnected(lastNode, nearestNode)) {
-                currentPath.push_back(nearestNode);
-                pathPoints.push_back(nodes[nearestNode].position);
-                MarkEdgeVisited(lastNode, nearestNode);
-            }
-        }
-    }
-    
-    void ResetPath() {
-        currentPath.clear();
-        pathPoints.clear();
-        particles.clear();
-        isDrawing = false;
-        
-        for (auto& edge : edges) {
-            edge.visitCount = 0;
-        }
-        
-        for (auto& node : nodes) {
-            node.isHighlighted = false;
-        }
-    }
-    
-    int CalculateScore(float timeTaken) {
-        int baseScore = 100;
-        int timePenalty = (int)(timeTaken * 2);
-        int score = max(20, baseScore - timePenalty);
-        return score;
-    }
-    
-    void CheckSolution() {
-        bool allVisitedOnce = true;
-        bool anyVisitedTwice = false;
-        
-        for (const auto& edge : edges) {
-            if (edge.visitCount != 1) {
-                allVisitedOnce = false;
-            }
-            if (edge.visitCount > 1) {
-                anyVisitedTwice = true;
-            }
-        }
-        
-        if (allVisitedOnce) {
-            levelComplete = true;
-            levelEndTime = GetTime();
-            float timeTaken = levelEndTime - levelStartTime;
-            currentScore = CalculateScore(timeTaken);
-            totalScore += currentScore;
-            
-            if (currentLevel == maxUnlockedLevel && currentLevel < 14) {
-                maxUnlockedLevel = currentLevel + 1;
-            }
-        } else if (anyVisitedTwice) {
-            // Puzzle failed - trigger shake
-            TriggerShakeAnimation();
-        }
-    }
-    
-    float GetCurrentTime() {
-        if (!timerRunning) return 0.0f;
-        if (levelComplete) return levelEndTime - levelStartTime;
-        return GetTime() - levelStartTime;
-    }
-    
-    void Update() {
-        Vector2 mousePos = GetMousePosition();
-        float deltaTime = GetFrameTime();
-        
-        if (gameState == START_SCREEN) {
-            UpdateAnimatedDots();
-            
-            if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
-                if (CheckCollisionPointRec(mousePos, startButton)) {
-                    gameState = PLAYING;
-                    LoadLevel(currentLevel);
-                }
-            }
-            return;
-        }
-        
-        UpdateParticles(deltaTime);
-        UpdateShakeAnimation(deltaTime);
-        
-        // Update hint popup fade
-        if (showHintPopup && hintPopupFadingIn) {
-            hintPopupAlpha += deltaTime * 4.0f;
-            if (hintPopupAlpha >= 1.0f) {
-                hintPopupAlpha = 1.0f;
-                hintPopupFadingIn = false;
-            }
-        } else if (!showHintPopup && hintPopupAlpha > 0) {
-            hintPopupAlpha -= deltaTime * 4.0f;
-            if (hintPopupAlpha < 0) {
-                hintPopupAlpha = 0;
-            }
-        }
-        
-        // Handle hint popup clicks
-        if (showHintPopup && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
-            showHintPopup = false;
-        }
-        
-        if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON) && !showHintPopup) {
-            if (CheckCollisionPointRec(mousePos, resetButton)) {
-                ResetPath();
-                return;
-            }
-            if (CheckCollisionPointRec(mousePos, hintButton)) {
-                showHintPopup = true;
-                hintPopupFadingIn = true;
-                return;
-            }
-            if (CheckCollisionPointRec(mousePos, nextLevelButton)) {
-                if (currentLevel < maxUnlockedLevel) {
-                    currentLevel++;
-                    LoadLevel(currentLevel);
-                }
-                return;
-            }
-            if (CheckCollisionPointRec(mousePos, prevLevelButton)) {
-                if (currentLevel > 1) {
-                    currentLevel--;
-                    LoadLevel(currentLevel);
-                }
-                return;
-            }
-        }
-        
-        if (levelComplete || showHintPopup) return;
-        
-        if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
-            int nodeId = GetNodeAtPosition(mousePos);
-            if (nodeId != -1) {
-                StartPath(nodeId);
-            }
-        }
-        
-        if (IsMouseButtonDown(MOUSE_LEFT_BUTTON) && isDrawing) {
-            SpawnParticles(mousePos);
-            UpdatePath(mousePos);
-        }
-        
-        if (IsMouseButtonReleased(MOUSE_LEFT_BUTTON) && isDrawing) {
-            CheckSolution();
-            isDrawing = false;
-        }
-        
-        for (auto& node : nodes) {
-            node.isHighlighted = false;
-        }
-        
-        if (!levelComplete && !isDrawing) {
-            int hoveredNode = GetNodeAtPosition(mousePos);
-            if (hoveredNode != -1) {
-                nodes[hoveredNode].isHighlighted = true;
-            }
-        }
-    }
-    
-    void DrawGame() {
-        ClearBackground(Color{245, 245, 245, 255});
-        Vector2 mousePos = GetMousePosition();
-        
-        // Apply shake offset to all game elements
-        Vector2 offset = shakeOffset;
-        
-        DrawText("StrokeX", 39 + (int)offset.x, 35 + (int)offset.y, 52, Color{255, 0, 255, 255});
-        DrawText(TextFormat("Level: %d / %d", currentLevel, maxUnlockedLevel), 
-                39 + (int)offset.x, 94 + (int)offset.y, 39, DARKGRAY);
-        
-        float currentTime = GetCurrentTime();
-        Rectangle timerBox = {1567 + offset.x, 35 + offset.y, 261, 92};
-        bool timerHovered = CheckCollisionPointRec(mousePos, timerBox);
-        DrawNeonButton(timerBox, TextFormat("%.1fs", currentTime), Color{135, 60, 190, 255}, false, timerHovered);
-        
-        Rectangle shiftedResetBtn = {resetButton.x + offset.x, resetButton.y + offset.y, resetButton.width, resetButton.height};
-        bool resetHovered = CheckCollisionPointRec(mousePos, shiftedResetBtn);
-        DrawNeonButton(shiftedResetBtn, "RESET", Color{255, 100, 100, 255}, false, resetHovered);
-        
-        Rectangle shiftedHintBtn = {hintButton.x + offset.x, hintButton.y + offset.y, hintButton.width, hintButton.height};
-        bool hintHovered = CheckCollisionPointRec(mousePos, shiftedHintBtn);
-        DrawNeonButton(shiftedHintBtn, "HINT", Color{255, 200, 0, 255}, false, hintHovered);
-        
-        DrawText(TextFormat("Score: %d", totalScore), 39 + (int)offset.x, 153 + (int)offset.y, 36, DARKGRAY);
-        
-        for (const auto& edge : edges) {
-            Vector2 start = {nodes[edge.nodeA].position.x + offset.x, nodes[edge.nodeA].position.y + offset.y};
-            Vector2 end = {nodes[edge.nodeB].position.x + offset.x, nodes[edge.nodeB].position.y + offset.y};
-            
-            Color lineColor;
-            float thickness = 6.5f;
-            
-            if (edge.visitCount == 0) {
-                lineColor = Color{200, 200, 200, 255};
-            } else if (edge.visitCount == 1) {
-                lineColor = Color{100, 200, 100, 255};
-                thickness = 9.8f;
-            } else {
-                lineColor = Color{255, 50, 50, 255};
-                thickness = 13.1f;
-            }
-            
-            DrawLineEx(start, end, thickness, lineColor);
-        }
-        
-        if (pathPoints.size() > 1) {
-            for (size_t i = 0; i < pathPoints.size() - 1; i++) {
-                Vector2 p1 = {pathPoints[i].x + offset.x, pathPoints[i].y + offset.y};
-                Vector2 p2 = {pathPoints[i + 1].x + offset.x, pathPoints[i + 1].y + offset.y};
-                
-                int nodeA = currentPath[i];
-                int nodeB = currentPath[i + 1];
-                int visitCount = GetEdgeVisitCount(nodeA, nodeB);
-                
-                Color pathColor = (visitCount > 1) ? 
-                    Color{255, 50, 50, 255} : Color{138, 43, 226, 255};
-                DrawLineEx(p1, p2, 13.1f, pathColor);
-            }
-        }
-        
-        if (isDrawing && !pathPoints.empty()) {
-            Vector2 lastPoint = {pathPoints.back().x + offset.x, pathPoints.back().y + offset.y};
-            DrawLineEx(lastPoint, mousePos, 9.8f, Color{138, 43, 226, 150});
-        }
-        
-        DrawParticles();
-        
-        for (const auto& node : nodes) {
-            Vector2 nodePos = {node.position.x + offset.x, node.position.y + offset.y};
-            
-            Color outerColor = node.isHighlighted ? 
-                Color{138, 43, 226, 255} : Color{100, 100, 255, 255};
-            DrawCircleV(nodePos, nodeRadius, outerColor);
-            DrawCircleV(nodePos, nodeRadius - 6.5f, WHITE);
-            
-            if (find(currentPath.begin(), currentPath.end(), node.id) != currentPath.end()) {
-                DrawCircleV(nodePos, nodeRadius - 13.1f, Color{138, 43, 226, 200});
-            }
-        }
-        
-        Rectangle shiftedPrevBtn = {prevLevelButton.x + offset.x, prevLevelButton.y + offset.y, prevLevelButton.width, prevLevelButton.height};
-        bool prevHovered = CheckCollisionPointRec(mousePos, shiftedPrevBtn);
-        DrawNeonButton(shiftedPrevBtn, "PREV", Color{100, 150, 255, 255}, false, prevHovered);
-
-        Rectangle shiftedNextBtn = {nextLevelButton.x + offset.x, nextLevelButton.y + offset.y, nextLevelButton.width, nextLevelButton.height};
-        bool nextHovered = CheckCollisionPointRec(mousePos, shiftedNextBtn);
-        bool nextLevelLocked = (currentLevel >= maxUnlockedLevel);
-        DrawNeonButton(shiftedNextBtn, "NEXT", Color{100, 200, 100, 255}, nextLevelLocked, nextHovered);
-        if (nextLevelLocked && !levelComplete) {
-            DrawText("LOCKED", (int)shiftedNextBtn.x + 46, (int)shiftedNextBtn.y + 98, 26, 
-                    Color{150, 150, 150, 255});
-        }
-        
-        if (levelComplete) {
-            DrawRectangle(0, 0, 1880, 1060, Color{0, 0, 0, 150});
-            DrawText("LEVEL COMPLETE!", 654, 389, 70, Color{100, 255, 100, 255});
-            DrawText(TextFormat("+%d points!", currentScore), 823, 483, 52, Color{255, 215, 0, 255});
-            DrawText(TextFormat("Time: %.1fs", levelEndTime - levelStartTime), 875, 553, 42, WHITE);
-            DrawText("Press NEXT for next level", 693, 624, 42, WHITE);
-        }
-        
-        DrawText("Draw through all lines once without lifting!", 39 + (int)offset.x, 977 + (int)offset.y, 32, DARKGRAY);
-        
-        // Draw hint popup on top of everything
-        DrawHintPopup();
-    }
-    
-    void Draw() {
-        if (gameState == START_SCREEN) {
-            DrawStartScreen();
-        } else {
-            DrawGame();
-        }
-    }
-};
-
-int main() {
-    const int screenWidth = 1880;
-    const int screenHeight = 1060;
-    InitWindow(screenWidth, screenHeight, "STROKEX - One-Stroke Puzzle Game");
-    SetTargetFPS(60);
-    
-    InitAudioDevice();
-    Music backgroundMusic = LoadMusicStream("C:/Users/cW/Downloads/Cinema Sins Background Song (Clowning Around) - Background Music (HD).mp3");
-    SetMusicVolume(backgroundMusic, 0.5f);
-    PlayMusicStream(backgroundMusic);
-    
-    OneLinePuzzle game;
-    
-    while (!WindowShouldClose()) {
-        UpdateMusicStream(backgroundMusic);
-        game.Update();
-        
-        BeginDrawing();
-        game.Draw();
-        EndDrawing();
-    }
-    
-    UnloadMusicStream(backgroundMusic);
-    CloseAudioDevice();
-    CloseWindow();
-    return 0;
-}
\ No newline at end of file
+#include "raylib.h"
+#include "core/profiler.h"
+#include "core/progress_store.h"
+#include "core/puzzle_core.h"
+#include "core/replay.h"
+#include "core/simulation_thread.h"
+#include "platform/game_assets.h"
+#include "platform/mouse_poller.h"
+#include "render/bloom.h"
+#include "render/layer_cache.h"
+#include "render/sprite_atlas.h"
+#include <vector>
+#include <cmath>
+#include <ctime>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+using namespace std;
+
+static Vector2 ToRay(Vec2 v) { return Vector2{v.x, v.y}; }
+static Color ToRay(Rgba c) { return Color{c.r, c.g, c.b, c.a}; }
+static Rectangle ToRay(Rect r) { return Rectangle{r.x, r.y, r.width, r.height}; }
+
+// Level of detail on zoomed-out boards, by how big things get on screen
+static const float kFullDetailRadius = 12.0f;   // node radius for inner rings
+static const float kMinNodeRadius = 2.5f;       // smaller nodes are left out
+static const float kHairlineWidth = 1.5f;       // thinner edges become 1 px lines
+static const float kParticleMinZoom = 0.25f;
+static const int kHintLookahead = 3;            // trail edges shown after the next one
+static const float kHintSparkSpeed = 1.25f;     // runs along the next edge per second
+// Widest a fanned-out parallel edge sits off its nodes, and the shake
+static const float kMaxLaneOffset = 36.0f;
+static const float kMaxShake = 10.0f;
+
+// Input backed by raylib's mouse polling, plus the sub-frame cursor trail
+// from the polling thread where the platform allows one
+class RaylibInput : public InputSource {
+public:
+    RaylibInput() {
+        if (!poller.Start(GetWindowHandle(), GetTime())) {
+            TraceLog(LOG_INFO, "No cursor polling thread, sampling the mouse once per frame");
+        }
+    }
+
+    FrameInput Poll() override {
+        Vector2 mousePos = GetMousePosition();
+        FrameInput input;
+        input.mousePos = {mousePos.x, mousePos.y};
+        input.mouseDown = IsMouseButtonDown(MOUSE_LEFT_BUTTON);
+        input.mousePressed = IsMouseButtonPressed(MOUSE_LEFT_BUTTON);
+        input.mouseReleased = IsMouseButtonReleased(MOUSE_LEFT_BUTTON);
+        input.autoSolvePressed = IsKeyPressed(KEY_S);
+        // D opens today's generated puzzle
+        if (IsKeyPressed(KEY_D)) input.dailyRequest = (int)(time(nullptr) / 86400);
+        // Wheel zooms, right or middle drag pans
+        input.wheel = GetMouseWheelMove();
+        input.panDown = IsMouseButtonDown(MOUSE_RIGHT_BUTTON) || IsMouseButtonDown(MOUSE_MIDDLE_BUTTON);
+        if (poller.IsRunning()) {
+            input.samples = samples;
+            input.sampleCount = poller.Drain(samples, FrameInput::kMaxSamples);
+        }
+        return input;
+    }
+
+private:
+    MousePoller poller;
+    InputSample samples[FrameInput::kMaxSamples];
+};
+
+// Windowed game: feeds raylib input into the core and draws its state
+class OneLinePuzzle {
+private:
+    // Set from raylib's timer once per frame, so a recording sees exactly
+    // what the core saw
+    FrameClock clock;
+    RaylibInput input;
+    ProgressStore progress;
+    PuzzleCore core;
+    GameAssets& assets;
+    InputRecorder recorder;
+    // Runs the core between the constructor and the destructor; drawing
+    // only reads the snapshots it publishes
+    SimulationThread sim;
+    const FrameSnapshot* frame = nullptr;
+    SpriteAtlas atlas;
+    BloomPass bloom;
+
+    // Static parts of the game screen, redrawn only when their inputs change
+    CachedLayer hudLayer;
+    CachedLayer edgeLayer;
+    CachedLayer nodeLayer;
+
+#ifdef STROKEX_PROFILING
+    bool showProfiler = false;
+#endif
+
+public:
+    OneLinePuzzle(GameAssets& assets, int backgroundDots, const char* packPath, const char* recordPath,
+                  const char* savePath)
+        : core(clock, (unsigned int)time(nullptr)), assets(assets), sim(core, clock, &recorder) {
+        core.SetBackground(backgroundDots, Rect{0, 0, (float)GetScreenWidth(), (float)GetScreenHeight()});
+        // Saving runs on its own thread; a recording still saves but starts
+        // from level 1 so it replays like any other
+        if (progress.Open(savePath)) {
+            core.AttachProgressStore(&progress, recordPath == nullptr);
+            TraceLog(LOG_INFO, "Loaded progress from %s in %.1f us", savePath, progress.LoadMicros());
+            if (progress.DroppedBytes() > 0) {
+                TraceLog(LOG_WARNING, "%s: dropped %lld damaged bytes", savePath, progress.DroppedBytes());
+            }
+        } else {
+            TraceLog(LOG_WARNING, "%s is not a progress file, progress won't be saved", savePath);
+        }
+        // Normally the pack arrives from the asset loader a few frames in.
+        // A recording has to be replayed on the pack it was made with from
+        // its first frame, so it opens the pack here instead.
+        if (recordPath) {
+            if (!core.OpenLevelPack(packPath)) {
+                TraceLog(LOG_WARNING, "%s not found, using generated levels", packPath);
+            }
+            if (!recorder.Begin(recordPath, core.GetSeed(), core.GetPackHash())) {
+                TraceLog(LOG_WARNING, "Can't record to %s", recordPath);
+            }
+        }
+        atlas.Load();
+        bloom.Load(GetScreenWidth(), GetScreenHeight());
+        hudLayer.Load(GetScreenWidth(), GetScreenHeight());
+        edgeLayer.Load(GetScreenWidth(), GetScreenHeight());
+        nodeLayer.Load(GetScreenWidth(), GetScreenHeight());
+
+        // Culling has to keep everything that can reach into the view: a
+        // node's circle or a fanned-out lane, and the shake
+        sim.SetCullMargin(max(core.GetNodeRadius(), kMaxLaneOffset + 13.1f), kMaxShake);
+        sim.Start();
+    }
+
+    ~OneLinePuzzle() {
+        sim.Stop();
+        if (recorder.IsRecording()) recorder.Finish(core.GetTotalScore(), core.GetMaxUnlockedLevel());
+        nodeLayer.Unload();
+        edgeLayer.Unload();
+        hudLayer.Unload();
+        bloom.Unload();
+        atlas.Unload();
+    }
+
+    void Update() {
+#ifdef STROKEX_PROFILING
+        // F3 toggles the frame-time overlay, F4 saves the recent zones
+        if (IsKeyPressed(KEY_F3)) showProfiler = !showProfiler;
+        if (IsKeyPressed(KEY_F4)) {
+            const char* path = "strokex_trace.json";
+            if (Profiler::Get().WriteChromeTrace(path)) {
+                TraceLog(LOG_INFO, "Wrote %s", path);
+            } else {
+                TraceLog(LOG_WARNING, "Can't write %s", path);
+            }
+        }
+#endif
+        // The level pack goes over with the input, so the core takes it
+        // between the same two frames it would have on this thread
+        assets.Poll();
+        LevelPack pack;
+        if (assets.TakeLevelPack(pack)) sim.PostLevelPack(pack);
+        sim.PostFrame(GetTime(), GetFrameTime(), input.Poll());
+
+        // Draw whatever the simulation has finished most recently, which
+        // may be this frame or the one before; only the very first frame
+        // waits for it
+        if (!frame) sim.Flush();
+        frame = sim.Acquire();
+    }
+
+    // World point on screen, shaken by offset
+    Vector2 ToScreen(Vec2 world, Vector2 offset) {
+        Vec2 screen = frame->view.WorldToScreen(world);
+        return Vector2{screen.x + offset.x, screen.y + offset.y};
+    }
+
+    void DrawParticles() {
+        PROFILE_ZONE("DrawParticles");
+        // Sparks shrink with the board; once under a pixel they go
+        float zoom = frame->view.Zoom();
+        if (zoom < kParticleMinZoom) return;
+        atlas.BeginBatch();
+        for (const SnapshotSprite& particle : frame->particles) {
+            atlas.DrawSprite(SPRITE_DISC, ToScreen(particle.pos, Vector2{0, 0}), particle.size * zoom, ToRay(particle.color));
+        }
+        atlas.EndBatch();
+    }
+
+    // Glow comes from the bloom pass when available; the layered copies
+    // below are the fallback for GPUs without GLSL 3.30
+    void DrawGlowText(const char* text, int x, int y, int fontSize, Color color) {
+        PROFILE_ZONE("DrawGlowText");
+        if (bloom.IsReady()) {
+            bloom.AddText(text, x, y, fontSize, color);
+            DrawText(text, x, y, fontSize, color);
+            return;
+        }
+        for (int i = 3; i > 0; i--) {
+            Color glowColor = color;
+            glowColor.a = 50;
+            DrawText(text, x - i, y, fontSize, glowColor);
+            DrawText(text, x + i, y, fontSize, glowColor);
+            DrawText(text, x, y - i, fontSize, glowColor);
+            DrawText(text, x, y + i, fontSize, glowColor);
+        }
+        DrawText(text, x, y, fontSize, color);
+    }
+
+    void DrawGlowRect(Rectangle rect, Color color) {
+        PROFILE_ZONE("DrawGlowRect");
+        if (bloom.IsReady()) {
+            bloom.AddRoundedOutline(rect, 0.3f, 8.0f, color);
+            DrawRectangleRoundedLines(rect, 0.3f, 8, color);
+            return;
+        }
+        for (int i = 4; i > 0; i--) {
+            Color glowColor = color;
+            glowColor.a = 30;
+            Rectangle glowRect = {rect.x - i, rect.y - i, rect.width + i*2, rect.height + i*2};
+            DrawRectangleRounded(glowRect, 0.3f, 8, glowColor);
+        }
+        DrawRectangleRoundedLines(rect, 0.3f, 8, color);
+    }
+
+    // Register a hovered button's outline and label with the bloom pass
+    void AddNeonButtonGlow(Rectangle button, const char* text, Color color) {
+        int textX = (int)button.x + ((int)button.width - MeasureText(text, 37)) / 2;
+        bloom.AddRoundedOutline(button, 0.3f, 6.0f, color);
+        bloom.AddText(text, textX, (int)button.y + 26, 37, color);
+    }
+
+    // Enhanced button drawing with light background and glow on hover.
+    // Pass addGlow = false when drawing into a cached layer; the caller then
+    // registers the glow itself every frame with AddNeonButtonGlow.
+    void DrawNeonButton(Rectangle button, const char* text, Color color, bool disabled = false, bool hovered = false, bool addGlow = true) {
+        Color btnColor = disabled ? Color{150, 150, 150, 255} : color;
+
+        // Draw light background fill
+        Color bgColor = btnColor;
+        bgColor.a = hovered ? 60 : 30;
+        DrawRectangleRounded(button, 0.3f, 8, bgColor);
+
+        bool glowing = hovered && !disabled;
+        bool layeredGlow = glowing && !bloom.IsReady();
+
+        // Draw glow layers if hovered
+        if (layeredGlow) {
+            for (int i = 8; i > 0; i--) {
+                Color glowColor = btnColor;
+                glowColor.a = 20;
+                Rectangle glowRect = {button.x - i, button.y - i, button.width + i*2, button.height + i*2};
+                DrawRectangleRoundedLines(glowRect, 0.3f, 8, glowColor);
+            }
+        }
+
+        // Draw outline
+        DrawRectangleRoundedLines(button, 0.3f, 8, btnColor);
+
+        // Draw text with glow if hovered
+        int textWidth = MeasureText(text, 37);
+        int textX = (int)button.x + ((int)button.width - textWidth) / 2;
+        int textY = (int)button.y + 26;
+
+        if (layeredGlow) {
+            for (int i = 3; i > 0; i--) {
+                Color glowColor = btnColor;
+                glowColor.a = 50;
+                DrawText(text, textX - i, textY, 37, glowColor);
+                DrawText(text, textX + i, textY, 37, glowColor);
+                DrawText(text, textX, textY - i, 37, glowColor);
+                DrawText(text, textX, textY + i, 37, glowColor);
+            }
+        }
+        DrawText(text, textX, textY, 37, btnColor);
+
+        if (glowing && bloom.IsReady() && addGlow) {
+            AddNeonButtonGlow(button, text, btnColor);
+        }
+    }
+
+    void DrawHintPopup() {
+        float hintPopupAlpha = frame->hintPopupAlpha;
+        if (!frame->hintPopupVisible && hintPopupAlpha <= 0) return;
+
+        // Semi-transparent overlay
+        Color overlayColor = Color{0, 0, 0, (unsigned char)(100 * hintPopupAlpha)};
+        DrawRectangle(0, 0, 1880, 1060, overlayColor);
+
+        // Popup box
+        Rectangle popupBox = {540, 380, 800, 300};
+        Color popupBg = Color{245, 245, 245, (unsigned char)(255 * hintPopupAlpha)};
+        DrawRectangleRounded(popupBox, 0.2f, 10, popupBg);
+
+        // Popup border with glow
+        Color borderColor = Color{138, 43, 226, (unsigned char)(255 * hintPopupAlpha)};
+        if (bloom.IsReady()) {
+            bloom.AddRoundedOutline(popupBox, 0.2f, 6.0f, borderColor);
+        } else {
+            for (int i = 3; i > 0; i--) {
+                Color glowColor = borderColor;
+                glowColor.a = (unsigned char)(30 * hintPopupAlpha);
+                Rectangle glowRect = {popupBox.x - i, popupBox.y - i, popupBox.width + i*2, popupBox.height + i*2};
+                DrawRectangleRoundedLines(glowRect, 0.2f, 10, glowColor);
+            }
+        }
+        DrawRectangleRoundedLines(popupBox, 0.2f, 10, borderColor);
+
+        // Title
+        const char* title = "HINT";
+        Color titleColor = Color{255, 0, 255, (unsigned char)(255 * hintPopupAlpha)};
+        int titleWidth = MeasureText(title, 60);
+        DrawText(title, 940 - titleWidth / 2, 410, 60, titleColor);
+
+        // Hint text from the solver's verdict on the current path
+        const char* hintText;
+        Color hintColor = Color{50, 50, 50, (unsigned char)(255 * hintPopupAlpha)};
+
+        if (!frame->hintReady) {
+            hintText = "Working out the next move...";
+        } else switch (frame->hintStatus) {
+            case SOLVE_OK:
+                if (frame->pathEmpty) {
+                    hintText = (frame->hintOddNodes == 2) ?
+                        "Start from the glowing odd node!" : "Start from the glowing node!";
+                } else {
+                    hintText = "Follow the glowing line to keep going!";
+                }
+                break;
+            case SOLVE_ALREADY_COMPLETE:
+                hintText = "Every line is traced - let go to finish!";
+                break;
+            case SOLVE_TOO_MANY_ODD:
+            case SOLVE_NO_EDGES:
+                hintText = "This puzzle has no one-stroke solution!";
+                break;
+            default:
+                hintText = "Dead end from here - press RESET!";
+                break;
+        }
+
+        int hintWidth = MeasureText(hintText, 36);
+        DrawText(hintText, 940 - hintWidth / 2, 520, 36, hintColor);
+
+        // Additional tip
+        const char* tip = "Trace through each line exactly once.";
+        Color tipColor = Color{100, 100, 100, (unsigned char)(255 * hintPopupAlpha)};
+        int tipWidth = MeasureText(tip, 28);
+        DrawText(tip, 940 - tipWidth / 2, 590, 28, tipColor);
+
+        // Close instruction
+        const char* closeText = "Click anywhere to close  -  press S to auto-solve";
+        Color closeColor = Color{138, 43, 226, (unsigned char)(200 * hintPopupAlpha)};
+        int closeWidth = MeasureText(closeText, 24);
+        DrawText(closeText, 940 - closeWidth / 2, 640, 24, closeColor);
+
+        bloom.Composite(hintPopupAlpha);
+    }
+
+    // Pulse the solver's next step: the start node before tracing begins,
+    // otherwise the next edge to trace, with a spark running along it the
+    // way to go and the few edges after it fading out
+    void DrawHintHighlight(Vector2 offset) {
+        if (!frame->hintActive || !frame->hintReady || frame->hintStatus != SOLVE_OK) return;
+
+        const vector<int>& hintNodes = frame->hintNodes;
+        const vector<int>& hintEdges = frame->hintEdges;
+        const BoardLayout& board = *frame->board;
+        float pulse = 0.5f + 0.5f * sinf((float)GetTime() * 6.0f);
+        Color glow = Color{255, 200, 0, (unsigned char)(120 + 120 * pulse)};
+
+        float zoom = frame->view.Zoom();
+        Vector2 from = ToScreen(board.nodes[hintNodes[0]], offset);
+        if (frame->pathEmpty) {
+            DrawCircleV(from, (board.nodeRadius + 10.0f + 4.0f * pulse) * zoom, glow);
+            return;
+        }
+
+        int ahead = min((int)hintEdges.size(), kHintLookahead + 1);
+        for (int i = ahead - 1; i >= 1; i--) {
+            Vector2 start, end;
+            GetEdgeSegment(hintEdges[i], offset, start, end);
+            Color faded = Color{255, 200, 0, (unsigned char)(90 * (ahead - i) / ahead)};
+            DrawLineEx(start, end, max(10.0f * zoom, 1.0f), faded);
+        }
+
+        Vector2 start, end;
+        GetEdgeSegment(hintEdges[0], offset, start, end);
+        DrawLineEx(start, end, max((16.0f + 6.0f * pulse) * zoom, 2.0f), glow);
+
+        // Segments run from the edge's first node; the spark starts at the
+        // path's end
+        if (board.edges[hintEdges[0]].a != hintNodes[0]) swap(start, end);
+        float t = fmodf((float)GetTime() * kHintSparkSpeed, 1.0f);
+        Vector2 spark = {start.x + (end.x - start.x) * t, start.y + (end.y - start.y) * t};
+        DrawCircleV(spark, max(9.0f * zoom, 2.0f), Color{255, 255, 255, 230});
+    }
+
+    void DrawStartScreen() {
+        PROFILE_ZONE("DrawStartScreen");
+        ClearBackground(WHITE);
+
+        // Lines first so the dots sit on top; both go out as one batch each
+        for (const SnapshotLine& link : frame->links) {
+            DrawLineV(ToRay(link.a), ToRay(link.b), ToRay(link.color));
+        }
+        atlas.BeginBatch();
+        for (const SnapshotSprite& dot : frame->dots) {
+            atlas.DrawSprite(SPRITE_DISC, ToRay(dot.pos), dot.size, ToRay(dot.color));
+        }
+        atlas.EndBatch();
+
+        for (int i = 0; i < 6; i++) {
+            Vector2 start = {196.0f, 141 + i * 143.0f};
+            Vector2 end = {1684.0f, 188 + i * 143.0f};
+            DrawLineEx(start, end, 3.3f, Color{138, 43, 226, 150});
+        }
+
+        const char* title = "StrokeX";
+        Color titleColor = Color{255, 0, 255, 255};
+        if (assets.HasTitleFont()) {
+            const Font& font = assets.TitleFont();
+            float size = (float)GameAssets::kTitleFontSize;
+            float spacing = size / 20.0f;
+            Vector2 position = {940 - MeasureTextEx(font, title, size, spacing).x / 2, 165};
+            if (bloom.IsReady()) bloom.AddText(font, title, position, size, spacing, titleColor);
+            DrawTextEx(font, title, position, size, spacing, titleColor);
+        } else {
+            int titleSize = 196;
+            int titleX = 940 - MeasureText(title, titleSize) / 2;
+            DrawGlowText(title, titleX, 165, titleSize, titleColor);
+        }
+
+        const char* subtitle = "One-Stroke Puzzle Challenge";
+        int subSize = 42;
+        int subX = 940 - MeasureText(subtitle, subSize) / 2;
+        DrawText(subtitle, subX, 377, subSize, Color{138, 43, 226, 255});
+
+        Vector2 mousePos = GetMousePosition();
+        Rectangle startButton = ToRay(frame->startButton);
+        bool hovered = CheckCollisionPointRec(mousePos, startButton);
+
+        Color buttonColor = hovered ? Color{255, 0, 255, 255} : Color{138, 43, 226, 255};
+        DrawGlowRect(startButton, buttonColor);
+
+        const char* buttonText = "START";
+        int btnTextSize = 65;
+        int btnTextX = (int)startButton.x + ((int)startButton.width - MeasureText(buttonText, btnTextSize)) / 2;
+        DrawGlowText(buttonText, btnTextX, (int)startButton.y + 33, btnTextSize, buttonColor);
+
+        const char* inst1 = "Draw through all lines once";
+        const char* inst2 = "without lifting your finger!";
+        DrawText(inst1, 940 - MeasureText(inst1, 36) / 2, 730, 36, Color{138, 43, 226, 255});
+        DrawText(inst2, 940 - MeasureText(inst2, 36) / 2, 777, 36, Color{138, 43, 226, 255});
+
+        Vector2 corners[4] = {{104, 94}, {1776, 94}, {1776, 966}, {104, 966}};
+        atlas.BeginBatch();
+        for (int i = 0; i < 4; i++) {
+            for (int j = 0; j < 3; j++) {
+                float radius = 33 + j * 15;
+                Color circleColor = Color{138, 43, 226, (unsigned char)(100 - j * 30)};
+                atlas.DrawSprite(SPRITE_RING, corners[i], radius, circleColor);
+            }
+        }
+        atlas.EndBatch();
+
+        bloom.Composite();
+    }
+
+    // Screen-space endpoints of an edge. Parallel edges between the same
+    // two nodes are fanned out side by side so each stays visible.
+    void GetEdgeSegment(int edge, Vector2 offset, Vector2& start, Vector2& end) {
+        const BoardLayout& board = *frame->board;
+        int nodeA = board.edges[edge].a;
+        int nodeB = board.edges[edge].b;
+        Vec2 a = board.nodes[nodeA];
+        Vec2 b = board.nodes[nodeB];
+        start = ToScreen(a, offset);
+        end = ToScreen(b, offset);
+
+        int count = board.edges[edge].lanes;
+        if (count < 2) return;
+
+        // Measure the normal from the lower node id so both directions agree
+        Vec2 lo = (nodeA < nodeB) ? a : b;
+        Vec2 hi = (nodeA < nodeB) ? b : a;
+        float length = Distance(lo, hi);
+        if (length <= 0.0f) return;
+
+        float lane = ((float)board.edges[edge].lane - (count - 1) * 0.5f) * 18.0f * frame->view.Zoom();
+        float nx = -(hi.y - lo.y) / length * lane;
+        float ny = (hi.x - lo.x) / length * lane;
+        start.x += nx;
+        start.y += ny;
+        end.x += nx;
+        end.y += ny;
+    }
+
+    // Zoomed-out lines thinner than a couple of pixels go out as plain
+    // 1 px lines, far cheaper than the quads DrawLineEx builds
+    static void DrawBoardLine(Vector2 start, Vector2 end, float thickness, Color color) {
+        if (thickness < kHairlineWidth) {
+            DrawLineV(start, end, color);
+        } else {
+            DrawLineEx(start, end, thickness, color);
+        }
+    }
+
+    static Rectangle Shifted(Rectangle rect, Vector2 offset) {
+        return Rectangle{rect.x + offset.x, rect.y + offset.y, rect.width, rect.height};
+    }
+
+    void DrawGame() {
+        PROFILE_ZONE("DrawGame");
+        ClearBackground(Color{245, 245, 245, 255});
+        Vector2 mousePos = GetMousePosition();
+
+        const BoardLayout& board = *frame->board;
+        const BoardCulling& visible = *frame->visible;
+        const vector<unsigned char>& edgeStates = frame->edgeStates;
+        const vector<unsigned char>& nodeFlags = frame->nodeFlags;
+        float nodeRadius = board.nodeRadius;
+        int currentLevel = frame->level;
+        int maxUnlockedLevel = frame->maxUnlockedLevel;
+        bool levelComplete = frame->levelComplete;
+
+        // Apply shake offset to all game elements. Cached layers are drawn
+        // unshaken and translated when blitted.
+        Vector2 offset = ToRay(frame->shakeOffset);
+        Vector2 noOffset = {0, 0};
+
+        Rectangle resetButton = ToRay(frame->resetButton);
+        Rectangle hintButton = ToRay(frame->hintButton);
+        Rectangle prevLevelButton = ToRay(frame->prevLevelButton);
+        Rectangle nextLevelButton = ToRay(frame->nextLevelButton);
+        bool resetHovered = CheckCollisionPointRec(mousePos, Shifted(resetButton, offset));
+        bool hintHovered = CheckCollisionPointRec(mousePos, Shifted(hintButton, offset));
+        bool prevHovered = CheckCollisionPointRec(mousePos, Shifted(prevLevelButton, offset));
+        bool nextHovered = CheckCollisionPointRec(mousePos, Shifted(nextLevelButton, offset));
+        bool nextLevelLocked = (currentLevel >= maxUnlockedLevel);
+
+        // Title, level/score text and button bodies
+        uint64_t hudKey = frame->levelVersion;
+        hudKey = HashCombine(hudKey, (uint64_t)currentLevel << 32 | (uint32_t)maxUnlockedLevel);
+        hudKey = HashCombine(hudKey, (uint32_t)frame->totalScore);
+        hudKey = HashCombine(hudKey, resetHovered | hintHovered << 1 | prevHovered << 2 | nextHovered << 3 |
+                                     nextLevelLocked << 4 | levelComplete << 5);
+        if (hudLayer.BeginUpdate(hudKey)) {
+            DrawText("StrokeX", 39, 35, 52, Color{255, 0, 255, 255});
+            if (frame->daily) {
+                DrawText(TextFormat("Daily #%d", frame->dailyDay), 39, 94, 39, DARKGRAY);
+            } else {
+                DrawText(TextFormat("Level: %d / %d", currentLevel, maxUnlockedLevel), 39, 94, 39, DARKGRAY);
+            }
+            DrawText(TextFormat("Score: %d", frame->totalScore), 39, 153, 36, DARKGRAY);
+            DrawNeonButton(resetButton, "RESET", Color{255, 100, 100, 255}, false, resetHovered, false);
+            DrawNeonButton(hintButton, "HINT", Color{255, 200, 0, 255}, false, hintHovered, false);
+            DrawNeonButton(prevLevelButton, "PREV", Color{100, 150, 255, 255}, false, prevHovered, false);
+            DrawNeonButton(nextLevelButton, "NEXT", Color{100, 200, 100, 255}, nextLevelLocked, nextHovered, false);
+            if (nextLevelLocked && !levelComplete) {
+                DrawText("LOCKED", (int)nextLevelButton.x + 46, (int)nextLevelButton.y + 98, 26,
+                        Color{150, 150, 150, 255});
+            }
+            hudLayer.EndUpdate();
+        }
+        hudLayer.Draw(offset);
+
+        if (bloom.IsReady()) {
+            if (resetHovered) AddNeonButtonGlow(Shifted(resetButton, offset), "RESET", Color{255, 100, 100, 255});
+            if (hintHovered) AddNeonButtonGlow(Shifted(hintButton, offset), "HINT", Color{255, 200, 0, 255});
+            if (prevHovered) AddNeonButtonGlow(Shifted(prevLevelButton, offset), "PREV", Color{100, 150, 255, 255});
+            if (nextHovered && !nextLevelLocked) AddNeonButtonGlow(Shifted(nextLevelButton, offset), "NEXT", Color{100, 200, 100, 255});
+        }
+
+        // The timer text changes every frame, so it is always drawn live
+        float currentTime = frame->currentTime;
+        Rectangle timerBox = {1567 + offset.x, 35 + offset.y, 261, 92};
+        bool timerHovered = CheckCollisionPointRec(mousePos, timerBox);
+        DrawNeonButton(timerBox, TextFormat("%.1fs", currentTime), Color{135, 60, 190, 255}, false, timerHovered);
+
+        // Only what the camera sees is drawn, and zoomed out with less detail
+        float zoom = frame->view.Zoom();
+
+        // Edges and the traced path only change when the path or view does.
+        // Untraced edges go first so the path always lies on top; a stroke
+        // that can no longer be finished turns red right away.
+        uint64_t pathKey = HashCombine(frame->levelVersion, frame->pathVersion);
+        pathKey = HashCombine(pathKey, frame->view.Version());
+        if (edgeLayer.BeginUpdate(pathKey)) {
+            for (int pass = 0; pass < 2; pass++) {
+                for (int i : visible.edges) {
+                    int state = edgeStates[i];
+                    if ((state == EDGE_UNTRACED) != (pass == 0)) continue;
+                    Vector2 start, end;
+                    GetEdgeSegment(i, noOffset, start, end);
+
+                    if (state == EDGE_UNTRACED) {
+                        DrawBoardLine(start, end, 6.5f * zoom, Color{200, 200, 200, 255});
+                    } else {
+                        Color pathColor = (state == EDGE_RETRACED || frame->stuck) ?
+                            Color{255, 50, 50, 255} : Color{138, 43, 226, 255};
+                        DrawBoardLine(start, end, 13.1f * zoom, pathColor);
+                    }
+                }
+            }
+            edgeLayer.EndUpdate();
+        }
+        edgeLayer.Draw(offset);
+
+        if (frame->drawing && !frame->pathEmpty) {
+            Vector2 lastPoint = ToScreen(frame->pathEnd, offset);
+            Color dragColor = frame->stuck ? Color{255, 50, 50, 150} : Color{138, 43, 226, 150};
+            DrawBoardLine(lastPoint, mousePos, 9.8f * zoom, dragColor);
+        }
+
+        DrawHintHighlight(offset);
+
+        DrawParticles();
+
+        // Node rings depend on the path and the hovered node
+        uint64_t nodeKey = HashCombine(pathKey, frame->highlightVersion);
+        if (nodeLayer.BeginUpdate(nodeKey)) {
+            // All node layers go out as one quad batch; per-node draw order
+            // is kept, so the rings still stack correctly
+
+            // Up close a node is a ring with a dot when the path has been
+            // through it; further out a plain disc, purple on the path; and
+            // once it is a few pixels across it is left out altogether
+            float radius = nodeRadius * zoom;
+            bool fullDetail = radius >= kFullDetailRadius;
+            atlas.BeginBatch();
+            for (int i = 0; radius >= kMinNodeRadius && i < (int)visible.nodes.size(); i++) {
+                int node = visible.nodes[i];
+                bool onPath = (nodeFlags[node] & NODE_ON_PATH) != 0;
+                Vector2 nodePos = ToScreen(board.nodes[node], noOffset);
+
+                Color outerColor = ((nodeFlags[node] & NODE_HIGHLIGHTED) || (!fullDetail && onPath)) ?
+                    Color{138, 43, 226, 255} : Color{100, 100, 255, 255};
+                atlas.DrawSprite(SPRITE_DISC, nodePos, radius, outerColor);
+                if (!fullDetail) continue;
+                atlas.DrawSprite(SPRITE_DISC, nodePos, (nodeRadius - 6.5f) * zoom, WHITE);
+
+                if (onPath) {
+                    atlas.DrawSprite(SPRITE_DISC, nodePos, (nodeRadius - 13.1f) * zoom, Color{138, 43, 226, 200});
+                }
+            }
+            atlas.EndBatch();
+            nodeLayer.EndUpdate();
+        }
+        nodeLayer.Draw(offset);
+
+        // All neon glow for the board goes on in one pass, under the overlays
+        bloom.Composite();
+
+        if (levelComplete) {
+            DrawRectangle(0, 0, 1880, 1060, Color{0, 0, 0, 150});
+            DrawText("LEVEL COMPLETE!", 654, 389, 70, Color{100, 255, 100, 255});
+            DrawText(TextFormat("+%d points!", frame->currentScore), 823, 483, 52, Color{255, 215, 0, 255});
+            float best = frame->bestTime;
+            const char* timeText = best >= 0.0f ? TextFormat("Time: %.1fs   Best: %.1fs", frame->levelTime, best)
+                                                : TextFormat("Time: %.1fs", frame->levelTime);
+            DrawText(timeText, 940 - MeasureText(timeText, 42) / 2, 553, 42, WHITE);
+            DrawText("Press NEXT for next level", 693, 624, 42, WHITE);
+        }
+
+        if (frame->stuck) {
+            DrawText("Dead end! Release and start again.", 39 + (int)offset.x, 977 + (int)offset.y, 32,
+                     Color{255, 50, 50, 255});
+        } else {
+            DrawText("Draw through all lines once without lifting!", 39 + (int)offset.x, 977 + (int)offset.y, 32, DARKGRAY);
+        }
+
+        // Draw hint popup on top of everything
+        DrawHintPopup();
+    }
+
+#ifdef STROKEX_PROFILING
+    // Frame times of the last Profiler::kFrameHistory frames as a histogram
+    // over 0..33 ms, then the slowest zones of the previous frame
+    void DrawProfilerOverlay() {
+        static const int kBuckets = 33;
+        static const float kMaxMs = 33.0f;
+        Profiler& profiler = Profiler::Get();
+        int buckets[kBuckets];
+        profiler.FrameHistogram(buckets, kBuckets, kMaxMs);
+        int tallest = 1;
+        for (int count : buckets) tallest = max(tallest, count);
+
+        int x = 1420;
+        int y = 20;
+        DrawRectangle(x, y, 440, 360, Color{0, 0, 0, 200});
+        DrawText(TextFormat("frame p50 %.2f ms  p99 %.2f ms", profiler.FramePercentile(0.5f),
+                            profiler.FramePercentile(0.99f)), x + 10, y + 10, 20, WHITE);
+
+        int barWidth = 420 / kBuckets;
+        for (int i = 0; i < kBuckets; i++) {
+            int height = buckets[i] * 100 / tallest;
+            // Green within a 60 Hz frame, red past it
+            Color color = i < 17 ? Color{100, 255, 100, 255} : Color{255, 80, 80, 255};
+            DrawRectangle(x + 10 + i * barWidth, y + 140 - height, barWidth - 1, height, color);
+        }
+        DrawText("0", x + 10, y + 144, 10, GRAY);
+        DrawText("16.7", x + 10 + 16 * barWidth, y + 144, 10, GRAY);
+        DrawText("33 ms", x + 10 + (kBuckets - 3) * barWidth, y + 144, 10, GRAY);
+
+        const vector<ZoneTiming>& zones = profiler.LastFrameZones();
+        for (int i = 0; i < (int)zones.size() && i < 9; i++) {
+            int rowY = y + 166 + i * 20;
+            DrawText(zones[i].name, x + 10, rowY, 18, LIGHTGRAY);
+            DrawText(TextFormat("%.3f ms  x%d", zones[i].ms, zones[i].calls), x + 290, rowY, 18, LIGHTGRAY);
+        }
+    }
+#endif
+
+    void Draw() {
+        if (frame->state == START_SCREEN) {
+            DrawStartScreen();
+        } else {
+            DrawGame();
+        }
+#ifdef STROKEX_PROFILING
+        if (showProfiler) DrawProfilerOverlay();
+#endif
+    }
+};
+
+int main(int argc, char** argv) {
+    auto launchTime = chrono::steady_clock::now();
+    // Attract-screen density; large venue displays can run 100k+
+    int backgroundDots = PuzzleCore::kBackgroundDots;
+    // Session to record for strokex_headless --replay
+    const char* recordPath = nullptr;
+    // Progress journal, written in the background as levels are solved
+    const char* savePath = "progress.sxj";
+    AssetPaths paths;
+    for (int i = 1; i + 1 < argc; i++) {
+        if (strcmp(argv[i], "--dots") == 0) {
+            backgroundDots = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--record") == 0) {
+            recordPath = argv[++i];
+        } else if (strcmp(argv[i], "--assets") == 0) {
+            paths.root = argv[++i];
+        } else if (strcmp(argv[i], "--music") == 0) {
+            paths.music = argv[++i];
+        } else if (strcmp(argv[i], "--pack") == 0) {
+            paths.levelPack = argv[++i];
+        } else if (strcmp(argv[i], "--save") == 0) {
+            savePath = argv[++i];
+        }
+    }
+
+    const int screenWidth = 1880;
+    const int screenHeight = 1060;
+    InitWindow(screenWidth, screenHeight, "STROKEX - One-Stroke Puzzle Game");
+    // The simulation runs at its own fixed rate, so draw as often as the
+    // display refreshes
+    int refreshRate = GetMonitorRefreshRate(GetCurrentMonitor());
+    SetTargetFPS(refreshRate > 0 ? refreshRate : 60);
+
+    // Audio, music, the title font and the level pack load in the
+    // background; the start screen doesn't need any of them
+    GameAssets assets;
+    assets.Start(paths, recordPath == nullptr);
+
+    {
+        // Scoped so GPU resources are released before the window closes
+        OneLinePuzzle game(assets, backgroundDots, paths.levelPack.c_str(), recordPath, savePath);
+        bool firstFrame = true;
+
+        while (!WindowShouldClose()) {
+            {
+                PROFILE_ZONE("UpdateMusicStream");
+                assets.UpdateMusic();
+            }
+            game.Update();
+
+            BeginDrawing();
+            game.Draw();
+            {
+                // Includes the wait for the display
+                PROFILE_ZONE("EndDrawing");
+                EndDrawing();
+            }
+            PROFILE_FRAME_END();
+            if (firstFrame) {
+                double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - launchTime).count();
+                TraceLog(LOG_INFO, "First frame on screen %.1f ms after launch", ms);
+                firstFrame = false;
+            }
+        }
+    }
+
+    assets.Unload();
+    CloseWindow();
+    return 0;
+}
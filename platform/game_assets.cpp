@@ -0,0 +1,135 @@
+#include "game_assets.h"
+
+using namespace std;
+
+// Printable ASCII, all the title needs
+static const int kFontGlyphs = 95;
+static const int kFontPadding = 4;
+
+void GameAssets::Start(const AssetPaths& paths, bool withPack) {
+    loader.SetRoot(paths.root);
+    string musicPath = loader.Resolve(paths.music);
+    string fontPath = loader.Resolve(paths.titleFont);
+
+    // Opening the device can take a while on some systems; jobs run in
+    // order, so the music job sees whether it worked
+    jobs[SLOT_AUDIO] = loader.Submit("audio device", [this] {
+        InitAudioDevice();
+        audioReady = IsAudioDeviceReady();
+        return audioReady;
+    });
+    jobs[SLOT_MUSIC] = loader.Submit(musicPath, [this, musicPath] {
+        if (!audioReady || !AssetLoader::FileExists(musicPath)) return false;
+        music = LoadMusicStream(musicPath.c_str());
+        return IsMusicValid(music);
+    });
+    jobs[SLOT_TITLE_FONT] = loader.Submit(fontPath, [this, fontPath] {
+        if (!AssetLoader::FileExists(fontPath)) return false;
+        int size = 0;
+        unsigned char* data = LoadFileData(fontPath.c_str(), &size);
+        if (!data) return false;
+        titleFont.baseSize = kTitleFontSize;
+        titleFont.glyphCount = kFontGlyphs;
+        titleFont.glyphPadding = kFontPadding;
+        titleFont.glyphs = LoadFontData(data, size, kTitleFontSize, nullptr, kFontGlyphs, FONT_DEFAULT);
+        UnloadFileData(data);
+        if (!titleFont.glyphs) return false;
+        fontAtlas = GenImageFontAtlas(titleFont.glyphs, &titleFont.recs, kFontGlyphs, kTitleFontSize, kFontPadding, 0);
+        return true;
+    });
+    if (withPack) {
+        string packPath = paths.levelPack;
+        jobs[SLOT_LEVEL_PACK] = loader.Submit(packPath, [this, packPath] {
+            return pack.Open(packPath.c_str());
+        });
+    } else {
+        finished[SLOT_LEVEL_PACK] = true;
+    }
+}
+
+void GameAssets::Poll() {
+    for (int slot = 0; slot < SLOT_COUNT; slot++) {
+        if (finished[slot] || loader.State(jobs[slot]) == ASSET_PENDING) continue;
+        finished[slot] = true;
+        Finish((Slot)slot);
+    }
+}
+
+bool GameAssets::TakeLevelPack(LevelPack& out) {
+    if (!packReady) return false;
+    out.Swap(pack);
+    packReady = false;
+    return true;
+}
+
+void GameAssets::Finish(Slot slot) {
+    int job = jobs[slot];
+    const char* name = loader.Name(job).c_str();
+    if (loader.State(job) == ASSET_READY) {
+        TraceLog(LOG_INFO, "Loaded %s in %.1f ms", name, loader.LoadMs(job));
+    }
+
+    switch (slot) {
+    case SLOT_AUDIO:
+        if (!audioReady) TraceLog(LOG_WARNING, "No audio device, playing without sound");
+        break;
+    case SLOT_MUSIC:
+        if (loader.State(job) == ASSET_READY) {
+            SetMusicVolume(music, 0.5f);
+            PlayMusicStream(music);
+            musicPlaying = true;
+        } else if (audioReady) {
+            TraceLog(LOG_WARNING, "%s not found, playing without music", name);
+        }
+        break;
+    case SLOT_TITLE_FONT:
+        if (loader.State(job) == ASSET_READY) {
+            titleFont.texture = LoadTextureFromImage(fontAtlas);
+            UnloadImage(fontAtlas);
+            fontAtlas = {};
+            fontUploaded = true;
+        } else {
+            TraceLog(LOG_INFO, "%s not found, using the default font", name);
+        }
+        break;
+    case SLOT_LEVEL_PACK:
+        if (loader.State(job) == ASSET_READY) {
+            packReady = true;
+        } else {
+            TraceLog(LOG_WARNING, "%s not found, using generated levels", name);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void GameAssets::UpdateMusic() {
+    if (musicPlaying) UpdateMusicStream(music);
+}
+
+void GameAssets::Unload() {
+    // Nothing is in flight after this, so every field is ours again
+    loader.Shutdown();
+    if (IsMusicValid(music)) {
+        UnloadMusicStream(music);
+        music = {};
+        musicPlaying = false;
+    }
+    if (fontUploaded) {
+        UnloadFont(titleFont);
+    } else if (titleFont.glyphs) {
+        // Rasterized but never uploaded
+        UnloadFontData(titleFont.glyphs, kFontGlyphs);
+        MemFree(titleFont.recs);
+        UnloadImage(fontAtlas);
+    }
+    titleFont = {};
+    fontAtlas = {};
+    fontUploaded = false;
+    if (audioReady) {
+        CloseAudioDevice();
+        audioReady = false;
+    }
+    pack.Close();
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "core/asset_loader.h"
+#include "core/level_pack.h"
+#include "raylib.h"
+
+#include <string>
+
+// Where the windowed game looks for its files. Relative paths are taken
+// from `root`, except the level pack, which the build puts next to the
+// executable.
+struct AssetPaths {
+    std::string root = "assets";
+    std::string music = "music.mp3";
+    std::string titleFont = "title.ttf";
+    std::string levelPack = "levels.sxpk";
+};
+
+// Everything the windowed game loads from disk, loaded in the background
+// so the start screen shows up at once. Each asset is optional: without
+// an audio device or the music file the game is silent, without the font
+// the title uses raylib's, and without the pack every level is generated.
+//
+// The audio device and music stream are opened on the loader thread;
+// raylib's audio module locks its buffer list, and the main thread touches
+// them only once the job has finished. Font glyphs are rasterized there
+// too, but the atlas texture has to be created on the GL thread in Poll.
+class GameAssets {
+public:
+    static constexpr int kTitleFontSize = 196;
+
+    ~GameAssets() { Unload(); }
+
+    // Queue every load and return at once. `withPack` false leaves the
+    // pack to the caller (recordings open it up front, so the first frame
+    // already plays on it).
+    void Start(const AssetPaths& paths, bool withPack);
+    // Finish whatever the loader completed since the last call; once a
+    // frame on the main thread
+    void Poll();
+    // Once the pack has loaded, swap it into `out` the first time this is
+    // asked; false before that and after
+    bool TakeLevelPack(LevelPack& out);
+    void UpdateMusic();
+    // Frees everything; call before the window closes
+    void Unload();
+
+    bool HasTitleFont() const { return fontUploaded; }
+    const Font& TitleFont() const { return titleFont; }
+
+private:
+    enum Slot {
+        SLOT_AUDIO,
+        SLOT_MUSIC,
+        SLOT_TITLE_FONT,
+        SLOT_LEVEL_PACK,
+        SLOT_COUNT
+    };
+
+    void Finish(Slot slot);
+
+    AssetLoader loader;
+    int jobs[SLOT_COUNT] = {-1, -1, -1, -1};
+    bool finished[SLOT_COUNT] = {};
+
+    bool audioReady = false;   // written by the loader before its job completes
+    Music music = {};
+    bool musicPlaying = false;
+
+    Font titleFont = {};
+    Image fontAtlas = {};      // rasterized off-thread, uploaded in Poll
+    bool fontUploaded = false;
+
+    LevelPack pack;
+    bool packReady = false;
+};
@@ -0,0 +1,83 @@
+#include "mouse_poller.h"
+
+#include <chrono>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+using namespace std;
+
+static double SteadySeconds() {
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+MousePoller::MousePoller() : running(false), window(nullptr), clockOffset(0.0) {
+}
+
+MousePoller::~MousePoller() {
+    Stop();
+}
+
+bool MousePoller::Start(void* nativeWindow, double clockNow) {
+    if (running || !nativeWindow) return false;
+    window = nativeWindow;
+    clockOffset = clockNow - SteadySeconds();
+#ifdef _WIN32
+    running = true;
+    thread = std::thread(&MousePoller::Run, this);
+    return true;
+#else
+    return false;
+#endif
+}
+
+void MousePoller::Stop() {
+    running = false;
+    if (thread.joinable()) thread.join();
+}
+
+int MousePoller::Drain(InputSample* out, int maxCount) {
+    InputSample skipped;
+    while (queue.Size() > (size_t)maxCount) queue.Pop(skipped);
+
+    int count = 0;
+    while (count < maxCount && queue.Pop(out[count])) count++;
+    return count;
+}
+
+void MousePoller::Run() {
+#ifdef _WIN32
+    HWND hwnd = (HWND)window;
+    auto period = chrono::microseconds(1000000 / kRateHz);
+    auto next = chrono::steady_clock::now();
+    InputSample last = {-1.0, {-1e9f, -1e9f}, false};
+
+    // raylib already raises the system timer to 1 ms, so the sleep below
+    // really is about a millisecond
+    while (running.load(memory_order_relaxed)) {
+        POINT point;
+        if (GetCursorPos(&point) && ScreenToClient(hwnd, &point)) {
+            int button = GetSystemMetrics(SM_SWAPBUTTON) ? VK_RBUTTON : VK_LBUTTON;
+            InputSample sample;
+            sample.time = SteadySeconds() + clockOffset;
+            sample.pos = {(float)point.x, (float)point.y};
+            sample.down = (GetAsyncKeyState(button) & 0x8000) != 0;
+
+            // Only changes are worth a slot; a resting cursor adds nothing.
+            // If the game stalls long enough to fill the queue, the change
+            // is retried on the next tick.
+            if (sample.pos.x != last.pos.x || sample.pos.y != last.pos.y || sample.down != last.down) {
+                if (queue.Push(sample)) last = sample;
+            }
+        }
+
+        next += period;
+        auto now = chrono::steady_clock::now();
+        if (next < now) next = now;
+        this_thread::sleep_until(next);
+    }
+#endif
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "core/platform.h"
+#include "core/spsc_queue.h"
+
+#include <atomic>
+#include <thread>
+
+// Reads the cursor on its own thread at about 1 kHz, so a fast swipe
+// arrives as a dense trail of readings instead of one point per frame.
+// Readings are stamped on the game clock and handed over through a
+// lock-free queue that the main thread drains once a frame.
+//
+// Only Win32 lets another thread read the cursor (GLFW input is main-thread
+// only). Elsewhere Start fails and the game samples once a frame as before.
+// Kept out of main.cpp because <windows.h> and raylib.h can't share a file.
+class MousePoller {
+public:
+    static constexpr int kRateHz = 1000;
+
+    MousePoller();
+    ~MousePoller();
+
+    // nativeWindow is the window handle (HWND) that positions are relative
+    // to; clockNow is the game clock's Now() at the time of the call
+    bool Start(void* nativeWindow, double clockNow);
+    void Stop();
+    bool IsRunning() const { return running.load(std::memory_order_relaxed); }
+
+    // Move readings taken since the last call into out, oldest first. If
+    // more are waiting than fit (after a long hitch), the oldest are dropped.
+    int Drain(InputSample* out, int maxCount);
+
+private:
+    void Run();
+
+    SpscQueue<InputSample, 4096> queue;
+    std::thread thread;
+    std::atomic<bool> running;
+    void* window;
+    double clockOffset;   // game clock minus steady_clock, in seconds
+};
@@ -0,0 +1,138 @@
+#include "bloom.h"
+
+#include "core/profiler.h"
+#include "rlgl.h"
+
+#include <cstring>
+
+// 9-tap Gaussian folded into 5 bilinear fetches
+static const char* BLUR_FS = R"(#version 330
+in vec2 fragTexCoord;
+in vec4 fragColor;
+uniform sampler2D texture0;
+uniform vec4 colDiffuse;
+uniform vec2 direction;
+out vec4 finalColor;
+void main() {
+    vec4 sum = texture(texture0, fragTexCoord) * 0.2270270270;
+    sum += texture(texture0, fragTexCoord + direction * 1.3846153846) * 0.3162162162;
+    sum += texture(texture0, fragTexCoord - direction * 1.3846153846) * 0.3162162162;
+    sum += texture(texture0, fragTexCoord + direction * 3.2307692308) * 0.0702702703;
+    sum += texture(texture0, fragTexCoord - direction * 3.2307692308) * 0.0702702703;
+    finalColor = sum * colDiffuse * fragColor;
+}
+)";
+
+void BloomPass::Load(int screenWidth, int screenHeight, int factor) {
+    downsample = factor;
+    width = screenWidth / factor;
+    height = screenHeight / factor;
+
+    blurShader = LoadShaderFromMemory(nullptr, BLUR_FS);
+    if (blurShader.id == 0 || blurShader.id == rlGetShaderIdDefault()) {
+        TraceLog(LOG_WARNING, "BLOOM: blur shader unavailable, using fallback glow");
+        return;
+    }
+    directionLoc = GetShaderLocation(blurShader, "direction");
+
+    targetA = LoadRenderTexture(width, height);
+    targetB = LoadRenderTexture(width, height);
+    SetTextureFilter(targetA.texture, TEXTURE_FILTER_BILINEAR);
+    SetTextureFilter(targetB.texture, TEXTURE_FILTER_BILINEAR);
+    sources.reserve(32);
+    ready = true;
+}
+
+void BloomPass::Unload() {
+    if (!ready) return;
+    UnloadRenderTexture(targetA);
+    UnloadRenderTexture(targetB);
+    UnloadShader(blurShader);
+    ready = false;
+}
+
+void BloomPass::AddText(const char* text, int x, int y, int fontSize, Color color) {
+    GlowSource source = {};
+    source.isText = true;
+    strncpy(source.text, text, sizeof(source.text) - 1);
+    source.rect = Rectangle{(float)x, (float)y, (float)fontSize, 0};
+    source.color = color;
+    sources.push_back(source);
+}
+
+void BloomPass::AddText(Font font, const char* text, Vector2 position, float fontSize, float spacing, Color color) {
+    GlowSource source = {};
+    source.isText = true;
+    strncpy(source.text, text, sizeof(source.text) - 1);
+    source.rect = Rectangle{position.x, position.y, fontSize, 0};
+    source.font = font;
+    source.spacing = spacing;
+    source.color = color;
+    sources.push_back(source);
+}
+
+void BloomPass::AddRoundedOutline(Rectangle rect, float roundness, float thickness, Color color) {
+    GlowSource source = {};
+    source.isText = false;
+    source.rect = rect;
+    source.roundness = roundness;
+    source.thickness = thickness;
+    source.color = color;
+    sources.push_back(source);
+}
+
+void BloomPass::BlurPass(RenderTexture2D& from, RenderTexture2D& to, float dx, float dy) {
+    float direction[2] = {dx / width, dy / height};
+    BeginTextureMode(to);
+    ClearBackground(BLANK);
+    BeginShaderMode(blurShader);
+    SetShaderValue(blurShader, directionLoc, direction, SHADER_UNIFORM_VEC2);
+    BeginBlendMode(BLEND_ALPHA_PREMULTIPLY);
+    // Render textures are stored bottom-up; a negative source height keeps
+    // every pass the same way round
+    DrawTextureRec(from.texture, Rectangle{0, 0, (float)width, -(float)height}, Vector2{0, 0}, WHITE);
+    EndBlendMode();
+    EndShaderMode();
+    EndTextureMode();
+}
+
+void BloomPass::Composite(float strength) {
+    PROFILE_ZONE("Bloom::Composite");
+    if (!ready || sources.empty()) return;
+
+    // Draw the glow sources once, scaled down into the small target. Colour
+    // is premultiplied on the way in so the blur and the final blend don't
+    // produce dark fringes on the light background.
+    Camera2D camera = {};
+    camera.zoom = 1.0f / (float)downsample;
+
+    BeginTextureMode(targetA);
+    ClearBackground(BLANK);
+    BeginMode2D(camera);
+    rlSetBlendFactorsSeparate(RL_SRC_ALPHA, RL_ONE_MINUS_SRC_ALPHA, RL_ONE, RL_ONE_MINUS_SRC_ALPHA, RL_FUNC_ADD, RL_FUNC_ADD);
+    BeginBlendMode(BLEND_CUSTOM_SEPARATE);
+    for (const auto& source : sources) {
+        if (source.isText && source.font.texture.id != 0) {
+            DrawTextEx(source.font, source.text, Vector2{source.rect.x, source.rect.y}, source.rect.width, source.spacing,
+                       source.color);
+        } else if (source.isText) {
+            DrawText(source.text, (int)source.rect.x, (int)source.rect.y, (int)source.rect.width, source.color);
+        } else {
+            DrawRectangleRoundedLinesEx(source.rect, source.roundness, 8, source.thickness, source.color);
+        }
+    }
+    EndBlendMode();
+    EndMode2D();
+    EndTextureMode();
+    sources.clear();
+
+    BlurPass(targetA, targetB, 1.0f, 0.0f);
+    BlurPass(targetB, targetA, 0.0f, 1.0f);
+
+    unsigned char s = (unsigned char)(255 * strength);
+    BeginBlendMode(BLEND_ALPHA_PREMULTIPLY);
+    DrawTexturePro(targetA.texture, Rectangle{0, 0, (float)width, -(float)height},
+                   Rectangle{0, 0, (float)(width * downsample), (float)(height * downsample)},
+                   Vector2{0, 0}, 0.0f, Color{s, s, s, s});
+    EndBlendMode();
+}
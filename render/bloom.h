@@ -0,0 +1,53 @@
+#pragma once
+
+#include "raylib.h"
+
+#include <vector>
+
+// Render-to-texture glow. Neon elements register their glow sources during
+// the frame (a text string or a rounded outline); Composite() draws all of
+// them once into a downsampled target, runs a separable Gaussian blur and
+// lays the halo over the screen. The crisp element itself is drawn
+// normally by the caller.
+//
+// Composite() may be called more than once per frame to put a halo at a
+// specific depth, e.g. under a popup and again for the popup itself.
+class BloomPass {
+public:
+    // Needs a GL context. Falls back to IsReady() == false when the blur
+    // shader cannot be compiled; callers then draw their old glow.
+    void Load(int width, int height, int downsample = 3);
+    void Unload();
+    bool IsReady() const { return ready; }
+
+    void AddText(const char* text, int x, int y, int fontSize, Color color);
+    void AddText(Font font, const char* text, Vector2 position, float fontSize, float spacing, Color color);
+    void AddRoundedOutline(Rectangle rect, float roundness, float thickness, Color color);
+
+    // Blur everything added since the last composite and draw the halo
+    void Composite(float strength = 1.0f);
+
+private:
+    struct GlowSource {
+        bool isText;
+        char text[48];
+        Rectangle rect;   // text: x, y, fontSize in width
+        Font font;        // texture id 0 for raylib's default font
+        float spacing;
+        float roundness;
+        float thickness;
+        Color color;
+    };
+
+    void BlurPass(RenderTexture2D& from, RenderTexture2D& to, float dx, float dy);
+
+    bool ready = false;
+    int width = 0;
+    int height = 0;
+    int downsample = 1;
+    RenderTexture2D targetA = {};
+    RenderTexture2D targetB = {};
+    Shader blurShader = {};
+    int directionLoc = -1;
+    std::vector<GlowSource> sources;
+};
@@ -0,0 +1,40 @@
+#include "layer_cache.h"
+
+#include "rlgl.h"
+
+void CachedLayer::Load(int width, int height) {
+    target = LoadRenderTexture(width, height);
+    valid = false;
+}
+
+void CachedLayer::Unload() {
+    if (target.id != 0) UnloadRenderTexture(target);
+    target = {};
+    valid = false;
+}
+
+bool CachedLayer::BeginUpdate(uint64_t key) {
+    if (valid && key == currentKey) return false;
+
+    currentKey = key;
+    valid = true;
+    BeginTextureMode(target);
+    ClearBackground(BLANK);
+    // Store premultiplied colour with correct coverage so translucent
+    // fills look the same once the layer is blitted back over the frame
+    rlSetBlendFactorsSeparate(RL_SRC_ALPHA, RL_ONE_MINUS_SRC_ALPHA, RL_ONE, RL_ONE_MINUS_SRC_ALPHA, RL_FUNC_ADD, RL_FUNC_ADD);
+    BeginBlendMode(BLEND_CUSTOM_SEPARATE);
+    return true;
+}
+
+void CachedLayer::EndUpdate() {
+    EndBlendMode();
+    EndTextureMode();
+}
+
+void CachedLayer::Draw(Vector2 offset) {
+    BeginBlendMode(BLEND_ALPHA_PREMULTIPLY);
+    DrawTextureRec(target.texture, Rectangle{0, 0, (float)target.texture.width, -(float)target.texture.height},
+                   offset, WHITE);
+    EndBlendMode();
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "raylib.h"
+
+#include <cstdint>
+
+// Screen-sized render texture that is only redrawn when the key describing
+// its inputs changes. Callers fold whatever the layer depends on (state
+// versions, hover flags, ...) into the key:
+//
+//     if (layer.BeginUpdate(key)) {
+//         ... draw the layer ...
+//         layer.EndUpdate();
+//     }
+//     layer.Draw(offset);
+class CachedLayer {
+public:
+    void Load(int width, int height);
+    void Unload();
+
+    // True if the key changed; the layer is then cleared and bound as the
+    // render target until EndUpdate()
+    bool BeginUpdate(uint64_t key);
+    void EndUpdate();
+    void Invalidate() { valid = false; }
+
+    // Blit the cached layer, translated by offset
+    void Draw(Vector2 offset);
+
+private:
+    RenderTexture2D target = {};
+    uint64_t currentKey = 0;
+    bool valid = false;
+};
+
+// Cheap mixing for building layer keys out of several small values
+inline uint64_t HashCombine(uint64_t seed, uint64_t value) {
+    return seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+}
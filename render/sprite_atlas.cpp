@@ -0,0 +1,82 @@
+#include "sprite_atlas.h"
+
+#include "rlgl.h"
+
+#include <cmath>
+
+// Each sprite sits in a CELL x CELL square; the circle is inset a little so
+// lower mip levels don't bleed into the neighbouring sprite
+static const int CELL = 128;
+static const float RADIUS = 60.0f;
+static const float RING_WIDTH = 2.5f;
+
+void SpriteAtlas::Load() {
+    Image image = GenImageColor(CELL * SPRITE_COUNT, CELL, BLANK);
+    Color* pixels = (Color*)image.data;
+    int stride = CELL * SPRITE_COUNT;
+    float center = CELL * 0.5f;
+
+    for (int y = 0; y < CELL; y++) {
+        for (int x = 0; x < CELL; x++) {
+            float dx = (float)x + 0.5f - center;
+            float dy = (float)y + 0.5f - center;
+            float dist = sqrtf(dx * dx + dy * dy);
+
+            // Coverage-based anti-aliasing: one texel of falloff at each edge
+            float disc = fminf(fmaxf(RADIUS + 0.5f - dist, 0.0f), 1.0f);
+            float ringOuter = fminf(fmaxf(RADIUS + 0.5f - dist, 0.0f), 1.0f);
+            float ringInner = fminf(fmaxf(dist - (RADIUS - RING_WIDTH) + 0.5f, 0.0f), 1.0f);
+            float ring = ringOuter * ringInner;
+
+            pixels[y * stride + x + SPRITE_DISC * CELL] = Color{255, 255, 255, (unsigned char)(disc * 255)};
+            pixels[y * stride + x + SPRITE_RING * CELL] = Color{255, 255, 255, (unsigned char)(ring * 255)};
+        }
+    }
+
+    texture = LoadTextureFromImage(image);
+    UnloadImage(image);
+    GenTextureMipmaps(&texture);
+    SetTextureFilter(texture, TEXTURE_FILTER_TRILINEAR);
+
+    for (int i = 0; i < SPRITE_COUNT; i++) {
+        sources[i] = Rectangle{(float)(i * CELL), 0, (float)CELL, (float)CELL};
+    }
+    spriteRadius = RADIUS;
+}
+
+void SpriteAtlas::Unload() {
+    if (texture.id != 0) UnloadTexture(texture);
+    texture = {};
+}
+
+void SpriteAtlas::BeginBatch() {
+    rlSetTexture(texture.id);
+    rlBegin(RL_QUADS);
+    rlNormal3f(0.0f, 0.0f, 1.0f);
+}
+
+void SpriteAtlas::DrawSprite(SpriteId sprite, Vector2 center, float radius, Color color) {
+    // Scale so the rasterised circle, not the cell, matches the radius
+    float half = radius * (CELL * 0.5f) / spriteRadius;
+    const Rectangle& src = sources[sprite];
+    float u0 = src.x / texture.width;
+    float u1 = (src.x + src.width) / texture.width;
+    float v0 = src.y / texture.height;
+    float v1 = (src.y + src.height) / texture.height;
+
+    rlCheckRenderBatchLimit(4);
+    rlColor4ub(color.r, color.g, color.b, color.a);
+    rlTexCoord2f(u0, v0);
+    rlVertex2f(center.x - half, center.y - half);
+    rlTexCoord2f(u0, v1);
+    rlVertex2f(center.x - half, center.y + half);
+    rlTexCoord2f(u1, v1);
+    rlVertex2f(center.x + half, center.y + half);
+    rlTexCoord2f(u1, v0);
+    rlVertex2f(center.x + half, center.y - half);
+}
+
+void SpriteAtlas::EndBatch() {
+    rlEnd();
+    rlSetTexture(0);
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "raylib.h"
+
+enum SpriteId {
+    SPRITE_DISC,   // filled circle
+    SPRITE_RING,   // thin circle outline
+    SPRITE_COUNT
+};
+
+// Circles pre-rasterised once into a small mipmapped texture. Drawing a
+// circle becomes one textured quad instead of a tessellated fan, and all
+// quads between BeginBatch/EndBatch share a texture and primitive mode, so
+// raylib submits the whole layer in a single draw call.
+class SpriteAtlas {
+public:
+    // Needs a GL context; call after InitWindow
+    void Load();
+    void Unload();
+
+    void BeginBatch();
+    // Circle of the given radius centred on center, tinted by color
+    void DrawSprite(SpriteId sprite, Vector2 center, float radius, Color color);
+    void EndBatch();
+
+private:
+    Texture2D texture = {};
+    Rectangle sources[SPRITE_COUNT] = {};
+    float spriteRadius = 0.0f;   // radius of the rasterised circle in texels
+};
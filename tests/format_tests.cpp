@@ -0,0 +1,482 @@
+// strokex_tests: round trips and damaged files for the on-disk formats
+// (level packs, recordings, the progress journal) plus the dead-end
+// checker's verdicts. Run by ctest; files go in the working directory.
+
+#include "core/dead_end_checker.h"
+#include "core/graph_index.h"
+#include "core/level_pack.h"
+#include "core/progress_store.h"
+#include "core/replay.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+using namespace std;
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            failures++; \
+        } \
+    } while (0)
+
+static vector<uint8_t> ReadFile(const char* path) {
+    vector<uint8_t> bytes;
+    FILE* file = fopen(path, "rb");
+    if (!file) return bytes;
+    uint8_t chunk[4096];
+    size_t read;
+    while ((read = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        bytes.insert(bytes.end(), chunk, chunk + read);
+    }
+    fclose(file);
+    return bytes;
+}
+
+static void WriteFile(const char* path, const vector<uint8_t>& bytes) {
+    FILE* file = fopen(path, "wb");
+    if (!file) return;
+    fwrite(bytes.data(), 1, bytes.size(), file);
+    fclose(file);
+}
+
+static Node MakeNode(float x, float y, int id) {
+    return Node{{x, y}, id, false};
+}
+
+// --- Level packs -----------------------------------------------------------
+
+static void TestPackRoundTrip() {
+    const char* path = "test_roundtrip.sxpk";
+
+    vector<vector<Node>> levelNodes(3);
+    vector<vector<Edge>> levelEdges(3);
+    levelNodes[0] = {MakeNode(100, 100, 0), MakeNode(500, 120, 1), MakeNode(300, 700, 2)};
+    levelEdges[0] = {{0, 1, 0}, {1, 2, 0}, {2, 0, 0}};
+    levelNodes[1] = {MakeNode(0, 0, 0), MakeNode(1880, 1060, 1)};
+    levelEdges[1] = {{0, 1, 0}, {0, 1, 0}};
+    // Too many nodes for 16-bit counts, so it takes the wide record
+    for (int i = 0; i < 70000; i++) {
+        levelNodes[2].push_back(MakeNode((float)(i % 1880), (float)(i % 1060), i));
+        if (i > 0) levelEdges[2].push_back({i - 1, i, 0});
+    }
+    float difficulties[3] = {0.75f, -1.0f, 0.25f};
+
+    LevelPackWriter writer;
+    CHECK(writer.Begin(path));
+    for (int i = 0; i < 3; i++) {
+        CHECK(writer.AddLevel(levelNodes[i], levelEdges[i], difficulties[i]));
+    }
+    CHECK(writer.LevelCount() == 3);
+    CHECK(writer.Finish(true));
+
+    LevelPack pack;
+    CHECK(pack.Open(path));
+    CHECK(pack.LevelCount() == 3);
+    CHECK(pack.Bounds().width == 1880 && pack.Bounds().height == 1060);
+
+    // Sorted easiest first, unrated last
+    int order[3] = {2, 0, 1};
+    vector<Node> nodes;
+    vector<Edge> edges;
+    for (int i = 0; i < 3; i++) {
+        int source = order[i];
+        CHECK(pack.DecodeLevel(i, nodes, edges));
+        CHECK(nodes.size() == levelNodes[source].size());
+        CHECK(edges.size() == levelEdges[source].size());
+        bool same = nodes.size() == levelNodes[source].size() && edges.size() == levelEdges[source].size();
+        for (size_t n = 0; same && n < nodes.size(); n++) {
+            same = fabsf(nodes[n].position.x - levelNodes[source][n].position.x) < 0.05f &&
+                   fabsf(nodes[n].position.y - levelNodes[source][n].position.y) < 0.05f;
+        }
+        for (size_t e = 0; same && e < edges.size(); e++) {
+            same = edges[e].nodeA == levelEdges[source][e].nodeA && edges[e].nodeB == levelEdges[source][e].nodeB;
+        }
+        CHECK(same);
+        if (difficulties[source] < 0.0f) {
+            CHECK(pack.LevelDifficulty(i) < 0.0f);
+        } else {
+            CHECK(fabsf(pack.LevelDifficulty(i) - difficulties[source]) < 1e-4f);
+        }
+    }
+    CHECK(!pack.DecodeLevel(3, nodes, edges));
+    CHECK(!pack.DecodeLevel(-1, nodes, edges));
+
+    uint64_t hash = pack.ContentHash();
+    LevelPack again;
+    CHECK(again.Open(path));
+    CHECK(again.ContentHash() == hash);
+    remove(path);
+}
+
+static void TestPackCorruption() {
+    const char* path = "test_corrupt.sxpk";
+    vector<Node> nodes = {MakeNode(10, 10, 0), MakeNode(200, 40, 1), MakeNode(90, 300, 2)};
+    vector<Edge> edges = {{0, 1, 0}, {1, 2, 0}};
+
+    LevelPackWriter writer;
+    CHECK(writer.Begin(path));
+    CHECK(writer.AddLevel(nodes, edges));
+    CHECK(writer.AddLevel(nodes, edges));
+    CHECK(writer.Finish());
+    vector<uint8_t> good = ReadFile(path);
+    CHECK(good.size() > 40);
+
+    LevelPack pack;
+    vector<Node> outNodes;
+    vector<Edge> outEdges;
+
+    vector<uint8_t> bytes = good;
+    bytes[0] = 'X';
+    WriteFile(path, bytes);
+    CHECK(!pack.Open(path));
+
+    bytes = good;
+    bytes[4] = (uint8_t)(kLevelPackVersion + 1);
+    WriteFile(path, bytes);
+    CHECK(!pack.Open(path));
+
+    // Cut into the offset table
+    bytes.assign(good.begin(), good.end() - 4);
+    WriteFile(path, bytes);
+    CHECK(!pack.Open(path));
+
+    bytes.assign(good.begin(), good.begin() + 20);
+    WriteFile(path, bytes);
+    CHECK(!pack.Open(path));
+
+    // An offset pointing past the records fails that level only
+    bytes = good;
+    for (int i = 0; i < 8; i++) bytes[bytes.size() - 8 + i] = 0xFF;
+    WriteFile(path, bytes);
+    CHECK(pack.Open(path));
+    CHECK(pack.DecodeLevel(0, outNodes, outEdges));
+    CHECK(!pack.DecodeLevel(1, outNodes, outEdges));
+    pack.Close();
+
+    // An edge naming a node the record doesn't have
+    bytes = good;
+    uint64_t tableOffset = 0;
+    for (int i = 0; i < 8; i++) tableOffset |= (uint64_t)good[12 + i] << (i * 8);
+    size_t firstEdge = 40 + 6 + nodes.size() * 4;
+    bytes[firstEdge] = 0x40;
+    CHECK(firstEdge < tableOffset);
+    WriteFile(path, bytes);
+    CHECK(pack.Open(path));
+    CHECK(!pack.DecodeLevel(0, outNodes, outEdges));
+    pack.Close();
+
+    CHECK(!pack.Open("test_missing.sxpk"));
+    remove(path);
+}
+
+// --- Recordings ------------------------------------------------------------
+
+static void TestRecordingRoundTrip() {
+    const char* path = "test_roundtrip.sxrec";
+    const int kFrames = 200;
+
+    vector<double> times;
+    vector<float> deltas;
+    vector<FrameInput> inputs;
+    vector<vector<InputSample>> sampleCopies;
+
+    InputRecorder recorder;
+    CHECK(recorder.Begin(path, 1234, 0xABCDEF0123456789ULL));
+    FrameClock clock;
+    double now = 0.0;
+    vector<InputSample> samples;
+    for (int i = 0; i < kFrames; i++) {
+        // Uneven frame times and a hitch now and then
+        float delta = i % 37 == 0 ? 0.05f : 1.0f / 60.0f + (i % 5) * 0.0003f;
+        now += delta;
+        clock.SetFrame(now, delta);
+
+        FrameInput input;
+        input.mousePos = {100.0f + i * 3.3f, 500.0f - i * 1.7f};
+        input.mouseDown = i % 20 < 12;
+        input.mousePressed = i % 20 == 0;
+        input.mouseReleased = i % 20 == 12;
+        input.autoSolvePressed = i == 150;
+        if (i == 40) input.dailyRequest = 20000;
+        if (i % 50 == 7) input.wheel = -1.5f;
+        input.panDown = i >= 100 && i < 110;
+        samples.clear();
+        for (int s = 0; s < i % 4; s++) {
+            samples.push_back({s == 2 ? -1.0 : now - 0.001 * (3 - s), {input.mousePos.x - s, input.mousePos.y + s}, input.mouseDown});
+        }
+        input.samples = samples.data();
+        input.sampleCount = (int)samples.size();
+
+        recorder.RecordFrame(clock, input);
+        times.push_back(clock.Now());
+        deltas.push_back(clock.FrameDelta());
+        inputs.push_back(input);
+        sampleCopies.emplace_back(input.samples, input.samples + input.sampleCount);
+    }
+    CHECK(recorder.Finish(4321, 17));
+
+    InputReplayer replayer;
+    FrameClock replayClock;
+    CHECK(replayer.Open(path, replayClock));
+    CHECK(replayer.Info().seed == 1234);
+    CHECK(replayer.Info().packHash == 0xABCDEF0123456789ULL);
+    CHECK(replayer.Info().frames == kFrames);
+    CHECK(replayer.Info().totalScore == 4321);
+    CHECK(replayer.Info().maxLevel == 17);
+
+    // The recorder quantized its inputs in place, so the replay has to match
+    // them exactly
+    int mismatches = 0;
+    for (int i = 0; i < kFrames && replayer.HasFrames(); i++) {
+        FrameInput input = replayer.Poll();
+        const FrameInput& expected = inputs[i];
+        bool same = replayClock.Now() == times[i] && replayClock.FrameDelta() == deltas[i] &&
+                    input.mousePos.x == expected.mousePos.x && input.mousePos.y == expected.mousePos.y &&
+                    input.mouseDown == expected.mouseDown && input.mousePressed == expected.mousePressed &&
+                    input.mouseReleased == expected.mouseReleased &&
+                    input.autoSolvePressed == expected.autoSolvePressed &&
+                    input.dailyRequest == expected.dailyRequest && input.wheel == expected.wheel &&
+                    input.panDown == expected.panDown && input.sampleCount == expected.sampleCount;
+        for (int s = 0; same && s < input.sampleCount; s++) {
+            const InputSample& a = input.samples[s];
+            const InputSample& b = sampleCopies[i][s];
+            same = a.time == b.time && a.pos.x == b.pos.x && a.pos.y == b.pos.y && a.down == b.down;
+        }
+        if (!same) mismatches++;
+    }
+    CHECK(mismatches == 0);
+    CHECK(!replayer.HasFrames());
+    CHECK(replayer.IsValid());
+    remove(path);
+}
+
+static void TestRecordingCorruption() {
+    const char* path = "test_corrupt.sxrec";
+    const size_t kHeaderSize = 24;
+    const size_t kTrailerSize = 17;
+
+    InputRecorder recorder;
+    CHECK(recorder.Begin(path, 1, 0));
+    FrameClock clock;
+    for (int i = 0; i < 50; i++) {
+        clock.SetFrame((i + 1) / 60.0, 1.0f / 60.0f);
+        FrameInput input;
+        input.mousePos = {(float)i, (float)(i * 2)};
+        input.mouseDown = true;
+        recorder.RecordFrame(clock, input);
+    }
+    CHECK(recorder.Finish(0, 1));
+    vector<uint8_t> good = ReadFile(path);
+    CHECK(good.size() > kHeaderSize + kTrailerSize + 30);
+
+    InputReplayer replayer;
+    FrameClock replayClock;
+
+    vector<uint8_t> bytes = good;
+    bytes[0] = 'X';
+    WriteFile(path, bytes);
+    CHECK(!replayer.Open(path, replayClock));
+
+    bytes = good;
+    bytes[4] = (uint8_t)(kRecordingVersion + 1);
+    WriteFile(path, bytes);
+    CHECK(!replayer.Open(path, replayClock));
+
+    bytes[4] = 1;
+    WriteFile(path, bytes);
+    CHECK(!replayer.Open(path, replayClock));
+
+    // Cut off the trailer
+    bytes.assign(good.begin(), good.end() - 5);
+    WriteFile(path, bytes);
+    CHECK(!replayer.Open(path, replayClock));
+
+    // The trailer survives but most frames are gone: every frame takes at
+    // least 3 bytes, so 30 can't hold all 50
+    bytes.assign(good.begin(), good.begin() + kHeaderSize + 30);
+    bytes.insert(bytes.end(), good.end() - kTrailerSize, good.end());
+    WriteFile(path, bytes);
+    CHECK(replayer.Open(path, replayClock));
+    int polls = 0;
+    while (replayer.HasFrames() && replayer.IsValid() && polls < 100) {
+        replayer.Poll();
+        polls++;
+    }
+    CHECK(!replayer.IsValid());
+    CHECK(polls <= 11);
+
+    CHECK(!replayer.Open("test_missing.sxrec", replayClock));
+    remove(path);
+}
+
+// --- Progress journal ------------------------------------------------------
+
+static bool SameProgress(const SavedProgress& a, const SavedProgress& b) {
+    if (a.maxUnlockedLevel != b.maxUnlockedLevel || a.totalScore != b.totalScore) return false;
+    size_t levels = max(a.bestTimes.size(), b.bestTimes.size());
+    for (size_t i = 0; i < levels; i++) {
+        if (a.BestTime((int)i) != b.BestTime((int)i)) return false;
+    }
+    return true;
+}
+
+// Open `path`, check what it loaded, then reopen to check Open rewrote the
+// journal without the damage
+static void CheckReopen(const char* path, const SavedProgress& expected, long long dropped) {
+    {
+        ProgressStore store;
+        CHECK(store.Open(path));
+        CHECK(store.DroppedBytes() == dropped);
+        CHECK(SameProgress(store.Progress(), expected));
+    }
+    ProgressStore store;
+    CHECK(store.Open(path));
+    CHECK(store.DroppedBytes() == 0);
+    CHECK(SameProgress(store.Progress(), expected));
+}
+
+static void TestJournal() {
+    const char* path = "test_progress.sxj";
+    remove(path);
+
+    SavedProgress saved;
+    {
+        ProgressStore store;
+        CHECK(store.Open(path));
+        CHECK(store.DroppedBytes() == 0);
+        store.SetProgress(3, 120);
+        store.RecordTime(1, 12.5f);
+        store.RecordTime(2, 30.0f);
+        store.RecordTime(1, 9.25f);
+        store.SetProgress(4, 250);
+        saved = store.Progress();
+    }
+    CHECK(saved.maxUnlockedLevel == 4 && saved.totalScore == 250);
+    CHECK(saved.BestTime(1) == 9.25f && saved.BestTime(2) == 30.0f);
+
+    vector<uint8_t> good = ReadFile(path);
+    CHECK(good.size() >= 8 + 16 && (good.size() - 8) % 16 == 0);
+    CheckReopen(path, saved, 0);
+    good = ReadFile(path);
+
+    // Garbage after the last record is dropped and nothing else
+    vector<uint8_t> bytes = good;
+    for (int i = 0; i < 21; i++) bytes.push_back((uint8_t)(0xA5 ^ i * 37));
+    WriteFile(path, bytes);
+    CheckReopen(path, saved, 21);
+
+    // A record torn in half goes, the intact ones before it stay
+    bytes.assign(good.begin(), good.end() - 7);
+    WriteFile(path, bytes);
+    {
+        ProgressStore store;
+        CHECK(store.Open(path));
+        CHECK(store.DroppedBytes() == 9);
+        SavedProgress partial = store.Progress();
+        store.Close();
+        CheckReopen(path, partial, 0);
+    }
+
+    // A header cut short counts as an empty journal
+    WriteFile(path, vector<uint8_t>(good.begin(), good.begin() + 3));
+    CheckReopen(path, SavedProgress(), 0);
+
+    // Not a journal at all: refused and left as it was
+    const char text[] = "this is someone else's file";
+    bytes.assign(text, text + sizeof(text));
+    WriteFile(path, bytes);
+    {
+        ProgressStore store;
+        CHECK(!store.Open(path));
+        CHECK(SameProgress(store.Progress(), SavedProgress()));
+    }
+    CHECK(ReadFile(path) == bytes);
+    remove(path);
+}
+
+// --- Dead-end checker ------------------------------------------------------
+
+static SolveStatus Settle(DeadEndChecker& checker, SolveStatus status) {
+    while (checker.IsPending()) status = checker.Poll();
+    return status;
+}
+
+static void TestDeadEnds() {
+    GraphIndex graph;
+    DeadEndChecker checker;
+
+    // Path 0-1-2: only the ends can start it
+    graph.Build(3, {{0, 1, 0}, {1, 2, 0}});
+    checker.Reserve(graph);
+    CHECK(checker.Reset(graph, 1) == SOLVE_WRONG_START);
+    CHECK(checker.IsStuck());
+    CHECK(checker.Reset(graph, 0) == SOLVE_OK);
+    CHECK(Settle(checker, checker.Step(0, 0, 1)) == SOLVE_OK);
+    CHECK(Settle(checker, checker.Step(1, 1, 2)) == SOLVE_ALREADY_COMPLETE);
+
+    // Star with three leaves: four odd nodes
+    graph.Build(4, {{0, 1, 0}, {0, 2, 0}, {0, 3, 0}});
+    checker.Reserve(graph);
+    CHECK(checker.Reset(graph, 0) == SOLVE_TOO_MANY_ODD);
+
+    // Lollipop: stem 0-1, loop 1-2-3. Leaving the loop behind strands it.
+    graph.Build(4, {{0, 1, 0}, {1, 2, 0}, {2, 3, 0}, {3, 1, 0}});
+    checker.Reserve(graph);
+    CHECK(checker.Reset(graph, 1) == SOLVE_OK);
+    CHECK(Settle(checker, checker.Step(0, 1, 0)) == SOLVE_DISCONNECTED);
+    CHECK(checker.IsStuck());
+    CHECK(checker.Reset(graph, 1) == SOLVE_OK);
+    CHECK(Settle(checker, checker.Step(1, 1, 2)) == SOLVE_OK);
+    CHECK(Settle(checker, checker.Step(2, 2, 3)) == SOLVE_OK);
+    CHECK(Settle(checker, checker.Step(3, 3, 1)) == SOLVE_OK);
+    CHECK(Settle(checker, checker.Step(0, 1, 0)) == SOLVE_ALREADY_COMPLETE);
+
+    // Bowtie at 0: finishing one loop first keeps the other reachable
+    graph.Build(5, {{0, 1, 0}, {1, 2, 0}, {2, 0, 0}, {0, 3, 0}, {3, 4, 0}, {4, 0, 0}});
+    checker.Reserve(graph);
+    CHECK(checker.Reset(graph, 0) == SOLVE_OK);
+    CHECK(Settle(checker, checker.Step(0, 0, 1)) == SOLVE_OK);
+    CHECK(Settle(checker, checker.Step(1, 1, 2)) == SOLVE_OK);
+    CHECK(Settle(checker, checker.Step(2, 2, 0)) == SOLVE_OK);
+
+    // Dumbbell: two long rings joined by a bridge. Crossing the bridge first
+    // strands the ring left behind; both sides outgrow one call's search
+    // budget, so the verdict only arrives through Poll.
+    const int kRing = DeadEndChecker::kSearchBudget * 3;
+    vector<Edge> dumbbell;
+    for (int i = 0; i < kRing; i++) dumbbell.push_back({i, (i + 1) % kRing, 0});
+    for (int i = 0; i < kRing; i++) dumbbell.push_back({kRing + i, kRing + (i + 1) % kRing, 0});
+    dumbbell.push_back({0, kRing, 0});
+    graph.Build(kRing * 2, dumbbell);
+    checker.Reserve(graph);
+    CHECK(checker.Reset(graph, 0) == SOLVE_OK);
+    SolveStatus status = checker.Step(kRing * 2, 0, kRing);
+    CHECK(status == SOLVE_OK && checker.IsPending());
+    CHECK(Settle(checker, status) == SOLVE_DISCONNECTED);
+    CHECK(checker.Reset(graph, 0) == SOLVE_OK);
+    status = checker.Step(0, 0, 1);
+    CHECK(checker.IsPending());
+    CHECK(Settle(checker, status) == SOLVE_OK);
+}
+
+int main() {
+    TestPackRoundTrip();
+    TestPackCorruption();
+    TestRecordingRoundTrip();
+    TestRecordingCorruption();
+    TestJournal();
+    TestDeadEnds();
+
+    if (failures > 0) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,486 @@
+// strokex_bench: micro-benchmarks for the per-frame hot paths on synthetic
+// boards from 10 to 10^6 edges. Every benchmark runs a fixed amount of work
+// per repetition, so numbers from different versions line up; results go
+// to stdout as CSV, or JSON Lines with --json, one row per benchmark and
+// board size.
+
+#include "core/euler_solver.h"
+#include "core/frame_snapshot.h"
+#include "core/level_pack.h"
+#include "core/particle_pool.h"
+#include "core/platform.h"
+#include "core/puzzle_core.h"
+#include "core/rng.h"
+#include "core/spatial_grid.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+static const float kSpacing = 100.0f;
+// Boards start right of the playfield, clear of the on-screen buttons
+static const float kOriginX = 2000.0f;
+static const float kOriginY = 100.0f;
+
+static const int kQueries = 1 << 16;
+static const long long kQueryIterations = 200000;
+static const long long kLoadWork = 2000000;      // edges decoded per repetition
+static const long long kStrokeWork = 200000;     // edges traced per repetition
+static const long long kSolveWork = 2000000;     // edges walked by the solver per repetition
+static const long long kParticleWork = 20000000; // particle steps per repetition
+static const long long kSnapshotWork = 20000000; // edge states captured per repetition
+
+static volatile long long sink;
+
+static void PrintUsage() {
+    printf("usage: strokex_bench [--min-edges N] [--max-edges N] [--repeat N] [--filter NAME] [--seed N] [--json]\n");
+}
+
+// The outlines of every other cell of an n x n grid, n odd. Every node has
+// degree 2 or 4 and the cells touch corner to corner, so the board is one
+// Euler circuit, and every edge is one grid step long.
+struct Board {
+    int targetEdges;
+    int cells;
+    vector<Node> nodes;
+    vector<Edge> edges;
+};
+
+static void BuildBoard(int targetEdges, Board& board) {
+    board.targetEdges = targetEdges;
+    board.cells = max(1, (int)lround(sqrt(targetEdges / 2.0))) | 1;
+    int side = board.cells + 1;
+    board.nodes.clear();
+    board.edges.clear();
+    for (int y = 0; y < side; y++) {
+        for (int x = 0; x < side; x++) {
+            board.nodes.push_back({{kOriginX + x * kSpacing, kOriginY + y * kSpacing}, y * side + x, false});
+        }
+    }
+    for (int y = 0; y < board.cells; y++) {
+        for (int x = (y & 1); x < board.cells; x += 2) {
+            int corner = y * side + x;
+            board.edges.push_back({corner, corner + 1, 0});
+            board.edges.push_back({corner + 1, corner + side + 1, 0});
+            board.edges.push_back({corner + side + 1, corner + side, 0});
+            board.edges.push_back({corner + side, corner, 0});
+        }
+    }
+}
+
+static double NanosSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+}
+
+class Reporter {
+public:
+    explicit Reporter(bool json) : json(json) {
+        if (!json) printf("benchmark,size,edges,nodes,iterations,best_ns,median_ns\n");
+    }
+
+    // `samples` holds the mean ns per operation of each repetition
+    void Row(const char* name, const Board& board, long long iterations, vector<double>& samples) {
+        sort(samples.begin(), samples.end());
+        double best = samples.front();
+        double median = samples[samples.size() / 2];
+        if (json) {
+            printf("{\"benchmark\":\"%s\",\"size\":%d,\"edges\":%d,\"nodes\":%d,\"iterations\":%lld,"
+                   "\"best_ns\":%.2f,\"median_ns\":%.2f}\n",
+                   name, board.targetEdges, (int)board.edges.size(), (int)board.nodes.size(), iterations, best, median);
+        } else {
+            printf("%s,%d,%d,%d,%lld,%.2f,%.2f\n", name, board.targetEdges, (int)board.edges.size(),
+                   (int)board.nodes.size(), iterations, best, median);
+        }
+        fflush(stdout);
+    }
+
+private:
+    bool json;
+};
+
+struct BenchContext {
+    Reporter& report;
+    int repeat;
+    const char* filter;
+    Rng& rng;
+    PuzzleCore& core;
+    FixedStepClock& clock;
+    float nodeRadius;
+
+    bool Selected(const char* name) const { return !filter || strstr(name, filter); }
+};
+
+static Vec2 RandomPoint(Rng& rng, const Board& board) {
+    float extent = board.cells * kSpacing;
+    return {kOriginX - kSpacing + rng.Float01() * (extent + 2 * kSpacing),
+            kOriginY - kSpacing + rng.Float01() * (extent + 2 * kSpacing)};
+}
+
+// Cursor lookups: nearest node under a point, and every node a segment
+// of up to two grid steps crosses
+static void BenchHitTests(BenchContext& ctx, const Board& board) {
+    NodeGrid grid;
+    grid.Build(board.nodes, ctx.nodeRadius);
+    vector<Vec2> points(kQueries);
+    vector<Vec2> ends(kQueries);
+    for (int i = 0; i < kQueries; i++) {
+        points[i] = RandomPoint(ctx.rng, board);
+        float angle = ctx.rng.Float01() * 6.2831853f;
+        float length = ctx.rng.Float01() * 2 * kSpacing;
+        ends[i] = {points[i].x + cosf(angle) * length, points[i].y + sinf(angle) * length};
+    }
+
+    if (ctx.Selected("hit_test")) {
+        vector<double> samples;
+        for (int rep = 0; rep < ctx.repeat; rep++) {
+            long long found = 0;
+            auto start = chrono::steady_clock::now();
+            for (long long i = 0; i < kQueryIterations; i++) {
+                found += grid.FindNearest(points[i & (kQueries - 1)]);
+            }
+            samples.push_back(NanosSince(start) / kQueryIterations);
+            sink = found;
+        }
+        ctx.report.Row("hit_test", board, kQueryIterations, samples);
+    }
+
+    if (ctx.Selected("hit_sweep")) {
+        vector<SegmentHit> hits;
+        vector<double> samples;
+        for (int rep = 0; rep < ctx.repeat; rep++) {
+            long long found = 0;
+            auto start = chrono::steady_clock::now();
+            for (long long i = 0; i < kQueryIterations; i++) {
+                grid.FindAlongSegment(points[i & (kQueries - 1)], ends[i & (kQueries - 1)], hits);
+                found += (long long)hits.size();
+            }
+            samples.push_back(NanosSince(start) / kQueryIterations);
+            sink = found;
+        }
+        ctx.report.Row("hit_sweep", board, kQueryIterations, samples);
+    }
+}
+
+// Edge between two nodes, as looked up for every node a stroke enters
+static void BenchEdgeLookup(BenchContext& ctx, const Board& board) {
+    if (!ctx.Selected("edge_lookup")) return;
+    GraphIndex graph;
+    graph.Build((int)board.nodes.size(), board.edges);
+    vector<int> from(kQueries);
+    vector<int> to(kQueries);
+    for (int i = 0; i < kQueries; i++) {
+        const Edge& edge = board.edges[ctx.rng.Range(0, (int)board.edges.size() - 1)];
+        bool flip = ctx.rng.Range(0, 1) == 1;
+        from[i] = flip ? edge.nodeB : edge.nodeA;
+        to[i] = flip ? edge.nodeA : edge.nodeB;
+    }
+
+    vector<double> samples;
+    for (int rep = 0; rep < ctx.repeat; rep++) {
+        long long found = 0;
+        auto start = chrono::steady_clock::now();
+        for (long long i = 0; i < kQueryIterations; i++) {
+            found += graph.FindEdge(from[i & (kQueries - 1)], to[i & (kQueries - 1)], board.edges);
+        }
+        samples.push_back(NanosSince(start) / kQueryIterations);
+        sink = found;
+    }
+    ctx.report.Row("edge_lookup", board, kQueryIterations, samples);
+}
+
+// Decode from the memory-mapped pack plus the index rebuilds
+static void BenchLevelLoad(BenchContext& ctx, const Board& board, int level) {
+    if (!ctx.Selected("level_load")) return;
+    long long iterations = max(1LL, kLoadWork / (long long)board.edges.size());
+    vector<double> samples;
+    for (int rep = 0; rep < ctx.repeat; rep++) {
+        auto start = chrono::steady_clock::now();
+        for (long long i = 0; i < iterations; i++) ctx.core.LoadLevel(level);
+        samples.push_back(NanosSince(start) / iterations);
+    }
+    ctx.report.Row("level_load", board, iterations, samples);
+}
+
+// Hierholzer's walk over the whole untouched board, the most a hint or an
+// auto-solve ever asks of the solver
+static bool BenchSolve(BenchContext& ctx, const Board& board) {
+    if (!ctx.Selected("solve")) return true;
+    GraphIndex graph;
+    graph.Build((int)board.nodes.size(), board.edges);
+    DynamicBitset none;
+    none.Resize(board.edges.size());
+    EulerSolver solver;
+    SolveResult result;
+    long long iterations = max(1LL, kSolveWork / (long long)board.edges.size());
+    vector<double> samples;
+    for (int rep = 0; rep < ctx.repeat; rep++) {
+        auto start = chrono::steady_clock::now();
+        for (long long i = 0; i < iterations; i++) solver.Solve(graph, none, -1, result);
+        samples.push_back(NanosSince(start) / iterations);
+        if (result.status != SOLVE_OK || result.edges.size() != board.edges.size()) return false;
+    }
+    ctx.report.Row("solve", board, iterations, samples);
+    return true;
+}
+
+static void Step(BenchContext& ctx, Vec2 pos, bool down, bool pressed, bool released) {
+    ctx.clock.Advance();
+    FrameInput input = {pos, down, pressed, released, false};
+    ctx.core.Update(input);
+}
+
+// Full frames through the core while the board is traced along its Euler
+// circuit one edge a frame (path_update, per frame), then the release that
+// checks the solution (solution_check). False if a stroke didn't complete.
+static bool BenchStroke(BenchContext& ctx, const Board& board, int level) {
+    bool pathSelected = ctx.Selected("path_update");
+    bool checkSelected = ctx.Selected("solution_check");
+    if (!pathSelected && !checkSelected) return true;
+
+    ctx.core.LoadLevel(level);
+    EulerSolver solver;
+    SolveResult circuit;
+    DynamicBitset none;
+    none.Resize(ctx.core.GetEdges().size());
+    solver.Solve(ctx.core.GetGraph(), none, -1, circuit);
+    if (circuit.status != SOLVE_OK) return false;
+    // The cursor is on screen; the core maps it back through the camera
+    vector<Vec2> stroke;
+    for (int node : circuit.nodes) stroke.push_back(ctx.core.GetView().WorldToScreen(ctx.core.GetNodes()[node].position));
+
+    long long strokes = max(1LL, kStrokeWork / (long long)board.edges.size());
+    long long frames = strokes * (long long)(stroke.size() - 1);
+    vector<double> pathSamples;
+    vector<double> checkSamples;
+    for (int rep = 0; rep < ctx.repeat; rep++) {
+        double pathNanos = 0.0;
+        double checkNanos = 0.0;
+        for (long long s = 0; s < strokes; s++) {
+            ctx.core.LoadLevel(level);
+            Step(ctx, stroke[0], true, true, false);
+
+            auto start = chrono::steady_clock::now();
+            for (size_t i = 1; i < stroke.size(); i++) Step(ctx, stroke[i], true, false, false);
+            pathNanos += NanosSince(start);
+
+            start = chrono::steady_clock::now();
+            Step(ctx, stroke.back(), false, false, true);
+            checkNanos += NanosSince(start);
+            if (!ctx.core.IsLevelComplete()) return false;
+        }
+        pathSamples.push_back(pathNanos / frames);
+        checkSamples.push_back(checkNanos / strokes);
+    }
+    if (pathSelected) ctx.report.Row("path_update", board, frames, pathSamples);
+    if (checkSelected) ctx.report.Row("solution_check", board, strokes, checkSamples);
+    return true;
+}
+
+// What the renderer asks for each time the view moves: the nodes and edges
+// inside a window-sized rect at 1:1 zoom, anywhere on the board
+static void BenchViewCull(BenchContext& ctx, const Board& board, int level) {
+    if (!ctx.Selected("view_cull")) return;
+    ctx.core.LoadLevel(level);
+    vector<Rect> views(kQueries);
+    for (int i = 0; i < kQueries; i++) {
+        Vec2 corner = RandomPoint(ctx.rng, board);
+        views[i] = {corner.x - 940.0f, corner.y - 530.0f, 1880.0f, 1060.0f};
+    }
+
+    vector<int> visibleNodes;
+    vector<int> visibleEdges;
+    long long iterations = kQueryIterations / 20;
+    vector<double> samples;
+    for (int rep = 0; rep < ctx.repeat; rep++) {
+        long long found = 0;
+        auto start = chrono::steady_clock::now();
+        for (long long i = 0; i < iterations; i++) {
+            const Rect& view = views[i & (kQueries - 1)];
+            ctx.core.FindNodesInRect(view, visibleNodes);
+            ctx.core.FindEdgesInRect(view, visibleEdges);
+            found += (long long)(visibleNodes.size() + visibleEdges.size());
+        }
+        samples.push_back(NanosSince(start) / iterations);
+        sink = found;
+    }
+    ctx.report.Row("view_cull", board, iterations, samples);
+}
+
+// Capturing the render snapshot after a frame that traced an edge, so the
+// per-edge and per-node states are rebuilt every time: the simulation
+// thread's cost per frame while the player draws
+static bool BenchSnapshot(BenchContext& ctx, const Board& board, int level) {
+    if (!ctx.Selected("frame_snapshot")) return true;
+    ctx.core.LoadLevel(level);
+    EulerSolver solver;
+    SolveResult circuit;
+    DynamicBitset none;
+    none.Resize(ctx.core.GetEdges().size());
+    solver.Solve(ctx.core.GetGraph(), none, -1, circuit);
+    if (circuit.status != SOLVE_OK) return false;
+    vector<Vec2> stroke;
+    for (int node : circuit.nodes) stroke.push_back(ctx.core.GetView().WorldToScreen(ctx.core.GetNodes()[node].position));
+
+    SnapshotWriter writer;
+    SnapshotBuffer snapshots;
+    writer.SetCullMargin(ctx.core.GetNodeRadius(), 0.0f);
+    long long frames = max(1LL, kSnapshotWork / (long long)board.edges.size());
+    vector<double> samples;
+    for (int rep = 0; rep < ctx.repeat; rep++) {
+        double nanos = 0.0;
+        size_t next = stroke.size();
+        for (long long f = 0; f < frames; f++) {
+            if (next == stroke.size()) {
+                ctx.core.ResetPath();
+                Step(ctx, stroke[0], true, true, false);
+                next = 1;
+            }
+            Step(ctx, stroke[next++], true, false, false);
+
+            auto start = chrono::steady_clock::now();
+            writer.Capture(ctx.core, snapshots.WriteSlot());
+            snapshots.Publish();
+            nanos += NanosSince(start);
+            sink = snapshots.Acquire()->frame;
+        }
+        Step(ctx, stroke[next - 1], false, false, true);
+        samples.push_back(nanos / frames);
+    }
+    ctx.report.Row("frame_snapshot", board, frames, samples);
+    return true;
+}
+
+// One fixed tick over a pool holding as many live particles as the board
+// has edges. The pool is refilled, untimed, every half second of simulated
+// time: particles live under a second in the game, and velocities decayed
+// for longer would go denormal and measure the FPU instead.
+static void BenchParticles(BenchContext& ctx, const Board& board) {
+    if (!ctx.Selected("particle_update")) return;
+    static const int kTicksPerFill = PuzzleCore::kTickRate / 2;
+    int count = (int)board.edges.size();
+    ParticlePool pool(count, 1);
+    ParticleEmission emission;
+    emission.particlesPerBurst = 64;
+    // Nothing dies between refills, so every update sees the full pool
+    emission.minLifetime = 10.0f;
+    emission.maxLifetime = 10.0f;
+    pool.SetEmission(emission);
+
+    long long fills = max(1LL, kParticleWork / ((long long)count * kTicksPerFill));
+    long long iterations = fills * kTicksPerFill;
+    float tick = 1.0f / PuzzleCore::kTickRate;
+    vector<double> samples;
+    for (int rep = 0; rep < ctx.repeat; rep++) {
+        double nanos = 0.0;
+        for (long long fill = 0; fill < fills; fill++) {
+            pool.Clear();
+            while (pool.Count() < count) pool.Emit(RandomPoint(ctx.rng, board));
+            auto start = chrono::steady_clock::now();
+            for (int i = 0; i < kTicksPerFill; i++) pool.Update(tick);
+            nanos += NanosSince(start);
+        }
+        samples.push_back(nanos / iterations);
+    }
+    ctx.report.Row("particle_update", board, iterations, samples);
+}
+
+int main(int argc, char** argv) {
+    int minEdges = 10;
+    int maxEdges = 1000000;
+    int repeat = 5;
+    unsigned int seed = 1;
+    const char* filter = nullptr;
+    bool json = false;
+    const char* packPath = "strokex_bench.sxpk";
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--min-edges") == 0 && i + 1 < argc) {
+            minEdges = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--max-edges") == 0 && i + 1 < argc) {
+            maxEdges = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+            repeat = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = (unsigned int)strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--json") == 0) {
+            json = true;
+        } else {
+            PrintUsage();
+            return 1;
+        }
+    }
+    if (minEdges < 1 || maxEdges < minEdges || repeat < 1) {
+        PrintUsage();
+        return 1;
+    }
+
+    // Sizes go up in powers of ten
+    vector<Board> boards;
+    for (long long size = minEdges; size <= maxEdges; size *= 10) {
+        boards.emplace_back();
+        BuildBoard((int)size, boards.back());
+    }
+
+    // The level loader and the stroke benchmarks read the boards back from
+    // a pack, like the game does
+    float extent = boards.back().cells * kSpacing;
+    LevelPackWriter writer;
+    if (!writer.Begin(packPath, Rect{kOriginX, kOriginY, extent, extent})) {
+        fprintf(stderr, "%s: can't write pack\n", packPath);
+        return 1;
+    }
+    for (const Board& board : boards) writer.AddLevel(board.nodes, board.edges);
+    if (!writer.Finish()) {
+        fprintf(stderr, "%s: can't write pack\n", packPath);
+        return 1;
+    }
+
+    FixedStepClock clock(1.0f / 60.0f);
+    PuzzleCore core(clock, seed);
+    if (!core.OpenLevelPack(packPath)) {
+        fprintf(stderr, "%s: can't open pack\n", packPath);
+        return 1;
+    }
+    Rect startButton = core.GetStartButton();
+    Vec2 start = {startButton.x + startButton.width * 0.5f, startButton.y + startButton.height * 0.5f};
+    clock.Advance();
+    core.Update(FrameInput{start, true, true, false, false});
+
+    Rng rng(seed);
+    Reporter report(json);
+    BenchContext ctx = {report, repeat, filter, rng, core, clock, core.GetNodeRadius()};
+    int failures = 0;
+    for (size_t i = 0; i < boards.size(); i++) {
+        const Board& board = boards[i];
+        int level = (int)i + 1;
+        BenchHitTests(ctx, board);
+        BenchEdgeLookup(ctx, board);
+        BenchLevelLoad(ctx, board, level);
+        if (!BenchSolve(ctx, board)) {
+            fprintf(stderr, "%d edges: solver found no trail over the board\n", (int)board.edges.size());
+            failures++;
+        }
+        if (!BenchStroke(ctx, board, level)) {
+            fprintf(stderr, "%d edges: traced stroke did not complete the level\n", (int)board.edges.size());
+            failures++;
+        }
+        BenchViewCull(ctx, board, level);
+        if (!BenchSnapshot(ctx, board, level)) {
+            fprintf(stderr, "%d edges: no circuit to trace for the snapshot\n", (int)board.edges.size());
+            failures++;
+        }
+        BenchParticles(ctx, board);
+    }
+
+    remove(packPath);
+    return failures == 0 ? 0 : 1;
+}
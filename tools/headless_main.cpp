@@ -0,0 +1,433 @@
+// strokex_headless: runs the full game loop without a window, driven by the
+// autoplay bot on a virtual clock, as fast as the host allows.
+
+#include "core/autoplay_input.h"
+#include "core/dead_end_checker.h"
+#include "core/dot_field.h"
+#include "core/platform.h"
+#include "core/profiler.h"
+#include "core/progress_store.h"
+#include "core/puzzle_core.h"
+#include "core/replay.h"
+#include "core/rng.h"
+#include "core/simulation_thread.h"
+#include "core/thread_pool.h"
+#include "core/trail_counter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using namespace std;
+
+static void PrintUsage() {
+    printf("usage: strokex_headless [--frames N] [--dt SECONDS] [--seed N] [--pack PATH] [--flick] [--threaded] [--validate] [--generate N] [--deadend EDGES] [--background DOTS] [--record FILE] [--replay FILE] [--trace FILE] [--save FILE]\n");
+}
+
+// Run the solver over every level in the pack and report its verdict
+// together with its exact trail analysis, counted both serially and split
+// across a thread pool; the two counts must agree
+static int ValidateLevels(PuzzleCore& core) {
+    int failures = 0;
+    TrailCounter counter;
+    TrailStats stats;
+    TrailStats parallelStats;
+    ThreadPool pool;
+    for (int level = 1; level <= core.GetPackLevelCount(); level++) {
+        core.LoadLevel(level);
+        auto start = chrono::steady_clock::now();
+        SolveStatus status = core.ValidateLevel();
+        double micros = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+
+        start = chrono::steady_clock::now();
+        bool exact = counter.Count(core.GetGraph(), stats);
+        double countMicros = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+
+        start = chrono::steady_clock::now();
+        bool parallelExact = TrailCounter::CountParallel(pool, core.GetGraph(), parallelStats);
+        double parallelMicros = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+        // Threads run with a budget each, so only exact counts are comparable
+        bool agree = !exact || !parallelExact ||
+                     (stats.trails == parallelStats.trails && stats.deadEnds == parallelStats.deadEnds &&
+                      fabs(stats.successChance - parallelStats.successChance) < 1e-9);
+
+        printf("level %2d: %2d nodes %3d edges  %-18s %.1f us  trails %llu dead ends %llu difficulty %.3f%s  %.1f us (parallel %.1f us%s)\n",
+               level, (int)core.GetNodes().size(), (int)core.GetEdges().size(), SolveStatusName(status), micros,
+               (unsigned long long)stats.trails, (unsigned long long)stats.deadEnds, TrailDifficulty(stats),
+               exact ? "" : " (inexact)", countMicros, parallelMicros, agree ? "" : ", MISMATCH");
+        if (status != SOLVE_OK || !agree) failures++;
+    }
+    return failures == 0 ? 0 : 1;
+}
+
+// Generate levels across the difficulty range and report generator throughput
+static int GenerateLevels(PuzzleCore& core, int count, unsigned int seed) {
+    LevelGenerator& generator = core.GetLevelGenerator();
+    long long builtBefore = generator.CandidatesBuilt();
+    int failures = 0;
+
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < count; i++) {
+        float difficulty = count > 1 ? (float)i / (float)(count - 1) : 0.5f;
+        GeneratorParams params = MakeGeneratorParams(difficulty, core.GetNodeRadius());
+        GeneratedLevel level;
+        if (!generator.Generate(MixSeed(seed, (uint64_t)i), params, level)) {
+            printf("level %3d: target %.2f  no candidate\n", i, difficulty);
+            failures++;
+            continue;
+        }
+        printf("level %3d: target %.2f  rating %.2f  %2d nodes %2d edges\n", i, difficulty, level.rating,
+               (int)level.nodes.size(), (int)level.edges.size());
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    long long built = generator.CandidatesBuilt() - builtBefore;
+
+    printf("candidates:        %lld\n", built);
+    printf("candidates/s:      %.0f\n", built / seconds);
+    printf("levels/s:          %.1f\n", count / seconds);
+    return failures == 0 ? 0 : 1;
+}
+
+struct StepTimes {
+    vector<double> micros;
+
+    void Print(const char* label) {
+        if (micros.empty()) return;
+        sort(micros.begin(), micros.end());
+        double total = 0.0;
+        for (double m : micros) total += m;
+        printf("%-18s %zu steps  avg %.2f us  p99 %.2f us  max %.2f us\n", label, micros.size(),
+               total / micros.size(), micros[micros.size() * 99 / 100], micros.back());
+    }
+};
+
+// Time the live dead-end check on a torus grid with about `edgeCount`
+// edges, then cross-check its verdicts against the full solver on small
+// generated levels
+static int BenchDeadEnds(int edgeCount, unsigned int seed) {
+    int side = max(3, (int)lround(sqrt(edgeCount / 2.0)));
+    vector<Edge> edges;
+    for (int y = 0; y < side; y++) {
+        for (int x = 0; x < side; x++) {
+            int node = y * side + x;
+            edges.push_back({node, y * side + (x + 1) % side, 0});
+            edges.push_back({node, ((y + 1) % side) * side + x, 0});
+        }
+    }
+    GraphIndex graph;
+    graph.Build(side * side, edges);
+    printf("torus:             %d nodes %d edges\n", graph.NodeCount(), graph.EdgeCount());
+
+    DeadEndChecker checker;
+    EulerSolver solver;
+    SolveResult trail;
+    DynamicBitset none;
+    none.Resize(edges.size());
+    solver.Solve(graph, none, -1, trail);
+
+    // A full solution: every step keeps the stroke finishable
+    StepTimes solved;
+    checker.Reset(graph, trail.nodes[0]);
+    for (size_t i = 0; i < trail.edges.size(); i++) {
+        auto start = chrono::steady_clock::now();
+        checker.Step(trail.edges[i], trail.nodes[i], trail.nodes[i + 1]);
+        solved.micros.push_back(chrono::duration<double, micro>(chrono::steady_clock::now() - start).count());
+    }
+    solved.Print("solution stroke:");
+    int failures = checker.Status() == SOLVE_ALREADY_COMPLETE ? 0 : 1;
+
+    // Random strokes, which cut the board up as they go
+    Rng rng(seed);
+    StepTimes random;
+    vector<char> traced(edges.size());
+    vector<int> options;
+    for (int stroke = 0; stroke < 20; stroke++) {
+        fill(traced.begin(), traced.end(), 0);
+        int current = rng.Range(0, graph.NodeCount() - 1);
+        checker.Reset(graph, current);
+        while (true) {
+            options.clear();
+            for (const HalfEdge* he = graph.NeighborsBegin(current); he != graph.NeighborsEnd(current); ++he) {
+                if (!traced[he->edge]) options.push_back(he->edge);
+            }
+            if (options.empty()) break;
+            int edge = options[rng.Range(0, (int)options.size() - 1)];
+            int next = graph.OtherNode(edge, current);
+            traced[edge] = 1;
+            auto start = chrono::steady_clock::now();
+            checker.Step(edge, current, next);
+            random.micros.push_back(chrono::duration<double, micro>(chrono::steady_clock::now() - start).count());
+            current = next;
+        }
+    }
+    random.Print("random strokes:");
+
+    // Every verdict must match a from-scratch solve
+    long long checked = 0;
+    long long mismatches = 0;
+    GeneratorParams params = MakeGeneratorParams(0.8f, 39.2f);
+    GeneratedLevel level;
+    SolveResult result;
+    vector<int> pathEdges;
+    for (int i = 0; i < 500; i++) {
+        if (!LevelGenerator::BuildCandidate(MixSeed(seed, (uint64_t)i), params, level)) continue;
+        GraphIndex small;
+        small.Build((int)level.nodes.size(), level.edges);
+        int current = rng.Range(0, small.NodeCount() - 1);
+        checker.Reset(small, current);
+        pathEdges.clear();
+        while (!checker.IsStuck() && checker.Status() != SOLVE_ALREADY_COMPLETE) {
+            options.clear();
+            for (const HalfEdge* he = small.NeighborsBegin(current); he != small.NeighborsEnd(current); ++he) {
+                if (find(pathEdges.begin(), pathEdges.end(), he->edge) == pathEdges.end()) options.push_back(he->edge);
+            }
+            if (options.empty()) break;
+            int edge = options[rng.Range(0, (int)options.size() - 1)];
+            int next = small.OtherNode(edge, current);
+            pathEdges.push_back(edge);
+            checker.Step(edge, current, next);
+            bool live = !checker.IsStuck();
+            solver.SolveFromEdges(small, pathEdges, next, result);
+            bool solvable = result.status == SOLVE_OK || result.status == SOLVE_ALREADY_COMPLETE;
+            if (live != solvable) mismatches++;
+            checked++;
+            current = next;
+        }
+    }
+    printf("verified:          %lld steps, %lld mismatches\n", checked, mismatches);
+    return (failures == 0 && mismatches == 0) ? 0 : 1;
+}
+
+// Time the start screen background at a given density: one second of
+// simulation ticks, with the neighbour lines refreshed every 60 Hz frame
+static int BenchBackground(int dotCount, unsigned int seed) {
+    ThreadPool pool;
+    DotField field;
+    field.Reset(dotCount, {0, 0, 1880, 1060}, seed);
+
+    StepTimes steps;
+    StepTimes linkTimes;
+    float tick = 1.0f / PuzzleCore::kTickRate;
+    for (int i = 0; i < PuzzleCore::kTickRate; i++) {
+        auto start = chrono::steady_clock::now();
+        field.Step(tick, pool);
+        steps.micros.push_back(chrono::duration<double, micro>(chrono::steady_clock::now() - start).count());
+        if (i % (PuzzleCore::kTickRate / 60) != 0) continue;
+
+        start = chrono::steady_clock::now();
+        field.FindLinks(PuzzleCore::kMaxBackgroundLinks, pool);
+        linkTimes.micros.push_back(chrono::duration<double, micro>(chrono::steady_clock::now() - start).count());
+    }
+
+    printf("dots:              %d, %d linked\n", field.Count(), field.LinkedCount());
+    printf("threads:           %d\n", pool.WorkerCount() + 1);
+    printf("links:             %zu within %.1f px\n", field.Links().size(), field.LinkDistance());
+    steps.Print("step:");
+    linkTimes.Print("links:");
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    long long frames = 100000;
+    float dt = 1.0f / 60.0f;
+    unsigned int seed = 1;
+    bool validate = false;
+    bool flick = false;
+    bool threaded = false;
+    int generate = 0;
+    int deadEndEdges = 0;
+    int backgroundDots = 0;
+    const char* packPath = "levels.sxpk";
+    const char* recordPath = nullptr;
+    const char* replayPath = nullptr;
+    const char* tracePath = nullptr;
+    const char* savePath = nullptr;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frames = atoll(argv[++i]);
+        } else if (strcmp(argv[i], "--dt") == 0 && i + 1 < argc) {
+            dt = (float)atof(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = (unsigned int)strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--pack") == 0 && i + 1 < argc) {
+            packPath = argv[++i];
+        } else if (strcmp(argv[i], "--flick") == 0) {
+            flick = true;
+        } else if (strcmp(argv[i], "--threaded") == 0) {
+            threaded = true;
+        } else if (strcmp(argv[i], "--validate") == 0) {
+            validate = true;
+        } else if (strcmp(argv[i], "--generate") == 0 && i + 1 < argc) {
+            generate = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--deadend") == 0 && i + 1 < argc) {
+            deadEndEdges = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            recordPath = argv[++i];
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replayPath = argv[++i];
+        } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            tracePath = argv[++i];
+        } else if (strcmp(argv[i], "--save") == 0 && i + 1 < argc) {
+            savePath = argv[++i];
+        } else if (strcmp(argv[i], "--background") == 0 && i + 1 < argc) {
+            backgroundDots = atoi(argv[++i]);
+        } else {
+            PrintUsage();
+            return 1;
+        }
+    }
+    if (frames <= 0 || dt <= 0.0f) {
+        PrintUsage();
+        return 1;
+    }
+    if (tracePath && !Profiler::kEnabled) {
+        fprintf(stderr, "--trace needs a build configured with -DSTROKEX_PROFILING=ON\n");
+        return 1;
+    }
+
+    if (deadEndEdges > 0) return BenchDeadEnds(deadEndEdges, seed);
+    if (backgroundDots > 0) return BenchBackground(backgroundDots, seed);
+
+    // A replay brings its own seed, clock and input
+    InputReplayer replayer;
+    FrameClock clock;
+    if (replayPath) {
+        if (!replayer.Open(replayPath, clock)) {
+            fprintf(stderr, "%s: not a readable recording\n", replayPath);
+            return 1;
+        }
+        seed = (unsigned int)replayer.Info().seed;
+        frames = replayer.Info().frames;
+    }
+
+    FixedStepClock stepClock(dt);
+    // With --threaded the core runs on a SimulationThread with a clock of
+    // its own, set from each posted frame
+    FrameClock simClock;
+    PuzzleCore core(threaded ? simClock : clock, seed);
+    if (!core.OpenLevelPack(packPath)) {
+        fprintf(stderr, "%s: no level pack, every level will be generated\n", packPath);
+    }
+    if (replayPath && core.GetPackHash() != replayer.Info().packHash) {
+        fprintf(stderr, "%s: recorded with a different level pack\n", replayPath);
+        return 1;
+    }
+    if (validate) return ValidateLevels(core);
+    if (generate > 0) return GenerateLevels(core, generate, seed);
+
+    // Resume from saved progress, except for recordings and replays,
+    // which always start from level 1
+    ProgressStore progress;
+    if (savePath) {
+        if (!progress.Open(savePath)) {
+            fprintf(stderr, "%s: not a progress journal\n", savePath);
+            return 1;
+        }
+        core.AttachProgressStore(&progress, !recordPath && !replayPath);
+        printf("progress load:     %.1f us, level %d, %lld bytes dropped\n", progress.LoadMicros(),
+               progress.Progress().maxUnlockedLevel, progress.DroppedBytes());
+    }
+
+    AutoplayInput autoplay(core, seed);
+    autoplay.SetFlick(flick);
+    InputSource& input = replayPath ? (InputSource&)replayer : (InputSource&)autoplay;
+
+    InputRecorder recorder;
+    if (recordPath && !recorder.Begin(recordPath, seed, core.GetPackHash())) {
+        fprintf(stderr, "%s: can't write recording\n", recordPath);
+        return 1;
+    }
+
+    SimulationThread sim(core, simClock, &recorder);
+    sim.SetCullMargin(core.GetNodeRadius(), 0.0f);
+    if (threaded) sim.Start();
+    long long snapshots = 0;
+
+    long long levelsCompleted = 0;
+    bool wasComplete = false;
+
+    auto wallStart = chrono::steady_clock::now();
+    for (long long frame = 0; frame < frames; frame++) {
+        if (!replayPath) {
+            stepClock.Advance();
+            clock.SetFrame(stepClock.Now(), stepClock.FrameDelta());
+        }
+        FrameInput frameInput = input.Poll();
+        if (threaded) {
+            // The bot reads the core to plan its strokes, so each frame is
+            // waited for; this checks the hand-over, not the overlap
+            sim.PostFrame(clock.Now(), clock.FrameDelta(), frameInput);
+            sim.Flush();
+            if (sim.Acquire()) snapshots++;
+        } else {
+            recorder.RecordFrame(clock, frameInput);
+            core.Update(frameInput);
+        }
+        PROFILE_FRAME_END();
+
+        bool complete = core.IsLevelComplete();
+        if (complete && !wasComplete) levelsCompleted++;
+        wasComplete = complete;
+    }
+    sim.Stop();
+    double wallSeconds = chrono::duration<double>(chrono::steady_clock::now() - wallStart).count();
+    double simSeconds = clock.Now();
+
+    printf("frames:            %lld\n", frames);
+    printf("simulated time:    %.1f s\n", simSeconds);
+    printf("wall time:         %.3f s\n", wallSeconds);
+    printf("speed:             %.0fx real time\n", wallSeconds > 0 ? simSeconds / wallSeconds : 0.0);
+    printf("levels completed:  %lld\n", levelsCompleted);
+    printf("max level reached: %d\n", core.GetMaxUnlockedLevel());
+    printf("total score:       %d\n", core.GetTotalScore());
+    if (threaded) printf("snapshots:         %lld\n", snapshots);
+    printf("hint solves:       %lld (%lld cancelled)\n", core.GetHintService().SolveCount(), core.GetHintService().CancelCount());
+    // Built with allocation tracking, a frame during play that allocates
+    // has already stopped the run
+    const FrameAllocStats& allocs = core.GetFrameAllocStats();
+    if (AllocCounter::kEnabled) {
+        printf("frame allocations: %lld in %lld of %lld frames played\n", allocs.allocations, allocs.allocatingFrames,
+               allocs.steadyFrames);
+    }
+    const FrameAllocStats& captureAllocs = sim.GetCaptureAllocStats();
+    if (AllocCounter::kEnabled && threaded) {
+        printf("snapshot allocs:   %lld in %lld of %lld snapshots\n", captureAllocs.allocations,
+               captureAllocs.allocatingFrames, captureAllocs.steadyFrames);
+    }
+
+    if (savePath) {
+        progress.Close();
+        if (progress.HasWriteError()) {
+            fprintf(stderr, "%s: write failed\n", savePath);
+            return 1;
+        }
+    }
+
+    if (tracePath) {
+        Profiler& profiler = Profiler::Get();
+        printf("frame p50:         %.2f us\n", profiler.FramePercentile(0.5f) * 1000.0f);
+        printf("frame p99:         %.2f us\n", profiler.FramePercentile(0.99f) * 1000.0f);
+        if (!profiler.WriteChromeTrace(tracePath)) {
+            fprintf(stderr, "%s: can't write trace\n", tracePath);
+            return 1;
+        }
+    }
+
+    if (recordPath && !recorder.Finish(core.GetTotalScore(), core.GetMaxUnlockedLevel())) {
+        fprintf(stderr, "%s: write failed\n", recordPath);
+        return 1;
+    }
+    if (replayPath) {
+        const RecordingInfo& info = replayer.Info();
+        bool match = replayer.IsValid() && core.GetTotalScore() == info.totalScore &&
+                     core.GetMaxUnlockedLevel() == info.maxLevel;
+        printf("recorded score:    %d (max level %d)\n", info.totalScore, info.maxLevel);
+        printf("replay:            %s\n", match ? "verified" : replayer.IsValid() ? "MISMATCH" : "CORRUPT");
+        return match ? 0 : 1;
+    }
+    return 0;
+}
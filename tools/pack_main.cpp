@@ -0,0 +1,264 @@
+// strokex_pack: builds and inspects binary level packs (.sxpk).
+//
+//   strokex_pack -o levels.sxpk levels/builtin.txt    pack hand-made levels
+//   strokex_pack -o endless.sxpk --generate 100000    pack generated levels
+//   strokex_pack --info endless.sxpk                  open + random access timing
+//
+// --rate stores each level's difficulty (exact trail analysis, sampled for
+// levels too big to search) and --sort orders the pack easiest first.
+//
+// Text levels: "level" starts a level, "node X Y" adds the next node,
+// "edge A B" joins two nodes by index, "#" starts a comment.
+
+#include "core/level_generator.h"
+#include "core/level_pack.h"
+#include "core/rng.h"
+#include "core/thread_pool.h"
+#include "core/trail_counter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using namespace std;
+
+static void PrintUsage() {
+    printf("usage: strokex_pack -o OUT [--rate] [--sort] [--generate N] [--candidates N] [--seed N] [LEVELS.txt ...]\n");
+    printf("       strokex_pack --info PACK\n");
+}
+
+// Collects levels in batches so they can be rated in parallel, then writes
+// them in the order they came in
+class LevelSink {
+public:
+    LevelSink(LevelPackWriter& writer, ThreadPool& pool, bool rate) : writer(writer), pool(pool), rate(rate) {}
+
+    bool Add(const vector<Node>& nodes, const vector<Edge>& edges) {
+        batch.push_back({nodes, edges, -1.0f});
+        if (batch.size() >= 1024) return Flush();
+        return true;
+    }
+
+    bool Flush() {
+        if (rate) {
+            // Sampling is seeded by the level's place in the pack, so no two
+            // batches draw the same strokes
+            int firstLevel = writer.LevelCount();
+            pool.ParallelFor((int)batch.size(), 16, [this, firstLevel](int begin, int end) {
+                TrailCounter counter;
+                GraphIndex graph;
+                TrailStats stats;
+                for (int i = begin; i < end; i++) {
+                    PendingLevel& level = batch[i];
+                    graph.Build((int)level.nodes.size(), level.edges);
+                    if (counter.Count(graph, stats)) {
+                        level.difficulty = TrailDifficulty(stats);
+                    } else {
+                        level.difficulty = LevelGenerator::RateLevel(graph, (uint64_t)(firstLevel + i), 4096);
+                    }
+                }
+            });
+        }
+        bool ok = true;
+        for (const PendingLevel& level : batch) {
+            ok = ok && writer.AddLevel(level.nodes, level.edges, level.difficulty);
+        }
+        batch.clear();
+        return ok;
+    }
+
+private:
+    struct PendingLevel {
+        vector<Node> nodes;
+        vector<Edge> edges;
+        float difficulty;
+    };
+
+    LevelPackWriter& writer;
+    ThreadPool& pool;
+    bool rate;
+    vector<PendingLevel> batch;
+};
+
+static bool PackTextLevels(const char* path, LevelSink& sink) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        fprintf(stderr, "%s: cannot open\n", path);
+        return false;
+    }
+
+    vector<Node> nodes;
+    vector<Edge> edges;
+    bool inLevel = false;
+    bool ok = true;
+    char line[256];
+    int lineNumber = 0;
+
+    auto flush = [&]() {
+        if (inLevel && !sink.Add(nodes, edges)) ok = false;
+        nodes.clear();
+        edges.clear();
+    };
+
+    while (ok && fgets(line, sizeof(line), file)) {
+        lineNumber++;
+        char keyword[16];
+        if (sscanf(line, "%15s", keyword) != 1 || keyword[0] == '#') continue;
+
+        if (strcmp(keyword, "level") == 0) {
+            flush();
+            inLevel = true;
+            continue;
+        }
+
+        float x, y;
+        int a, b;
+        if (inLevel && strcmp(keyword, "node") == 0 && sscanf(line, "%*s %f %f", &x, &y) == 2) {
+            nodes.push_back({{x, y}, (int)nodes.size(), false});
+        } else if (inLevel && strcmp(keyword, "edge") == 0 && sscanf(line, "%*s %d %d", &a, &b) == 2 &&
+                   a >= 0 && b >= 0 && a < (int)nodes.size() && b < (int)nodes.size()) {
+            edges.push_back({a, b, 0});
+        } else {
+            fprintf(stderr, "%s:%d: bad line\n", path, lineNumber);
+            ok = false;
+        }
+    }
+    flush();
+    fclose(file);
+    return ok;
+}
+
+static bool PackGeneratedLevels(int count, int candidates, unsigned int seed, ThreadPool& pool, LevelSink& sink) {
+    LevelGenerator generator(pool);
+    GeneratedLevel level;
+
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < count; i++) {
+        // Difficulty ramps over every 100 levels
+        GeneratorParams params = MakeGeneratorParams((float)(i % 100) / 99.0f, 39.2f);
+        params.candidates = candidates;
+        bool built = false;
+        for (uint64_t attempt = 0; attempt < 256 && !built; attempt++) {
+            built = generator.Generate(MixSeed(MixSeed(seed, (uint64_t)i), attempt), params, level);
+        }
+        if (!built || !sink.Add(level.nodes, level.edges)) {
+            fprintf(stderr, "level %d: generation failed\n", i);
+            return false;
+        }
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    printf("generated %d levels in %.2f s (%.0f candidates/s)\n", count, seconds,
+           generator.CandidatesBuilt() / seconds);
+    return true;
+}
+
+static int PrintInfo(const char* path) {
+    auto start = chrono::steady_clock::now();
+    LevelPack pack;
+    if (!pack.Open(path)) {
+        fprintf(stderr, "%s: not a level pack\n", path);
+        return 1;
+    }
+    double openMicros = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+    printf("levels:            %d\n", pack.LevelCount());
+    printf("open:              %.1f us\n", openMicros);
+    if (pack.LevelCount() == 0) return 0;
+
+    int shown = min(pack.LevelCount(), 20);
+    for (int i = 0; i < shown; i++) {
+        float difficulty = pack.LevelDifficulty(i);
+        if (difficulty < 0.0f) {
+            printf("level %2d: unrated\n", i + 1);
+        } else {
+            printf("level %2d: difficulty %.3f\n", i + 1, difficulty);
+        }
+    }
+
+    // Random access over the whole pack, decoding into reused buffers
+    vector<Node> nodes;
+    vector<Edge> edges;
+    Rng rng(1);
+    long long edgeTotal = 0;
+    int decodes = 10000;
+    int failures = 0;
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < decodes; i++) {
+        if (!pack.DecodeLevel(rng.Range(0, pack.LevelCount() - 1), nodes, edges)) failures++;
+        edgeTotal += (long long)edges.size();
+    }
+    double decodeMicros = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+    printf("random decode:     %.2f us/level (%.1f edges avg)\n", decodeMicros / decodes,
+           (double)edgeTotal / decodes);
+    if (failures > 0) {
+        printf("corrupt records:   %d\n", failures);
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    const char* output = nullptr;
+    const char* info = nullptr;
+    int generate = 0;
+    int candidates = 8;
+    unsigned int seed = 1;
+    bool rate = false;
+    bool sort = false;
+    vector<const char*> inputs;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            output = argv[++i];
+        } else if (strcmp(argv[i], "--info") == 0 && i + 1 < argc) {
+            info = argv[++i];
+        } else if (strcmp(argv[i], "--generate") == 0 && i + 1 < argc) {
+            generate = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--candidates") == 0 && i + 1 < argc) {
+            candidates = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = (unsigned int)strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--rate") == 0) {
+            rate = true;
+        } else if (strcmp(argv[i], "--sort") == 0) {
+            sort = true;
+        } else if (argv[i][0] != '-') {
+            inputs.push_back(argv[i]);
+        } else {
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    if (info) return PrintInfo(info);
+    if (!output || (inputs.empty() && generate <= 0) || candidates <= 0) {
+        PrintUsage();
+        return 1;
+    }
+
+    LevelPackWriter writer;
+    if (!writer.Begin(output)) {
+        fprintf(stderr, "%s: cannot create\n", output);
+        return 1;
+    }
+    ThreadPool pool;
+    LevelSink sink(writer, pool, rate);
+    for (const char* input : inputs) {
+        if (!PackTextLevels(input, sink)) return 1;
+    }
+    if (generate > 0 && !PackGeneratedLevels(generate, candidates, seed, pool, sink)) return 1;
+    if (!sink.Flush()) {
+        fprintf(stderr, "%s: write failed\n", output);
+        return 1;
+    }
+
+    int count = writer.LevelCount();
+    if (!writer.Finish(sort)) {
+        fprintf(stderr, "%s: write failed\n", output);
+        return 1;
+    }
+    printf("%s: %d levels\n", output, count);
+    return 0;
+}
@@ -0,0 +1,237 @@
+// strokex_validate: checks every level of one or more level packs before
+// they ship, in parallel across all cores.
+//
+//   strokex_validate levels.sxpk                 summary plus the first problems
+//   strokex_validate --list 0 endless.sxpk       summary only
+//
+// A level fails if it can't be decoded, has no one-stroke solution (its
+// edges are in several pieces or more than two nodes have odd degree), or
+// breaks a geometry rule from level_checks.h. Duplicate edges and nodes
+// without edges are legal and only reported as warnings.
+
+#include "core/euler_solver.h"
+#include "core/graph_index.h"
+#include "core/level_checks.h"
+#include "core/level_pack.h"
+#include "core/thread_pool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using namespace std;
+
+static const int kIssueKinds = ISSUE_OVERLAPPING_EDGES + 1;
+// Levels per task: enough to amortise the task, few enough to balance
+static const int kGrain = 256;
+
+static void PrintUsage() {
+    printf("usage: strokex_validate [--threads N] [--radius PX] [--list N] PACK...\n");
+}
+
+struct LevelReport {
+    bool decoded;
+    SolveStatus status;
+    int nodes;
+    int edges;
+    int oddNodes;
+    int components;      // connected pieces among the nodes that have edges
+    int isolatedNodes;   // nodes no edge touches
+    int issues[kIssueKinds];
+    float solveMicros;
+
+    bool HasError() const {
+        if (!decoded || status != SOLVE_OK || components > 1) return true;
+        for (int kind = 0; kind < kIssueKinds; kind++) {
+            if (kind != ISSUE_DUPLICATE_EDGE && issues[kind] > 0) return true;
+        }
+        return false;
+    }
+    bool HasWarning() const { return issues[ISSUE_DUPLICATE_EDGE] > 0 || isolatedNodes > 0; }
+};
+
+// Scratch reused across the levels of one task
+struct Checker {
+    vector<Node> nodes;
+    vector<Edge> edges;
+    GraphIndex graph;
+    EulerSolver solver;
+    vector<LevelIssue> issues;
+    vector<int> component;
+    vector<int> stack;
+
+    void Check(const LevelPack& pack, int index, float radius, LevelReport& report) {
+        report = LevelReport();
+        report.decoded = pack.DecodeLevel(index, nodes, edges);
+        if (!report.decoded) return;
+        report.nodes = (int)nodes.size();
+        report.edges = (int)edges.size();
+
+        graph.Build(report.nodes, edges);
+        auto start = chrono::steady_clock::now();
+        report.status = solver.Validate(graph);
+        report.solveMicros = chrono::duration<float, micro>(chrono::steady_clock::now() - start).count();
+
+        for (int node = 0; node < report.nodes; node++) {
+            if (graph.Degree(node) % 2 == 1) report.oddNodes++;
+            if (graph.Degree(node) == 0) report.isolatedNodes++;
+        }
+        CountComponents(report);
+
+        issues.clear();
+        CheckLevelGeometry(nodes, edges, radius, issues);
+        for (const LevelIssue& issue : issues) report.issues[issue.kind]++;
+    }
+
+    void CountComponents(LevelReport& report) {
+        component.assign(report.nodes, -1);
+        for (int root = 0; root < report.nodes; root++) {
+            if (component[root] >= 0 || graph.Degree(root) == 0) continue;
+            component[root] = report.components;
+            stack.assign(1, root);
+            while (!stack.empty()) {
+                int node = stack.back();
+                stack.pop_back();
+                for (const HalfEdge* he = graph.NeighborsBegin(node); he != graph.NeighborsEnd(node); ++he) {
+                    if (component[he->node] >= 0) continue;
+                    component[he->node] = report.components;
+                    stack.push_back(he->node);
+                }
+            }
+            report.components++;
+        }
+    }
+};
+
+static void PrintLevel(int level, const LevelReport& report) {
+    printf("level %d:", level);
+    if (!report.decoded) {
+        printf(" corrupt record\n");
+        return;
+    }
+    printf(" %d nodes %d edges", report.nodes, report.edges);
+    if (report.status != SOLVE_OK) printf(", %s", SolveStatusName(report.status));
+    if (report.components > 1) printf(", in %d pieces", report.components);
+    if (report.oddNodes > 2) printf(", odd nodes x%d", report.oddNodes);
+    if (report.isolatedNodes > 0) printf(", lone nodes x%d", report.isolatedNodes);
+    for (int kind = 0; kind < kIssueKinds; kind++) {
+        if (report.issues[kind] > 0) printf(", %s x%d", LevelIssueName((LevelIssueKind)kind), report.issues[kind]);
+    }
+    printf("\n");
+}
+
+static bool ValidatePack(const char* path, ThreadPool& pool, int threads, float radius, int listLimit) {
+    LevelPack pack;
+    if (!pack.Open(path)) {
+        fprintf(stderr, "%s: not a readable level pack\n", path);
+        return false;
+    }
+    int levelCount = pack.LevelCount();
+    vector<LevelReport> reports(levelCount);
+
+    auto start = chrono::steady_clock::now();
+    pool.ParallelFor(levelCount, threads > 1 ? kGrain : levelCount, [&](int begin, int end) {
+        Checker checker;
+        for (int i = begin; i < end; i++) checker.Check(pack, i, radius, reports[i]);
+    });
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    int errors = 0;
+    int warnings = 0;
+    int listed = 0;
+    long long nodeTotal = 0;
+    long long edgeTotal = 0;
+    int oddCounts[3] = {};   // 0, 2, more
+    int issueLevels[kIssueKinds] = {};
+    vector<float> solveTimes;
+    solveTimes.reserve(levelCount);
+    for (int i = 0; i < levelCount; i++) {
+        const LevelReport& report = reports[i];
+        bool error = report.HasError();
+        bool warning = report.HasWarning();
+        errors += error ? 1 : 0;
+        warnings += warning && !error ? 1 : 0;
+        if ((error || warning) && listed < listLimit) {
+            PrintLevel(i + 1, report);
+            listed++;
+        }
+        if (!report.decoded) continue;
+        nodeTotal += report.nodes;
+        edgeTotal += report.edges;
+        oddCounts[report.oddNodes == 0 ? 0 : report.oddNodes <= 2 ? 1 : 2]++;
+        for (int kind = 0; kind < kIssueKinds; kind++) issueLevels[kind] += report.issues[kind] > 0 ? 1 : 0;
+        solveTimes.push_back(report.solveMicros);
+    }
+    if (listed < errors + warnings) printf("... %d more (--list N shows more)\n", errors + warnings - listed);
+
+    int corrupt = levelCount - (int)solveTimes.size();
+    int pieces = 0;
+    int isolated = 0;
+    for (const LevelReport& report : reports) {
+        pieces += report.components > 1 ? 1 : 0;
+        isolated += report.isolatedNodes > 0 ? 1 : 0;
+    }
+
+    printf("pack:              %s\n", path);
+    printf("levels:            %d (%lld nodes, %lld edges)\n", levelCount, nodeTotal, edgeTotal);
+    printf("threads:           %d\n", threads);
+    printf("scan time:         %.3f s (%.0f levels/s)\n", seconds, seconds > 0 ? levelCount / seconds : 0.0);
+    printf("failed:            %d levels\n", errors);
+    printf("warnings only:     %d levels\n", warnings);
+    if (corrupt > 0) printf("corrupt records:   %d\n", corrupt);
+    printf("in pieces:         %d levels\n", pieces);
+    printf("odd nodes:         %d with 0, %d with 2, %d with more\n", oddCounts[0], oddCounts[1], oddCounts[2]);
+    printf("lone nodes:        %d levels\n", isolated);
+    for (int kind = 0; kind < kIssueKinds; kind++) {
+        char label[32];
+        snprintf(label, sizeof(label), "%s:", LevelIssueName((LevelIssueKind)kind));
+        printf("%-18s %d levels%s\n", label, issueLevels[kind], kind == ISSUE_DUPLICATE_EDGE ? " (allowed)" : "");
+    }
+    if (!solveTimes.empty()) {
+        sort(solveTimes.begin(), solveTimes.end());
+        printf("solve time:        p50 %.2f us  p99 %.2f us  max %.2f us\n", solveTimes[solveTimes.size() / 2],
+               solveTimes[solveTimes.size() * 99 / 100], solveTimes.back());
+    }
+    return errors == 0;
+}
+
+int main(int argc, char** argv) {
+    int threads = 0;
+    float radius = 39.2f;
+    int listLimit = 20;
+    vector<const char*> packs;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--radius") == 0 && i + 1 < argc) {
+            radius = (float)atof(argv[++i]);
+        } else if (strcmp(argv[i], "--list") == 0 && i + 1 < argc) {
+            listLimit = atoi(argv[++i]);
+        } else if (argv[i][0] != '-') {
+            packs.push_back(argv[i]);
+        } else {
+            PrintUsage();
+            return 1;
+        }
+    }
+    if (packs.empty() || threads < 0 || radius <= 0.0f) {
+        PrintUsage();
+        return 1;
+    }
+
+    // The calling thread works through the levels too; with --threads 1
+    // it does all of them and the pool's worker stays asleep
+    ThreadPool pool(threads > 1 ? threads - 1 : threads);
+    if (threads == 0) threads = pool.WorkerCount() + 1;
+
+    bool ok = true;
+    for (size_t i = 0; i < packs.size(); i++) {
+        if (i > 0) printf("\n");
+        ok = ValidatePack(packs[i], pool, threads, radius, listLimit) && ok;
+    }
+    return ok ? 0 : 1;
+}